@@ -3,10 +3,12 @@ TEMPLATE = subdirs
 SUBDIRS += \
     lib \
     test \
+    bench \
     xmoc
 
 lib.depends = xmoc
 test.depends = lib
+bench.depends = lib
 
 OTHER_FILES = \
     .gitignore
@@ -23,4 +25,11 @@ DISTFILES += \
     README-QSignalSlotMonitor.md \
     README-QUniversalSlot.md \
     README-QSignalDumper.md \
-    README-QSignalLogger.md
+    README-QSignalLogger.md \
+    README-QSlotProfiler.md \
+    README-QSignalCascadeTracer.md \
+    README-QSignalTraceExporter.md \
+    README-QSignalCounter.md \
+    README-QValueSerializer.md \
+    README-QSignalCaptureReader.md \
+    README-QSignalQueueMonitor.md
@@ -0,0 +1,95 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QAllocationCounter.h"
+
+#include <QAtomicInteger>
+
+#include <cstdlib>
+#include <new>
+
+static QAtomicInteger<quint64> allocationCount;
+
+static inline void countAllocation() {
+    allocationCount.fetchAndAddRelaxed(1);
+}
+
+#if defined(__GLIBC__)
+
+// Interpose the C allocator, which is also used by operator new and by Qt's
+// containers, forwarding to glibc's implementation.
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+
+void* malloc(size_t size) {
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) {
+    countAllocation();
+    return __libc_realloc(pointer, size);
+}
+
+}
+
+#else
+
+void* operator new(std::size_t size) {
+    countAllocation();
+    void* const pointer = std::malloc(size ? size : 1);
+    if(! pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+#endif
+
+QAllocationCounter::QAllocationCounter()
+    : _start(getTotalCount()) {
+}
+
+quint64 QAllocationCounter::getCount() const {
+    return getTotalCount() - _start;
+}
+
+quint64 QAllocationCounter::getTotalCount() {
+    return allocationCount.loadAcquire();
+}
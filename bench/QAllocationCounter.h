@@ -0,0 +1,57 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+#ifndef QALLOCATIONCOUNTER_H
+#define QALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Counts the heap allocations made, by any thread, since construction.
+ * @note With glibc, malloc(), calloc() and realloc() are counted, which also
+ *       covers operator new and Qt's containers. With other C libraries only
+ *       operator new is counted.
+ */
+class QAllocationCounter {
+
+public:
+
+    /**
+     * @brief Constructor.
+     */
+    QAllocationCounter();
+
+    /**
+     * @brief Returns the number of allocations made since construction.
+     * @return
+     */
+    quint64 getCount() const;
+
+    /**
+     * @brief Returns the number of allocations made since the program started.
+     * @return
+     */
+    static quint64 getTotalCount();
+
+private:
+
+    const quint64 _start;
+
+};
+
+#endif // QALLOCATIONCOUNTER_H
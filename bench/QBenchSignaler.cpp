@@ -0,0 +1,37 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QBenchSignaler.h"
+
+QBenchSignaler::QBenchSignaler(QObject* parent)
+    : QObject(parent) {
+    setObjectName(QStringLiteral("benchSignaler"));
+}
+
+void QBenchSignaler::slot_0A() {
+}
+
+void QBenchSignaler::slot_1A(int p1) {
+    Q_UNUSED(p1);
+}
+
+void QBenchSignaler::slot_2A(int p1, const QString& p2) {
+    Q_UNUSED(p1);
+    Q_UNUSED(p2);
+}
@@ -0,0 +1,46 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+#ifndef QBENCHSIGNALER_H
+#define QBENCHSIGNALER_H
+
+#include <QObject>
+#include <QString>
+
+class QBenchSignaler : public QObject {
+    Q_OBJECT
+
+public:
+
+    QBenchSignaler(QObject* parent = nullptr);
+
+public slots:
+
+    void slot_0A();
+    void slot_1A(int p1);
+    void slot_2A(int p1, const QString& p2);
+
+signals:
+
+    void signal_0A();
+    void signal_1A(int p1);
+    void signal_2A(int p1, const QString& p2);
+
+};
+
+#endif // QBENCHSIGNALER_H
@@ -0,0 +1,40 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QDebugUtilsBench.h"
+
+QDebugUtilsBench::QDebugUtilsBench()
+    : QObject() {
+}
+
+int QDebugUtilsBench::getIterations() {
+    bool ok = false;
+    const int iterations = qEnvironmentVariableIntValue("QTDEBUGUTILS_BENCH_ITERATIONS", &ok);
+    return ok && iterations > 0 ? iterations : 100000;
+}
+
+void QDebugUtilsBench::report(qint64 nanoseconds, quint64 allocations, int iterations) {
+    const double nanosecondsPerCall = static_cast<double>(nanoseconds) / iterations;
+    const double allocationsPerCall = static_cast<double>(allocations) / iterations;
+    QTest::setBenchmarkResult(nanosecondsPerCall, QTest::WalltimeNanoseconds);
+    const char* const dataTag = QTest::currentDataTag();
+    qInfo("%s(%s): %.1f ns/emit, %.2f allocations/emit"
+          , QTest::currentTestFunction(), dataTag ? dataTag : ""
+          , nanosecondsPerCall, allocationsPerCall);
+}
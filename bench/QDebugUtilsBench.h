@@ -0,0 +1,94 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+#ifndef QDEBUGUTILSBENCH_H
+#define QDEBUGUTILSBENCH_H
+
+#include "QAllocationCounter.h"
+
+#include <QObject>
+#include <QtTest>
+#include <QElapsedTimer>
+
+class QDebugUtilsBench : public QObject {
+    Q_OBJECT
+
+public:
+
+    QDebugUtilsBench();
+
+    /**
+     * @brief Calls the given function the configured number of times, after
+     *        a warm up, and reports the average time and heap allocations per
+     *        call.
+     * @note The number of calls is 100000 by default and can be changed with
+     *       the QTDEBUGUTILS_BENCH_ITERATIONS environment variable.
+     */
+    template<typename FUNCTION>
+    static void measure(FUNCTION function);
+
+private slots:
+
+    void benchQSignalSlotMonitor();
+    void benchQSignalSlotMonitor_data();
+
+    void benchQSignalCounter();
+    void benchQSignalCounter_data();
+
+    void benchQUniversalSlot();
+    void benchQUniversalSlot_data();
+
+    void benchQSignalLogger();
+    void benchQSignalLogger_data();
+
+    void benchQSignalDumper();
+    void benchQSignalDumper_data();
+
+    void benchQValueStringifier();
+    void benchQValueStringifier_data();
+
+    void benchQObjectStringifier();
+
+    void benchQMethodStringifier();
+    void benchQMethodStringifier_data();
+
+private:
+
+    static int getIterations();
+
+    static void report(qint64 nanoseconds, quint64 allocations, int iterations);
+
+};
+
+template<typename FUNCTION>
+void QDebugUtilsBench::measure(FUNCTION function) {
+    const int iterations = getIterations();
+    for(int I = 0; I < iterations / 10; ++I) {
+        function();
+    }
+    const QAllocationCounter allocationCounter;
+    QElapsedTimer timer;
+    timer.start();
+    for(int I = 0; I < iterations; ++I) {
+        function();
+    }
+    const qint64 nanoseconds = timer.nsecsElapsed();
+    report(nanoseconds, allocationCounter.getCount(), iterations);
+}
+
+#endif // QDEBUGUTILSBENCH_H
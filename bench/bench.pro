@@ -0,0 +1,48 @@
+QT       += testlib
+QT       -= gui
+
+TARGET    = bench
+CONFIG   += warn_on console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+DEFINES += QT_DEPRECATED_WARNINGS
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+DEFINES  += QT_NO_CAST_FROM_ASCII
+DEFINES  += QT_NO_CAST_TO_ASCII
+
+INCLUDEPATH += \
+    ../lib/QSignalSlotMonitor \
+    ../lib/QUniversalSlot \
+    ../lib/QValueStringifier \
+    ../lib/QObjectStringifier \
+    ../lib/QMethodStringifier \
+    ../lib/QSignalDumper \
+    ../lib/QSignalLogger \
+    ../lib/QAddressWiper \
+    ../lib/QSignalCounter
+
+HEADERS += \
+    QDebugUtilsBench.h \
+    QAllocationCounter.h \
+    QBenchSignaler.h
+
+SOURCES += \
+    main.cpp \
+    QDebugUtilsBench.cpp \
+    QAllocationCounter.cpp \
+    QBenchSignaler.cpp \
+    benchQSignalSlotMonitor.cpp \
+    benchQUniversalSlot.cpp \
+    benchQSignalLogger.cpp \
+    benchQSignalDumper.cpp \
+    benchQValueStringifier.cpp \
+    benchQObjectStringifier.cpp \
+    benchQMethodStringifier.cpp \
+    benchQSignalCounter.cpp
+
+win32: SONAME=dll
+else:  SONAME=so
+
+LIBS += $${OUT_PWD}/../lib/libQtDebugUtils.$${SONAME}.1
@@ -0,0 +1,53 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QDebugUtilsBench.h"
+#include "QBenchSignaler.h"
+#include "QMethodStringifier.h"
+
+void QDebugUtilsBench::benchQMethodStringifier() {
+    QFETCH(bool, appendToBuffer);
+
+    QBenchSignaler signaler;
+    const QMetaMethod metaMethod = QMetaMethod::fromSignal(&QBenchSignaler::signal_2A);
+    const QVector<QVariant> parameters = QVector<QVariant>()
+            << QVariant(123) << QVariant(QStringLiteral("abc"));
+
+    QMethodStringifier methodStringifier;
+    QString buffer;
+    if(appendToBuffer) {
+        measure([&]() {
+            buffer.truncate(0);
+            methodStringifier.stringify(&signaler, signaler.objectName()
+                                        , signaler.metaObject(), metaMethod
+                                        , parameters, buffer);
+        });
+    } else {
+        measure([&]() {
+            buffer = methodStringifier.stringify(&signaler, metaMethod, parameters);
+        });
+    }
+}
+
+void QDebugUtilsBench::benchQMethodStringifier_data() {
+    QTest::addColumn<bool>("appendToBuffer");
+
+    QTest::newRow("returned string") << false;
+    QTest::newRow("append to buffer") << true;
+}
@@ -0,0 +1,116 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QDebugUtilsBench.h"
+#include "QBenchSignaler.h"
+#include "QSignalDumper.h"
+
+/**
+ * @brief Write only device that discards everything written to it.
+ */
+class QBenchNullDevice : public QIODevice {
+
+protected:
+
+    virtual qint64 readData(char* data, qint64 maxSize) override {
+        Q_UNUSED(data);
+        Q_UNUSED(maxSize);
+        return -1;
+    }
+
+    virtual qint64 writeData(const char* data, qint64 maxSize) override {
+        Q_UNUSED(data);
+        return maxSize;
+    }
+
+};
+
+static QtMessageHandler previousMessageHandler = nullptr;
+
+static void discardDebugMessages(QtMsgType type, const QMessageLogContext& context
+                                 , const QString& message) {
+    if(type != QtDebugMsg) {
+        previousMessageHandler(type, context, message);
+    }
+}
+
+void QDebugUtilsBench::benchQSignalDumper() {
+    QFETCH(int, target);
+    QFETCH(bool, parameters);
+    QFETCH(bool, async);
+
+    QBenchSignaler signaler;
+    QBenchNullDevice device;
+    device.open(QIODevice::WriteOnly);
+    QByteArray byteArray;
+
+    QSignalDumper dumper;
+    dumper.disable(QSignalDumper::Flag::TargetQDebug);
+    dumper.setTargetQIODevice(&device);
+    dumper.setTargetQByteArray(&byteArray);
+    dumper.enable(static_cast<QSignalDumper::Flag>(target));
+    if(parameters) {
+        dumper.enable(QSignalDumper::Flag::Parameters);
+    } else {
+        dumper.disable(QSignalDumper::Flag::Parameters);
+    }
+    if(async) {
+        dumper.enable(QSignalDumper::Flag::Async);
+    }
+    dumper.connect(&signaler, &QBenchSignaler::signal_2A);
+
+    previousMessageHandler = qInstallMessageHandler(&discardDebugMessages);
+    const QString text = QStringLiteral("abc");
+    measure([&]() {
+        emit signaler.signal_2A(123, text);
+    });
+    dumper.flush();
+    qInstallMessageHandler(previousMessageHandler);
+}
+
+void QDebugUtilsBench::benchQSignalDumper_data() {
+    QTest::addColumn<int>("target");
+    QTest::addColumn<bool>("parameters");
+    QTest::addColumn<bool>("async");
+
+    QTest::newRow("QIODevice")
+            << static_cast<int>(QSignalDumper::Flag::TargetQIODevice)
+            << true
+            << false;
+
+    QTest::newRow("QIODevice without parameters")
+            << static_cast<int>(QSignalDumper::Flag::TargetQIODevice)
+            << false
+            << false;
+
+    QTest::newRow("QIODevice async")
+            << static_cast<int>(QSignalDumper::Flag::TargetQIODevice)
+            << true
+            << true;
+
+    QTest::newRow("QByteArray")
+            << static_cast<int>(QSignalDumper::Flag::TargetQByteArray)
+            << true
+            << false;
+
+    QTest::newRow("QDebug")
+            << static_cast<int>(QSignalDumper::Flag::TargetQDebug)
+            << true
+            << false;
+}
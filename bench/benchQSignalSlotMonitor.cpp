@@ -0,0 +1,48 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QDebugUtilsBench.h"
+#include "QBenchSignaler.h"
+#include "QSignalSlotMonitor.h"
+
+void QDebugUtilsBench::benchQSignalSlotMonitor() {
+    QFETCH(int, monitorCount);
+
+    QBenchSignaler signaler;
+    QObject::connect(&signaler, &QBenchSignaler::signal_2A
+                     , &signaler, &QBenchSignaler::slot_2A);
+
+    QObject monitorsParent;
+    for(int I = 0; I < monitorCount; ++I) {
+        (new QSignalSlotMonitor(&monitorsParent))->enableMonitor();
+    }
+
+    const QString text = QStringLiteral("abc");
+    measure([&]() {
+        emit signaler.signal_2A(123, text);
+    });
+}
+
+void QDebugUtilsBench::benchQSignalSlotMonitor_data() {
+    QTest::addColumn<int>("monitorCount");
+
+    QTest::newRow("no monitor") << 0;
+    QTest::newRow("1 monitor") << 1;
+    QTest::newRow("8 monitors") << 8;
+}
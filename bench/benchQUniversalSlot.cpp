@@ -0,0 +1,60 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QDebugUtilsBench.h"
+#include "QBenchSignaler.h"
+#include "QUniversalSlot.h"
+
+class QBenchUniversalSlot : public QUniversalSlot {
+
+public:
+
+    virtual void universal(QObject* signaler
+                           , const QMetaMethod& signalMetaMethod
+                           , const QVector<QVariant>& parameters) override {
+        Q_UNUSED(signaler);
+        Q_UNUSED(signalMetaMethod);
+        Q_UNUSED(parameters);
+    }
+
+};
+
+void QDebugUtilsBench::benchQUniversalSlot() {
+    QFETCH(bool, connectEverything);
+
+    QBenchSignaler signaler;
+    QBenchUniversalSlot universalSlot;
+    if(connectEverything) {
+        universalSlot.connectEverything();
+    } else {
+        universalSlot.connect(&signaler, &QBenchSignaler::signal_2A);
+    }
+
+    const QString text = QStringLiteral("abc");
+    measure([&]() {
+        emit signaler.signal_2A(123, text);
+    });
+}
+
+void QDebugUtilsBench::benchQUniversalSlot_data() {
+    QTest::addColumn<bool>("connectEverything");
+
+    QTest::newRow("connect") << false;
+    QTest::newRow("connectEverything") << true;
+}
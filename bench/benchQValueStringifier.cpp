@@ -0,0 +1,56 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QDebugUtilsBench.h"
+#include "QValueStringifier.h"
+
+#include <QDateTime>
+#include <QPoint>
+
+void QDebugUtilsBench::benchQValueStringifier() {
+    QFETCH(QVariant, value);
+    QFETCH(bool, withType);
+
+    QString buffer;
+    measure([&]() {
+        buffer.truncate(0);
+        QValueStringifier::stringify(value, buffer, withType);
+    });
+}
+
+void QDebugUtilsBench::benchQValueStringifier_data() {
+    QTest::addColumn<QVariant>("value");
+    QTest::addColumn<bool>("withType");
+
+    QTest::newRow("int") << QVariant(-123) << false;
+    QTest::newRow("int with type") << QVariant(-123) << true;
+    QTest::newRow("double") << QVariant(1.25) << false;
+    QTest::newRow("double (17 digits)") << QVariant(0.1 + 0.2) << false;
+    QTest::newRow("qulonglong")
+            << QVariant::fromValue<qulonglong>(18446744073709551615ULL) << false;
+    QTest::newRow("QString") << QVariant(QStringLiteral("abc")) << false;
+    QTest::newRow("QByteArray") << QVariant(QByteArrayLiteral("abc")) << false;
+    QTest::newRow("QPoint") << QVariant(QPoint(1, 2)) << false;
+    QTest::newRow("QDateTime")
+            << QVariant(QDateTime(QDate(2017, 10, 30), QTime(12, 34, 56)))
+            << false;
+    QTest::newRow("void*")
+            << QVariant::fromValue<void*>(reinterpret_cast<void*>(0x1234))
+            << false;
+}
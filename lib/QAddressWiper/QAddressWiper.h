@@ -21,6 +21,14 @@
 
 #include <QString>
 #include <QByteArray>
+#include <QtAlgorithms>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 template<typename CONTAINER, typename ITEM, typename LITERAL>
 class QAddressWiper {
@@ -60,13 +68,28 @@ public:
      * @brief Wipes any memory address look-alike in the given container.
      * @param container
      * @return Returns the given container with the addresses wiped.
+     * @note The "0x" candidates are found in bulk and the hexadecimal digits
+     *       are validated with wide compares, using AVX2 or SSE2 if enabled
+     *       at compile time. The result is the same as calling isAddress() at
+     *       every index, including that the character right after a wiped
+     *       address is never the start of another address.
      */
     static container_t& wipe(container_t& container) {
         const index_t maxIndex = container.size() - pointer_size + 1;
-        for(index_t index = 0 ; index < maxIndex ; ++index) {
-            if(isAddress(container, index)) {
-                wipeAddress(container, index);
-                index += pointer_size;
+        auto data = units(container.constData());
+        decltype(units(container.data())) writableData = nullptr;
+        index_t index = 0;
+        while((index = findCandidate(data, index, maxIndex)) < maxIndex) {
+            if(isHexRun(data + index + 2)) {
+                if(! writableData) {
+                    // Only detach the container when there is something to wipe.
+                    writableData = units(container.data());
+                    data = writableData;
+                }
+                wipeAddress(writableData, index);
+                index += pointer_size + 1;
+            } else {
+                ++index;
             }
         }
         return container;
@@ -106,19 +129,202 @@ private:
         return LITERAL('f');
     }
 
+    static const int hexa_digits = sizeof(void*) * 2;
+
+    static inline const uchar* units(const char* data) {
+        return reinterpret_cast<const uchar*>(data);
+    }
+
+    static inline uchar* units(char* data) {
+        return reinterpret_cast<uchar*>(data);
+    }
+
+    static inline const ushort* units(const QChar* data) {
+        return reinterpret_cast<const ushort*>(data);
+    }
+
+    static inline ushort* units(QChar* data) {
+        return reinterpret_cast<ushort*>(data);
+    }
+
+    static inline bool isHexaUnit(uint unit) {
+        return (unit >= '0' && unit <= '9') || (unit >= 'a' && unit <= 'f');
+    }
+
+#if defined(__SSE2__)
+    static inline __m128i isHexaUnits8(__m128i units8) {
+        const __m128i digit = _mm_and_si128(
+                    _mm_cmpgt_epi8(units8, _mm_set1_epi8('0' - 1))
+                    , _mm_cmplt_epi8(units8, _mm_set1_epi8('9' + 1)));
+        const __m128i letter = _mm_and_si128(
+                    _mm_cmpgt_epi8(units8, _mm_set1_epi8('a' - 1))
+                    , _mm_cmplt_epi8(units8, _mm_set1_epi8('f' + 1)));
+        return _mm_or_si128(digit, letter);
+    }
+
+    static inline __m128i isHexaUnits16(__m128i units16) {
+        const __m128i digit = _mm_and_si128(
+                    _mm_cmpgt_epi16(units16, _mm_set1_epi16('0' - 1))
+                    , _mm_cmplt_epi16(units16, _mm_set1_epi16('9' + 1)));
+        const __m128i letter = _mm_and_si128(
+                    _mm_cmpgt_epi16(units16, _mm_set1_epi16('a' - 1))
+                    , _mm_cmplt_epi16(units16, _mm_set1_epi16('f' + 1)));
+        return _mm_or_si128(digit, letter);
+    }
+#endif
+
+    /**
+     * @brief Returns the first index, from the given index and lower than the
+     *        given max index, where "0x" starts, or the max index if none.
+     */
+    static index_t findCandidate(const uchar* data, index_t index, index_t maxIndex) {
+#if defined(__AVX2__)
+        const __m256i c0s256 = _mm256_set1_epi8('0');
+        const __m256i cxs256 = _mm256_set1_epi8('x');
+        for( ; index + 32 < maxIndex ; index += 32) {
+            const __m256i first = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i*>(data + index));
+            const __m256i second = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i*>(data + index + 1));
+            const uint mask = static_cast<uint>(_mm256_movemask_epi8(
+                        _mm256_and_si256(_mm256_cmpeq_epi8(first, c0s256)
+                                         , _mm256_cmpeq_epi8(second, cxs256))));
+            if(mask) {
+                return index + static_cast<index_t>(qCountTrailingZeroBits(mask));
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        const __m128i c0s128 = _mm_set1_epi8('0');
+        const __m128i cxs128 = _mm_set1_epi8('x');
+        for( ; index + 16 < maxIndex ; index += 16) {
+            const __m128i first = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(data + index));
+            const __m128i second = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(data + index + 1));
+            const uint mask = static_cast<uint>(_mm_movemask_epi8(
+                        _mm_and_si128(_mm_cmpeq_epi8(first, c0s128)
+                                      , _mm_cmpeq_epi8(second, cxs128))));
+            if(mask) {
+                return index + static_cast<index_t>(qCountTrailingZeroBits(mask));
+            }
+        }
+#endif
+        for( ; index < maxIndex ; ++index) {
+            if(data[index] == '0' && data[index + 1] == 'x') {
+                return index;
+            }
+        }
+        return maxIndex;
+    }
+
     /**
-     * @brief Wipes the address at the given index of the given container.
-     * @param container Container with the address to be wiped.
+     * @brief Returns the first index, from the given index and lower than the
+     *        given max index, where "0x" starts, or the max index if none.
+     */
+    static index_t findCandidate(const ushort* data, index_t index, index_t maxIndex) {
+#if defined(__AVX2__)
+        const __m256i c0s256 = _mm256_set1_epi16('0');
+        const __m256i cxs256 = _mm256_set1_epi16('x');
+        for( ; index + 16 < maxIndex ; index += 16) {
+            const __m256i first = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i*>(data + index));
+            const __m256i second = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i*>(data + index + 1));
+            const uint mask = static_cast<uint>(_mm256_movemask_epi8(
+                        _mm256_and_si256(_mm256_cmpeq_epi16(first, c0s256)
+                                         , _mm256_cmpeq_epi16(second, cxs256))));
+            if(mask) {
+                return index + static_cast<index_t>(qCountTrailingZeroBits(mask) / 2);
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        const __m128i c0s128 = _mm_set1_epi16('0');
+        const __m128i cxs128 = _mm_set1_epi16('x');
+        for( ; index + 8 < maxIndex ; index += 8) {
+            const __m128i first = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(data + index));
+            const __m128i second = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(data + index + 1));
+            const uint mask = static_cast<uint>(_mm_movemask_epi8(
+                        _mm_and_si128(_mm_cmpeq_epi16(first, c0s128)
+                                      , _mm_cmpeq_epi16(second, cxs128))));
+            if(mask) {
+                return index + static_cast<index_t>(qCountTrailingZeroBits(mask) / 2);
+            }
+        }
+#endif
+        for( ; index < maxIndex ; ++index) {
+            if(data[index] == '0' && data[index + 1] == 'x') {
+                return index;
+            }
+        }
+        return maxIndex;
+    }
+
+    /**
+     * @brief Returns true if the hexa_digits units at the given pointer are
+     *        all hexadecimal digits.
+     */
+    static bool isHexRun(const uchar* data) {
+#if defined(__SSE2__)
+        if(hexa_digits == 16) {
+            const __m128i units8 = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(data));
+            return _mm_movemask_epi8(isHexaUnits8(units8)) == 0xffff;
+        }
+        if(hexa_digits == 8) {
+            const __m128i units8 = _mm_loadl_epi64(
+                        reinterpret_cast<const __m128i*>(data));
+            return (_mm_movemask_epi8(isHexaUnits8(units8)) & 0xff) == 0xff;
+        }
+#endif
+        for(int I = 0 ; I < hexa_digits ; ++I) {
+            if(! isHexaUnit(data[I])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Returns true if the hexa_digits units at the given pointer are
+     *        all hexadecimal digits.
+     */
+    static bool isHexRun(const ushort* data) {
+#if defined(__SSE2__)
+        if(hexa_digits % 8 == 0) {
+            for(int I = 0 ; I < hexa_digits ; I += 8) {
+                const __m128i units16 = _mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(data + I));
+                if(_mm_movemask_epi8(isHexaUnits16(units16)) != 0xffff) {
+                    return false;
+                }
+            }
+            return true;
+        }
+#endif
+        for(int I = 0 ; I < hexa_digits ; ++I) {
+            if(! isHexaUnit(data[I])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Wipes the address at the given index of the given data.
+     * @param data Data with the address to be wiped.
      * @param index Index where the address starts.
-     * @return Returns the given container.
      */
-    static container_t& wipeAddress(container_t& container, index_t index) {
+    template<typename UNIT>
+    static void wipeAddress(UNIT* data, index_t index) {
         index += 2;
-        const index_t maxIndex = index + sizeof(void*) * 2;
+        const index_t maxIndex = index + hexa_digits;
         while(index < maxIndex) {
-            container[index++] = cf();
+            data[index++] = 'f';
         }
-        return container;
     }
 
 };
@@ -25,8 +25,90 @@
     return (RETURN); \
     }
 
+static inline void appendAscii(QString& buffer, char c) {
+    buffer.append(QLatin1Char(c));
+}
+
+static inline void appendAscii(QByteArray& buffer, char c) {
+    buffer.append(c);
+}
+
+/**
+ * @brief A constant part of the string representation, in UTF-16 and UTF-8.
+ */
+struct QMethodStringifierText {
+
+    QString string;
+    QByteArray utf8;
+
+    /** @brief Renders the UTF-8 version, once the string is complete. */
+    inline void finish() {
+        utf8 = string.toUtf8();
+    }
+
+    /** @brief Appends the text without the last chopCount characters, that must be ASCII. */
+    inline void appendTo(QString& buffer, int chopCount = 0) const {
+        buffer.append(string.constData(), string.size() - chopCount);
+    }
+
+    inline void appendTo(QByteArray& buffer, int chopCount = 0) const {
+        buffer.append(utf8.constData(), utf8.size() - chopCount);
+    }
+
+};
+
+/**
+ * @brief The constant parts of the string representation of a method call,
+ *        rendered once per class and method.
+ */
+struct QMethodStringifier::MethodTemplate {
+
+    struct Parameter {
+        /** @brief "TYPE NAME=", preceded by ", " if not the first parameter. */
+        QMethodStringifierText declaration;
+        int typeId;
+        bool isVariant;
+    };
+
+    MethodTemplate(const QMetaObject* metaObject, const QMetaMethod& metaMethod)
+        : metaMethod(metaMethod) {
+        prefix.string.append(QLatin1String(metaObject->className()));
+        prefix.string.append(QLatin1Literal("*("));
+        prefix.finish();
+        infix.string.append(QLatin1Literal(")->"));
+        infix.string.append(QLatin1String(metaMethod.name()));
+        infix.string.append(QLatin1Char('('));
+        infix.finish();
+        const QList<QByteArray> parameterTypes = metaMethod.parameterTypes();
+        const QList<QByteArray> parameterNames = metaMethod.parameterNames();
+        parameters.reserve(parameterTypes.count());
+        for(int I = 0; I < parameterTypes.count(); ++I) {
+            Parameter parameter;
+            QString& declaration = parameter.declaration.string;
+            if(I > 0) declaration.append(QLatin1Literal(", "));
+            declaration.append(QLatin1String(parameterTypes.at(I)));
+            declaration.append(QLatin1Char(' '));
+            declaration.append(QLatin1String(parameterNames.at(I)));
+            declaration.append(QLatin1Char('='));
+            parameter.declaration.finish();
+            parameter.typeId = metaMethod.parameterType(I);
+            parameter.isVariant = parameter.typeId == QMetaType::QVariant;
+            parameters.append(parameter);
+        }
+    }
+
+    const QMetaMethod metaMethod;
+    /** @brief "CLASS*(" */
+    QMethodStringifierText prefix;
+    /** @brief ")->METHOD_NAME(" */
+    QMethodStringifierText infix;
+    QVector<Parameter> parameters;
+
+};
+
 QMethodStringifier::QMethodStringifier()
-    : _buffer() {
+    : _buffer()
+    , _methodTemplates() {
     _buffer.reserve(4096);
 }
 
@@ -50,41 +132,87 @@ QString QMethodStringifier::stringify(const void* objectAddress
                                       , const QMetaObject* metaObject
                                       , const QMetaMethod& metaMethod
                                       , const QVector<QVariant>& parameters) {
-    GUARD(metaObject, QString(), "metaObject pointer must be non null.");
-    GUARD(metaMethod.isValid(), QString(), "metamethod must be valid.");
-    const QList<QByteArray> parameterTypes = metaMethod.parameterTypes();
-    const QList<QByteArray> parameterNames = metaMethod.parameterNames();
-    GUARD(parameters.count() >= parameterTypes.count() || parameters.count() == 0
-          , QString(), "parameters count must be zero or be equal or greater"
-                       " to the method's parameter count.");
-    _buffer.append(QLatin1String(metaObject->className()));
-    _buffer.append(QLatin1Literal("*("));
-    QValueStringifier::stringify(QVariant::fromValue<void*>(
-                                     const_cast<void*>(objectAddress)), _buffer);
-    if(! objectName.isEmpty()) {
-        _buffer.append(QLatin1Char(';'));
-        QValueStringifier::stringify(objectName, _buffer);
-    }
-    _buffer.append(QLatin1Literal(")->"));
-    _buffer.append(QLatin1String(metaMethod.name()));
-    _buffer.append(QLatin1Char('('));
-    for(int I = 0; I < parameterTypes.count(); ++I) {
-        if(I > 0) _buffer.append(QLatin1Literal(", "));
-        _buffer.append(QLatin1String(parameterTypes.at(I)));
-        _buffer.append(QLatin1Char(' '));
-        _buffer.append(QLatin1String(parameterNames.at(I)));
-        if(parameters.count() > 0) {
-            const bool isVariant = metaMethod.parameterType(I) == QMetaType::QVariant;
-            GUARD(isVariant
-                  || metaMethod.parameterType(I) == static_cast<int>(parameters.at(I).type())
-                  , QString(), "parameters types must match the method's parameters types.");
-            _buffer.append(QLatin1Char('='));
-            QValueStringifier::stringify(parameters.at(I), _buffer, isVariant);
-        }
+    if(! stringify(objectAddress, objectName, metaObject, metaMethod
+                   , parameters, _buffer)) {
+        return QString();
     }
-    _buffer.append(QLatin1Char(')'));
     QString result(_buffer);
     result.detach();
     _buffer.truncate(0);
     return result;
 }
+
+template <typename BUFFER>
+bool QMethodStringifier::stringifyTo(const void* objectAddress
+                                     , const QString& objectName
+                                     , const QMetaObject* metaObject
+                                     , const QMetaMethod& metaMethod
+                                     , const QVector<QVariant>& parameters
+                                     , BUFFER& buffer) {
+    GUARD(metaObject, false, "metaObject pointer must be non null.");
+    GUARD(metaMethod.isValid(), false, "metamethod must be valid.");
+    const MethodTemplate& methodTemplate = getMethodTemplate(metaObject, metaMethod);
+    const int parameterCount = methodTemplate.parameters.count();
+    GUARD(parameters.count() >= parameterCount || parameters.count() == 0
+          , false, "parameters count must be zero or be equal or greater"
+                   " to the method's parameter count.");
+    const int initialSize = buffer.size();
+    methodTemplate.prefix.appendTo(buffer);
+    const void* const address = objectAddress;
+    QValueStringifier::stringify(QMetaType::VoidStar, &address, buffer);
+    if(! objectName.isEmpty()) {
+        appendAscii(buffer, ';');
+        QValueStringifier::stringify(QMetaType::QString, &objectName, buffer);
+    }
+    methodTemplate.infix.appendTo(buffer);
+    for(int I = 0; I < parameterCount; ++I) {
+        const MethodTemplate::Parameter& parameter = methodTemplate.parameters.at(I);
+        if(parameters.count() > 0) {
+            const bool typeMatches = parameter.isVariant
+                    || parameter.typeId == static_cast<int>(parameters.at(I).type());
+            if(! typeMatches) {
+                buffer.truncate(initialSize);
+            }
+            GUARD(typeMatches, false
+                  , "parameters types must match the method's parameters types.");
+            parameter.declaration.appendTo(buffer);
+            QValueStringifier::stringify(parameters.at(I), buffer, parameter.isVariant);
+        } else {
+            // Without the '='.
+            parameter.declaration.appendTo(buffer, 1);
+        }
+    }
+    appendAscii(buffer, ')');
+    return true;
+}
+
+bool QMethodStringifier::stringify(const void* objectAddress
+                                   , const QString& objectName
+                                   , const QMetaObject* metaObject
+                                   , const QMetaMethod& metaMethod
+                                   , const QVector<QVariant>& parameters
+                                   , QString& buffer) {
+    return stringifyTo(objectAddress, objectName, metaObject, metaMethod
+                       , parameters, buffer);
+}
+
+bool QMethodStringifier::stringify(const void* objectAddress
+                                   , const QString& objectName
+                                   , const QMetaObject* metaObject
+                                   , const QMetaMethod& metaMethod
+                                   , const QVector<QVariant>& parameters
+                                   , QByteArray& buffer) {
+    return stringifyTo(objectAddress, objectName, metaObject, metaMethod
+                       , parameters, buffer);
+}
+
+const QMethodStringifier::MethodTemplate& QMethodStringifier::getMethodTemplate(
+        const QMetaObject* metaObject, const QMetaMethod& metaMethod) {
+    const MethodKey key(metaObject, metaMethod.methodIndex());
+    auto iter = _methodTemplates.find(key);
+    if(iter == _methodTemplates.end() || iter.value()->metaMethod != metaMethod) {
+        iter = _methodTemplates.insert(key, QSharedPointer<const MethodTemplate>(
+                                           new MethodTemplate(metaObject, metaMethod)));
+    }
+    return *iter.value();
+}
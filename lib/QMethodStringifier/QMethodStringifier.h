@@ -21,6 +21,9 @@
 
 #include <QVector>
 #include <QVariant>
+#include <QHash>
+#include <QPair>
+#include <QSharedPointer>
 #include <QMetaObject>
 #include <QMetaMethod>
 
@@ -104,9 +107,58 @@ public:
                       , const QMetaObject* metaObject, const QMetaMethod& metaMethod
                       , const QVector<QVariant>& parameters = QVector<QVariant>());
 
+    /**
+     * @brief Appends a string representation of a method call to the given
+     *        buffer.
+     * @param objectAddess The object address. Can be null or no longer valid.
+     * @param objectName The object name.
+     * @param metaObject The meta object pointer. Must be non null.
+     * @param metaMethod The meta method. Must be a valid method method.
+     * @param parameters If the given parameters are empty, no parameter data
+     *                   will be included in the string.
+     *                   If the given parameters are not empty, the count and
+     *                   types of the parameters must be equal or greater to the
+     *                   method's parameter count.
+     * @param buffer Buffer where the string will be appended with any data
+     *               already in the buffer being left unchanged.
+     * @return True if the string was appended. False if the object, method or
+     *         parameters are invalid, in which case the buffer is left
+     *         unchanged.
+     * @note Avoids the copy of the string made by the other stringify()
+     *       methods.
+     */
+    bool stringify(const void* objectAddress, const QString& objectName
+                   , const QMetaObject* metaObject, const QMetaMethod& metaMethod
+                   , const QVector<QVariant>& parameters, QString& buffer);
+
+    /**
+     * @brief Appends a string representation of a method call, encoded in
+     *        UTF-8, to the given buffer.
+     * @note Same as the QString buffer overload, but the constant parts of the
+     *       string are rendered in UTF-8 once per class and method, and the
+     *       values are stringified directly in UTF-8 when their stringifiers
+     *       allow it, without a QString and a conversion of the whole string.
+     */
+    bool stringify(const void* objectAddress, const QString& objectName
+                   , const QMetaObject* metaObject, const QMetaMethod& metaMethod
+                   , const QVector<QVariant>& parameters, QByteArray& buffer);
+
 private:
 
+    struct MethodTemplate;
+
+    typedef QPair<const QMetaObject*, int> MethodKey;
+
+    const MethodTemplate& getMethodTemplate(const QMetaObject* metaObject
+                                            , const QMetaMethod& metaMethod);
+
+    template <typename BUFFER>
+    bool stringifyTo(const void* objectAddress, const QString& objectName
+                     , const QMetaObject* metaObject, const QMetaMethod& metaMethod
+                     , const QVector<QVariant>& parameters, BUFFER& buffer);
+
     QString _buffer;
+    QHash<MethodKey, QSharedPointer<const MethodTemplate>> _methodTemplates;
 
 };
 
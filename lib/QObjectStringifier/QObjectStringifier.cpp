@@ -21,7 +21,9 @@
 #include "QValueStringifier.h"
 
 #include <QMultiHash>
+#include <QHash>
 #include <QMutex>
+#include <QAtomicInt>
 
 class QObjectStringifierData {
 
@@ -51,12 +53,48 @@ public:
                                   , StringifierFunc stringifierFunc) {
         if(! _stringifiers.contains(metaObject, stringifierFunc)) {
             _stringifiers.insertMulti(metaObject, stringifierFunc);
+            _generation.ref();
         }
     }
 
     inline void disableStringifier(const QMetaObject* metaObject
                                    , StringifierFunc stringifierFunc) {
-        _stringifiers.remove(metaObject, stringifierFunc);
+        if(_stringifiers.remove(metaObject, stringifierFunc) > 0) {
+            _generation.ref();
+        }
+    }
+
+    /**
+     * @brief Returns the stringifier for the given class, following the
+     *        inheritance chain until a class with a stringifier is found.
+     * @details The result is memoized per QMetaObject in a per thread cache
+     *          that is discarded whenever enable() or disable() change the
+     *          registry, so the inheritance chain is only walked, under the
+     *          registry lock, the first time a class is stringified.
+     */
+    static StringifierFunc resolveStringifier(const QMetaObject* metaObject) {
+        thread_local QHash<const QMetaObject*, StringifierFunc> cache;
+        thread_local int cacheGeneration = -1;
+        if(cacheGeneration == _generation.loadAcquire()) {
+            const StringifierFunc stringifierFunc = cache.value(metaObject, nullptr);
+            if(stringifierFunc) {
+                return stringifierFunc;
+            }
+        }
+        QObjectStringifierData data;
+        const int generation = _generation.loadAcquire();
+        if(cacheGeneration != generation) {
+            cache.clear();
+            cacheGeneration = generation;
+        }
+        const auto& stringifiers = data.getStringifiers();
+        const QMetaObject* superClass = metaObject;
+        decltype(stringifiers.find(superClass)) iter;
+        while((iter = stringifiers.find(superClass)) == stringifiers.constEnd()) {
+            superClass = superClass->superClass();
+        }
+        cache.insert(metaObject, iter.value());
+        return iter.value();
     }
 
     static inline void enableThreadSafeAccess() {
@@ -72,12 +110,14 @@ private:
     const bool _useMutex;
 
     static Stringifiers _stringifiers;
+    static QAtomicInt _generation;
     static QMutex _mutex;
     static bool _threadSafeAccess;
 
 };
 
 QObjectStringifierData::Stringifiers QObjectStringifierData::_stringifiers;
+QAtomicInt QObjectStringifierData::_generation;
 QMutex QObjectStringifierData::_mutex;
 bool QObjectStringifierData::_threadSafeAccess = false;
 
@@ -122,19 +162,25 @@ void QObjectStringifier::disableThreadSafe() {
 }
 
 void QObjectStringifier::stringify(const QObject* object, QString& buffer) {
-    QObjectStringifierData data;
-    const auto& stringifiers = data.getStringifiers();
     const QMetaObject* metaObject = object ? object->metaObject() : &QObject::staticMetaObject;
-    decltype(stringifiers.find(metaObject)) iter;
-    while((iter = stringifiers.find(metaObject)) == stringifiers.constEnd()) {
-        metaObject = metaObject->superClass();
-    }
-    iter.value()(object, buffer);
+    QObjectStringifierData::resolveStringifier(metaObject)(object, buffer);
+}
+
+void QObjectStringifier::stringify(const QObject* object, QByteArray& buffer) {
+    // A stringifier that stringifies into a QByteArray itself gets an empty
+    // QString, instead of the one in use.
+    static thread_local QString threadString;
+    QString string;
+    string.swap(threadString);
+    stringify(object, string);
+    QValueStringifier::appendUtf8(string, buffer);
+    string.truncate(0);
+    threadString.swap(string);
 }
 
 typedef QObject* qobjectstar;
-IMPLEMENT_VALUE_STRINGIFIER(qobjectstar) {
-    QObjectStringifier::stringify(var.value<QObject*>(), buffer);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(qobjectstar) {
+    QObjectStringifier::stringify(value, buffer);
 }
 
 IMPLEMENT_QOBJECT_STRINGIFIER(QObject) {
@@ -115,6 +115,14 @@ public:
      */
     static void stringify(const QObject* object, QString& buffer);
 
+    /**
+     * @brief Stringify the given object and append it, encoded in UTF-8, to
+     *        the given buffer.
+     * @note The object is stringified into a reused QString, that is then
+     *       encoded into the buffer.
+     */
+    static void stringify(const QObject* object, QByteArray& buffer);
+
 private:
 
     const QMetaObject* _metaObject;
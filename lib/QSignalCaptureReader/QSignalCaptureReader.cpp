@@ -0,0 +1,253 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+#include "QSignalCaptureReader.h"
+#include "QValueSerializer.h"
+
+#include <cstring>
+
+qint64 QSignalCaptureReader::Event::getTimestamp() const {
+    return _timestamp;
+}
+
+quint64 QSignalCaptureReader::Event::getSignalerAddress() const {
+    return _signalerAddress;
+}
+
+const QString& QSignalCaptureReader::Event::getSignalerClassName() const {
+    return _className;
+}
+
+const QString& QSignalCaptureReader::Event::getSignalerObjectName() const {
+    return _objectName;
+}
+
+const QString& QSignalCaptureReader::Event::getSignalSignature() const {
+    return _signature;
+}
+
+int QSignalCaptureReader::Event::getSignalMethodIndex() const {
+    return _methodIndex;
+}
+
+const QByteArray& QSignalCaptureReader::Event::getSerializedParameters() const {
+    return _parameters;
+}
+
+QVector<QVariant> QSignalCaptureReader::Event::getParameters() const {
+    QVector<QVariant> parameters;
+    const char* data = _parameters.constData();
+    const char* const end = data + _parameters.size();
+    QByteArray remapped;
+    while(data < end) {
+        // Peek the record's tag to remap user type ids.
+        const char* record = data;
+        quint64 tag = 0;
+        quint64 length = 0;
+        if(! QValueSerializer::readVarint(record, end, tag)
+                || ! QValueSerializer::readVarint(record, end, length)
+                || length > static_cast<quint64>(end - record)) {
+            break;
+        }
+        QVariant parameter;
+        const quint64 typeId = tag >> 1;
+        if(typeId < static_cast<quint64>(QMetaType::User)) {
+            QValueSerializer::deserialize(data, end, parameter);
+        } else {
+            const int readerTypeId = _typeIds.value(static_cast<int>(typeId), QMetaType::UnknownType);
+            if(readerTypeId != QMetaType::UnknownType) {
+                remapped.clear();
+                QValueSerializer::writeVarint((static_cast<quint64>(readerTypeId) << 1) | (tag & 1)
+                                              , remapped);
+                QValueSerializer::writeVarint(length, remapped);
+                remapped.append(record, static_cast<int>(length));
+                const char* remappedData = remapped.constData();
+                QValueSerializer::deserialize(remappedData, remappedData + remapped.size()
+                                              , parameter);
+            }
+            data = record + length;
+        }
+        parameters.append(parameter);
+    }
+    return parameters;
+}
+
+QSignalCaptureReader::QSignalCaptureReader(const QString& filePath)
+    : _filePath(filePath)
+    , _file()
+    , _data(nullptr)
+    , _end(0)
+    , _offset(0)
+    , _segmentIndex(0)
+    , _startTime(-1)
+    , _strings()
+    , _typeIds()
+    , _atEnd(false) {
+}
+
+QSignalCaptureReader::~QSignalCaptureReader() {
+    closeSegment();
+}
+
+const QString& QSignalCaptureReader::getFilePath() const {
+    return _filePath;
+}
+
+qint64 QSignalCaptureReader::getStartTime() const {
+    return _startTime;
+}
+
+int QSignalCaptureReader::getSegmentIndex() const {
+    return _segmentIndex;
+}
+
+bool QSignalCaptureReader::readNext(Event& event) {
+    while(! _atEnd) {
+        if(! _data && ! openSegment(_segmentIndex)) {
+            _atEnd = true;
+            break;
+        }
+        RecordHeader header;
+        if(_end - _offset < static_cast<qint64>(sizeof(header))) {
+            closeSegment();
+            ++_segmentIndex;
+            continue;
+        }
+        const uchar* const record = _data + _offset;
+        std::memcpy(&header, record, sizeof(header));
+        if(header.size < sizeof(header) || header.size % RECORD_ALIGNMENT != 0
+                || header.size > _end - _offset) {
+            // Corrupted segment.
+            closeSegment();
+            ++_segmentIndex;
+            continue;
+        }
+        _offset += header.size;
+        switch(header.kind) {
+        case StringKind: {
+            StringRecord string;
+            if(header.size < sizeof(string)) {
+                break;
+            }
+            std::memcpy(&string, record, sizeof(string));
+            // String ids are sequential.
+            if(string.length > header.size - sizeof(string)
+                    || string.id != static_cast<quint32>(_strings.size())) {
+                break;
+            }
+            _strings.append(QString::fromUtf8(reinterpret_cast<const char*>(record + sizeof(string))
+                                              , static_cast<int>(string.length)));
+            break;
+        }
+        case TypeKind: {
+            TypeRecord type;
+            if(header.size < sizeof(type)) {
+                break;
+            }
+            std::memcpy(&type, record, sizeof(type));
+            _typeIds.insert(type.typeId, QMetaType::type(string(type.nameId).toUtf8().constData()));
+            break;
+        }
+        case EventKind: {
+            EventRecord eventRecord;
+            if(header.size < sizeof(eventRecord)) {
+                break;
+            }
+            std::memcpy(&eventRecord, record, sizeof(eventRecord));
+            if(eventRecord.parametersSize > header.size - sizeof(eventRecord)) {
+                break;
+            }
+            event._timestamp = eventRecord.timestamp;
+            event._signalerAddress = eventRecord.signalerAddress;
+            event._className = string(eventRecord.classNameId);
+            event._objectName = string(eventRecord.objectNameId);
+            event._signature = string(eventRecord.signatureId);
+            event._methodIndex = eventRecord.methodIndex;
+            event._parameters = QByteArray(reinterpret_cast<const char*>(record + sizeof(eventRecord))
+                                           , static_cast<int>(eventRecord.parametersSize));
+            event._typeIds = _typeIds;
+            return true;
+        }
+        default:
+            // Unknown records are skipped.
+            break;
+        }
+    }
+    return false;
+}
+
+void QSignalCaptureReader::rewind() {
+    closeSegment();
+    _segmentIndex = 0;
+    _atEnd = false;
+}
+
+QString QSignalCaptureReader::segmentFilePath(const QString& filePath, int segmentIndex) {
+    if(segmentIndex == 0) {
+        return filePath;
+    }
+    return filePath + QLatin1Char('.') + QString::number(segmentIndex);
+}
+
+bool QSignalCaptureReader::openSegment(int segmentIndex) {
+    Q_ASSERT(! _data);
+    _file.setFileName(segmentFilePath(_filePath, segmentIndex));
+    if(! _file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    FileHeader header;
+    const qint64 fileSize = _file.size();
+    if(fileSize < static_cast<qint64>(sizeof(header))) {
+        _file.close();
+        return false;
+    }
+    _data = _file.map(0, fileSize);
+    if(! _data) {
+        _file.close();
+        return false;
+    }
+    std::memcpy(&header, _data, sizeof(header));
+    if(header.magic != MAGIC || header.version != VERSION
+            || header.headerSize < sizeof(header)
+            || static_cast<qint64>(header.usedSize) > fileSize
+            || header.usedSize < header.headerSize) {
+        closeSegment();
+        return false;
+    }
+    _offset = header.headerSize;
+    _end = static_cast<qint64>(header.usedSize);
+    _startTime = header.startTime;
+    _strings.append(QString());
+    return true;
+}
+
+void QSignalCaptureReader::closeSegment() {
+    if(_data) {
+        _file.unmap(const_cast<uchar*>(_data));
+        _data = nullptr;
+    }
+    _file.close();
+    _offset = 0;
+    _end = 0;
+    _strings.clear();
+    _typeIds.clear();
+}
+
+QString QSignalCaptureReader::string(quint32 id) const {
+    return _strings.value(static_cast<int>(id));
+}
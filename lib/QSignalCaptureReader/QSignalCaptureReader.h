@@ -0,0 +1,285 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+#ifndef QSIGNALCAPTUREREADER_H
+#define QSIGNALCAPTUREREADER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVariant>
+#include <QVector>
+#include <QHash>
+#include <QFile>
+
+/**
+ * @brief Reads the capture files written by QSignalLogger::setCaptureFile(),
+ *        one memory mapped segment at a time.
+ * @details A capture is a sequence of segment files: the capture's file path
+ *          followed by the file path with the suffixes ".1", ".2", ... Each
+ *          segment starts with a FileHeader and is followed by records aligned
+ *          to 8 bytes, each starting with a RecordHeader. StringRecords and
+ *          TypeRecords are written to a segment before the first EventRecord
+ *          that uses them, so each segment can be read on its own.
+ */
+class QSignalCaptureReader {
+
+public:
+
+    /** @brief Magic number at the start of every segment ("QSIGCAP\0"). */
+    static const quint64 MAGIC = Q_UINT64_C(0x0050414347495351);
+
+    /** @brief Version of the capture file format. */
+    static const quint32 VERSION = 1;
+
+    /** @brief Alignment of the records. */
+    static const int RECORD_ALIGNMENT = 8;
+
+    /** @brief Kinds of records. */
+    enum RecordKind : quint32 {
+        StringKind = 1,
+        TypeKind = 2,
+        EventKind = 3
+    };
+
+    /** @brief Header at the start of every segment. */
+    struct FileHeader {
+        quint64 magic;
+        quint32 version;
+        /** @brief Size of the header, the offset of the first record. */
+        quint32 headerSize;
+        /** @brief Index of the segment in the capture. */
+        quint32 segmentIndex;
+        quint32 reserved;
+        /** @brief Offset of the end of the last complete record. */
+        quint64 usedSize;
+        /** @brief Time the capture started, in milliseconds since epoch. */
+        qint64 startTime;
+    };
+
+    /** @brief Header at the start of every record. */
+    struct RecordHeader {
+        /** @brief Size of the record, including headers and padding. */
+        quint32 size;
+        /** @brief One of RecordKind. */
+        quint32 kind;
+    };
+
+    /**
+     * @brief Interns a string, whose UTF-8 bytes follow the record.
+     *        String ids start at 1 in every segment. Id 0 is the empty string.
+     */
+    struct StringRecord {
+        RecordHeader header;
+        quint32 id;
+        quint32 length;
+    };
+
+    /** @brief Associates a user type id of the writer with its type name. */
+    struct TypeRecord {
+        RecordHeader header;
+        qint32 typeId;
+        quint32 nameId;
+    };
+
+    /**
+     * @brief A signal. The signal's parameters follow the record, one
+     *        QValueSerializer record per parameter.
+     */
+    struct EventRecord {
+        RecordHeader header;
+        /** @brief Nanoseconds since the capture started. */
+        qint64 timestamp;
+        quint64 signalerAddress;
+        quint32 classNameId;
+        quint32 signatureId;
+        quint32 objectNameId;
+        qint32 methodIndex;
+        quint32 parametersSize;
+        quint32 reserved;
+    };
+
+    class Event {
+
+        friend class QSignalCaptureReader;
+
+    public:
+
+        /**
+         * @brief Default constructor.
+         */
+        Event() = default;
+
+        /**
+         * @brief Returns the time the signal was received, in nanoseconds
+         *        since the capture started.
+         * @return
+         */
+        qint64 getTimestamp() const;
+
+        /**
+         * @brief Returns the memory address the signaler object had.
+         * @return
+         */
+        quint64 getSignalerAddress() const;
+
+        /**
+         * @brief Returns the signaler's class name.
+         * @return
+         */
+        const QString& getSignalerClassName() const;
+
+        /**
+         * @brief Returns the signaler's object name at the time the signal was
+         *        emitted. May be empty.
+         * @return
+         */
+        const QString& getSignalerObjectName() const;
+
+        /**
+         * @brief Returns the signal's method signature.
+         * @return
+         */
+        const QString& getSignalSignature() const;
+
+        /**
+         * @brief Returns the signal's method index.
+         * @return
+         */
+        int getSignalMethodIndex() const;
+
+        /**
+         * @brief Returns the signal's serialized parameters, one
+         *        QValueSerializer record per parameter.
+         * @return
+         */
+        const QByteArray& getSerializedParameters() const;
+
+        /**
+         * @brief Returns the signal's parameters, deserialized.
+         * @note Values of user types are only deserialized if a type with the
+         *       same name is registered, and has a QValueSerializer or stream
+         *       operators, in the reading process. Otherwise they are returned
+         *       as invalid QVariants.
+         * @return
+         */
+        QVector<QVariant> getParameters() const;
+
+    private:
+
+        qint64 _timestamp = 0;
+        quint64 _signalerAddress = 0;
+        QString _className;
+        QString _objectName;
+        QString _signature;
+        int _methodIndex = -1;
+        QByteArray _parameters;
+        /** @brief The writer's user type ids mapped to the reader's. */
+        QHash<int, int> _typeIds;
+    };
+
+    /**
+     * @brief Constructor.
+     * @param filePath Capture's file path, the path of the first segment.
+     */
+    explicit QSignalCaptureReader(const QString& filePath);
+
+    /**
+     * @brief Destructor.
+     */
+    ~QSignalCaptureReader();
+
+    /**
+     * @brief Returns the capture's file path.
+     * @return
+     */
+    const QString& getFilePath() const;
+
+    /**
+     * @brief Returns the time the capture started, in milliseconds since epoch,
+     *        or -1 if no segment was read yet.
+     * @return
+     */
+    qint64 getStartTime() const;
+
+    /**
+     * @brief Returns the index of the segment being read.
+     * @return
+     */
+    int getSegmentIndex() const;
+
+    /**
+     * @brief Reads the next event.
+     * @details Only the segment being read is mapped to memory. Segments that
+     *          are missing or have an invalid header end the capture.
+     * @param event Where the event is stored.
+     * @return Returns false if there are no more events.
+     */
+    bool readNext(Event& event);
+
+    /**
+     * @brief Restarts reading from the first event.
+     */
+    void rewind();
+
+    /**
+     * @brief Returns the file path of a capture's segment.
+     * @param filePath Capture's file path.
+     * @param segmentIndex Segment's index.
+     * @return
+     */
+    static QString segmentFilePath(const QString& filePath, int segmentIndex);
+
+private:
+
+    Q_DISABLE_COPY(QSignalCaptureReader)
+
+    /**
+     * @brief Maps the segment with the given index.
+     * @return Returns false if the segment is missing or invalid.
+     */
+    bool openSegment(int segmentIndex);
+
+    /**
+     * @brief Unmaps the current segment.
+     */
+    void closeSegment();
+
+    /**
+     * @brief Returns the interned string with the given id.
+     */
+    QString string(quint32 id) const;
+
+    const QString _filePath;
+    QFile _file;
+    /** @brief The mapped segment or nullptr. */
+    const uchar* _data;
+    /** @brief Offset of the end of the segment's complete records. */
+    qint64 _end;
+    /** @brief Offset of the next record. */
+    qint64 _offset;
+    int _segmentIndex;
+    qint64 _startTime;
+    /** @brief The segment's string table, indexed by string id. */
+    QVector<QString> _strings;
+    /** @brief The segment's user type ids mapped to the reader's. */
+    QHash<int, int> _typeIds;
+    /** @brief True after the last segment was read. */
+    bool _atEnd;
+};
+
+#endif // QSIGNALCAPTUREREADER_H
@@ -0,0 +1,347 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QSignalCascadeTracer.h"
+
+#include <algorithm>
+
+QSignalCascadeTracer::Method::Method()
+    : _type(Type::Signal)
+    , _metaObject(nullptr)
+    , _methodIndex(-1) {
+}
+
+QSignalCascadeTracer::Method::Method(Type type, const QMetaObject* metaObject, int methodIndex)
+    : _type(type)
+    , _metaObject(metaObject)
+    , _methodIndex(methodIndex) {
+}
+
+bool QSignalCascadeTracer::Method::isValid() const {
+    return _metaObject != nullptr;
+}
+
+QSignalCascadeTracer::Method::Type QSignalCascadeTracer::Method::getType() const {
+    return _type;
+}
+
+const QMetaObject* QSignalCascadeTracer::Method::getMetaObject() const {
+    return _metaObject;
+}
+
+int QSignalCascadeTracer::Method::getMethodIndex() const {
+    return _methodIndex;
+}
+
+QMetaMethod QSignalCascadeTracer::Method::getMetaMethod() const {
+    return _metaObject ? _metaObject->method(_methodIndex) : QMetaMethod();
+}
+
+bool QSignalCascadeTracer::Method::operator==(const Method& other) const {
+    return _type == other._type
+            && _metaObject == other._metaObject
+            && _methodIndex == other._methodIndex;
+}
+
+bool QSignalCascadeTracer::Method::operator!=(const Method& other) const {
+    return ! (*this == other);
+}
+
+uint qHash(const QSignalCascadeTracer::Method& method, uint seed) {
+    return qHash(method.getMetaObject(), seed)
+            ^ qHash(method.getMethodIndex() * 2
+                    + (method.getType() == QSignalCascadeTracer::Method::Type::Slot ? 1 : 0)
+                    , seed);
+}
+
+const QSignalCascadeTracer::Method& QSignalCascadeTracer::Node::getMethod() const {
+    return _method;
+}
+
+const void* QSignalCascadeTracer::Node::getAddress() const {
+    return _address;
+}
+
+qint64 QSignalCascadeTracer::Node::getTimestamp() const {
+    return _timestamp;
+}
+
+qint64 QSignalCascadeTracer::Node::getInclusiveDuration() const {
+    return _inclusiveDuration;
+}
+
+qint64 QSignalCascadeTracer::Node::getExclusiveDuration() const {
+    return _exclusiveDuration;
+}
+
+int QSignalCascadeTracer::Node::getEmissionCount() const {
+    return _emissionCount;
+}
+
+const QVector<QSignalCascadeTracer::Node>& QSignalCascadeTracer::Node::getChildren() const {
+    return _children;
+}
+
+QSignalCascadeTracer::MethodStatistics::MethodStatistics()
+    : _method()
+    , _count(0)
+    , _inclusiveDuration(0)
+    , _exclusiveDuration(0) {
+}
+
+const QSignalCascadeTracer::Method& QSignalCascadeTracer::MethodStatistics::getMethod() const {
+    return _method;
+}
+
+quint64 QSignalCascadeTracer::MethodStatistics::getCount() const {
+    return _count;
+}
+
+qint64 QSignalCascadeTracer::MethodStatistics::getInclusiveDuration() const {
+    return _inclusiveDuration;
+}
+
+qint64 QSignalCascadeTracer::MethodStatistics::getExclusiveDuration() const {
+    return _exclusiveDuration;
+}
+
+QSignalCascadeTracer::CallStatistics::CallStatistics()
+    : _caller()
+    , _callee()
+    , _count(0)
+    , _inclusiveDuration(0) {
+}
+
+const QSignalCascadeTracer::Method& QSignalCascadeTracer::CallStatistics::getCaller() const {
+    return _caller;
+}
+
+const QSignalCascadeTracer::Method& QSignalCascadeTracer::CallStatistics::getCallee() const {
+    return _callee;
+}
+
+quint64 QSignalCascadeTracer::CallStatistics::getCount() const {
+    return _count;
+}
+
+qint64 QSignalCascadeTracer::CallStatistics::getInclusiveDuration() const {
+    return _inclusiveDuration;
+}
+
+QSignalCascadeTracer::QSignalCascadeTracer(QObject* parent, int cascadeCount)
+    : QSignalSlotMonitor(parent)
+    , _timer()
+    , _frames()
+    , _mutex()
+    , _methods()
+    , _calls()
+    , _largest()
+    , _tracedCount(0)
+    , _cascadeCount(qMax(cascadeCount, 0)) {
+    Q_ASSERT(cascadeCount >= 0);
+    _timer.start();
+}
+
+int QSignalCascadeTracer::getCascadeCount() const {
+    QMutexLocker locker(&_mutex);
+    return _cascadeCount;
+}
+
+void QSignalCascadeTracer::setCascadeCount(int cascadeCount) {
+    Q_ASSERT(cascadeCount >= 0);
+    QMutexLocker locker(&_mutex);
+    _cascadeCount = qMax(cascadeCount, 0);
+    if(_largest.count() > _cascadeCount) {
+        _largest.resize(_cascadeCount);
+    }
+}
+
+quint64 QSignalCascadeTracer::getTracedCount() const {
+    QMutexLocker locker(&_mutex);
+    return _tracedCount;
+}
+
+QVector<QSignalCascadeTracer::Node> QSignalCascadeTracer::getLargestCascades() const {
+    QMutexLocker locker(&_mutex);
+    return _largest;
+}
+
+QVector<QSignalCascadeTracer::MethodStatistics> QSignalCascadeTracer::getMethodStatistics() const {
+    QVector<MethodStatistics> statistics;
+    {
+        QMutexLocker locker(&_mutex);
+        statistics.reserve(_methods.count());
+        for(const MethodStatistics& methodStatistics : _methods) {
+            statistics.append(methodStatistics);
+        }
+    }
+    std::sort(statistics.begin(), statistics.end()
+              , [] (const MethodStatistics& a, const MethodStatistics& b) {
+        return a._inclusiveDuration > b._inclusiveDuration;
+    });
+    return statistics;
+}
+
+QVector<QSignalCascadeTracer::CallStatistics> QSignalCascadeTracer::getCallStatistics() const {
+    QVector<CallStatistics> statistics;
+    {
+        QMutexLocker locker(&_mutex);
+        statistics.reserve(_calls.count());
+        for(const CallStatistics& callStatistics : _calls) {
+            statistics.append(callStatistics);
+        }
+    }
+    std::sort(statistics.begin(), statistics.end()
+              , [] (const CallStatistics& a, const CallStatistics& b) {
+        return a._inclusiveDuration > b._inclusiveDuration;
+    });
+    return statistics;
+}
+
+void QSignalCascadeTracer::clear() {
+    QMutexLocker locker(&_mutex);
+    _methods.clear();
+    _calls.clear();
+    _largest.clear();
+    _tracedCount = 0;
+}
+
+void QSignalCascadeTracer::signalBegin(const SignalInfo& signalInfo) {
+    begin(Method::Type::Signal, signalInfo.getSignaler(), signalInfo.getMethodIndex());
+}
+
+void QSignalCascadeTracer::signalEnd(const SignalInfo& signalInfo) {
+    end(Method::Type::Signal, signalInfo.getSignaler(), signalInfo.getMethodIndex());
+}
+
+void QSignalCascadeTracer::slotBegin(const SignalInfo& signalInfo, const SlotInfo& slotInfo) {
+    Q_UNUSED(signalInfo);
+    begin(Method::Type::Slot, slotInfo.getReceiver(), slotInfo.getMethodIndex());
+}
+
+void QSignalCascadeTracer::slotEnd(const SignalInfo& signalInfo, const SlotInfo& slotInfo) {
+    Q_UNUSED(signalInfo);
+    end(Method::Type::Slot, slotInfo.getReceiver(), slotInfo.getMethodIndex());
+}
+
+QVector<QSignalCascadeTracer::Frame>& QSignalCascadeTracer::getFrames() {
+    if(! _frames.hasLocalData()) {
+        QVector<Frame> frames;
+        frames.reserve(32);
+        _frames.setLocalData(frames);
+    }
+    return _frames.localData();
+}
+
+void QSignalCascadeTracer::begin(Method::Type type, const QObject* object, int methodIndex) {
+    // The object may be deleted by a slot, so everything is taken now.
+    QVector<Frame>& frames = getFrames();
+    dropStaleFrames(frames);
+    // A slot without a signal happens when the tracer is enabled by the slot's signal.
+    if(type == Method::Type::Slot && frames.isEmpty()) {
+        return;
+    }
+    Node node;
+    node._method = Method(type, object->metaObject(), methodIndex);
+    node._address = object;
+    node._inclusiveDuration = 0;
+    node._exclusiveDuration = 0;
+    node._emissionCount = type == Method::Type::Signal ? 1 : 0;
+    const Frame frame = { getMonitorGeneration(), node, 0 };
+    frames.append(frame);
+    frames.last().node._timestamp = _timer.nsecsElapsed();
+}
+
+void QSignalCascadeTracer::end(Method::Type type, const QObject* object, int methodIndex) {
+    const qint64 end = _timer.nsecsElapsed();
+    QVector<Frame>& frames = getFrames();
+    dropStaleFrames(frames);
+    // The tracer may have been enabled while the signal or slot was running.
+    if(frames.isEmpty()) {
+        return;
+    }
+    const Node& last = frames.constLast().node;
+    if(last._method._type != type || last._address != object
+            || last._method._methodIndex != methodIndex) {
+        return;
+    }
+    Frame frame = frames.takeLast();
+    Node& node = frame.node;
+    node._inclusiveDuration = end - node._timestamp;
+    node._exclusiveDuration = node._inclusiveDuration - frame.childrenDuration;
+    if(frames.isEmpty()) {
+        recordCascade(node);
+    } else {
+        Frame& parent = frames.last();
+        parent.childrenDuration += node._inclusiveDuration;
+        parent.node._emissionCount += node._emissionCount;
+        parent.node._children.append(node);
+    }
+}
+
+void QSignalCascadeTracer::dropStaleFrames(QVector<Frame>& frames) const {
+    const int generation = getMonitorGeneration();
+    while(! frames.isEmpty() && frames.constLast().generation != generation) {
+        frames.removeLast();
+    }
+}
+
+void QSignalCascadeTracer::recordCascade(const Node& root) {
+    QHash<Method, int> active;
+    QMutexLocker locker(&_mutex);
+    ++_tracedCount;
+    aggregate(root, Method(), active);
+    if(_cascadeCount == 0 || (_largest.count() == _cascadeCount
+            && root._emissionCount <= _largest.constLast()._emissionCount)) {
+        return;
+    }
+    const auto position = std::upper_bound(
+                _largest.begin(), _largest.end(), root
+                , [] (const Node& a, const Node& b) {
+        return a._emissionCount > b._emissionCount;
+    });
+    _largest.insert(position, root);
+    if(_largest.count() > _cascadeCount) {
+        _largest.removeLast();
+    }
+}
+
+void QSignalCascadeTracer::aggregate(const Node& node, const Method& caller, QHash<Method, int>& active) {
+    int& depth = active[node._method];
+    MethodStatistics& methodStatistics = _methods[node._method];
+    methodStatistics._method = node._method;
+    ++methodStatistics._count;
+    methodStatistics._exclusiveDuration += node._exclusiveDuration;
+    // A recursive call's duration is already included in the outermost call.
+    if(depth == 0) {
+        methodStatistics._inclusiveDuration += node._inclusiveDuration;
+    }
+    if(caller.isValid()) {
+        CallStatistics& callStatistics = _calls[CallKey(caller, node._method)];
+        callStatistics._caller = caller;
+        callStatistics._callee = node._method;
+        ++callStatistics._count;
+        callStatistics._inclusiveDuration += node._inclusiveDuration;
+    }
+    ++depth;
+    for(const Node& child : node._children) {
+        aggregate(child, node._method, active);
+    }
+    --active[node._method];
+}
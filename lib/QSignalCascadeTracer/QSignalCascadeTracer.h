@@ -0,0 +1,387 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#ifndef QSIGNALCASCADETRACER_H
+#define QSIGNALCASCADETRACER_H
+
+#include "QSignalSlotMonitor.h"
+
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QMutex>
+#include <QThreadStorage>
+#include <QElapsedTimer>
+
+class QSignalCascadeTracer : public QSignalSlotMonitor {
+    Q_OBJECT
+
+public:
+
+    /**
+     * @brief Identifies a signal or a slot of a class.
+     */
+    class Method {
+
+        friend class QSignalCascadeTracer;
+
+    public:
+
+        enum class Type {
+            Signal,
+            Slot
+        };
+
+        /**
+         * @brief Constructs an invalid method.
+         */
+        Method();
+
+        /**
+         * @brief Returns true if the method is valid.
+         * @return
+         */
+        bool isValid() const;
+
+        /**
+         * @brief Returns if the method is a signal or a slot.
+         * @return
+         */
+        Type getType() const;
+
+        /**
+         * @brief Returns the meta object of the method's class.
+         * @return
+         */
+        const QMetaObject* getMetaObject() const;
+
+        /**
+         * @brief Returns the method index.
+         * @return
+         */
+        int getMethodIndex() const;
+
+        /**
+         * @brief Returns the meta method.
+         * @return
+         */
+        QMetaMethod getMetaMethod() const;
+
+        bool operator==(const Method& other) const;
+        bool operator!=(const Method& other) const;
+
+    private:
+
+        Method(Type type, const QMetaObject* metaObject, int methodIndex);
+
+        Type _type;
+        const QMetaObject* _metaObject;
+        int _methodIndex;
+    };
+
+    /**
+     * @brief A signal emission or a slot call of a cascade, with the slots
+     *        called by the signal or the signals emitted by the slot.
+     */
+    class Node {
+
+        friend class QSignalCascadeTracer;
+        template <typename T> friend class QVector;
+
+    public:
+
+        /**
+         * @brief Returns the emited signal or the called slot.
+         * @return
+         */
+        const Method& getMethod() const;
+
+        /**
+         * @brief Returns the memory address of the signaler or receiver object.
+         * @warning Do not use this pointer to access the object because there is
+         *          no way of knowing if the object is still valid.
+         * @return
+         */
+        const void* getAddress() const;
+
+        /**
+         * @brief Returns the time the signal was emited or the slot was called,
+         *        in nanoseconds since the tracer was constructed.
+         * @return
+         */
+        qint64 getTimestamp() const;
+
+        /**
+         * @brief Returns the duration in nanoseconds, including the children.
+         * @return
+         */
+        qint64 getInclusiveDuration() const;
+
+        /**
+         * @brief Returns the duration in nanoseconds, excluding the children.
+         * @return
+         */
+        qint64 getExclusiveDuration() const;
+
+        /**
+         * @brief Returns the number of signals emited by this node and all its
+         *        descendants, including itself if it is a signal.
+         * @return
+         */
+        int getEmissionCount() const;
+
+        /**
+         * @brief Returns the slots called by the signal, or the signals emited
+         *        by the slot, in order.
+         * @return
+         */
+        const QVector<Node>& getChildren() const;
+
+    private:
+
+        /**
+         * @brief Default constructor needed by QVector<Node>.
+         */
+        Node() = default;
+
+        Method _method;
+        const void* _address;
+        qint64 _timestamp;
+        qint64 _inclusiveDuration;
+        qint64 _exclusiveDuration;
+        int _emissionCount;
+        QVector<Node> _children;
+    };
+
+    /**
+     * @brief Aggregated durations of all the calls of a method.
+     */
+    class MethodStatistics {
+
+        friend class QSignalCascadeTracer;
+        template <typename T> friend class QVector;
+        template <typename K, typename V> friend class QHash;
+
+    public:
+
+        /**
+         * @brief Returns the signal or slot.
+         * @return
+         */
+        const Method& getMethod() const;
+
+        /**
+         * @brief Returns the number of times the signal was emited or the
+         *        slot was called.
+         * @return
+         */
+        quint64 getCount() const;
+
+        /**
+         * @brief Returns the total duration in nanoseconds, including the
+         *        children. Recursive calls are only counted once.
+         * @return
+         */
+        qint64 getInclusiveDuration() const;
+
+        /**
+         * @brief Returns the total duration in nanoseconds, excluding the
+         *        children.
+         * @return
+         */
+        qint64 getExclusiveDuration() const;
+
+    private:
+
+        MethodStatistics();
+
+        Method _method;
+        quint64 _count;
+        qint64 _inclusiveDuration;
+        qint64 _exclusiveDuration;
+    };
+
+    /**
+     * @brief Aggregated durations of all the calls from a method to another,
+     *        that is, of a slot called by a signal or of a signal emited by a
+     *        slot.
+     */
+    class CallStatistics {
+
+        friend class QSignalCascadeTracer;
+        template <typename T> friend class QVector;
+        template <typename K, typename V> friend class QHash;
+
+    public:
+
+        /**
+         * @brief Returns the signal or slot that made the calls.
+         * @return
+         */
+        const Method& getCaller() const;
+
+        /**
+         * @brief Returns the slot or signal called.
+         * @return
+         */
+        const Method& getCallee() const;
+
+        /**
+         * @brief Returns the number of calls.
+         * @return
+         */
+        quint64 getCount() const;
+
+        /**
+         * @brief Returns the total duration of the calls in nanoseconds,
+         *        including the callee's children.
+         * @return
+         */
+        qint64 getInclusiveDuration() const;
+
+    private:
+
+        CallStatistics();
+
+        Method _caller;
+        Method _callee;
+        quint64 _count;
+        qint64 _inclusiveDuration;
+    };
+
+    /**
+     * @brief Constructor.
+     * @param parent
+     * @param cascadeCount Number of largest cascades to keep.
+     * @note The tracer must be enabled with enableMonitor() to start tracing.
+     */
+    explicit QSignalCascadeTracer(QObject* parent = nullptr, int cascadeCount = 10);
+
+    /**
+     * @brief Returns the number of largest cascades kept.
+     * @return
+     */
+    int getCascadeCount() const;
+
+    /**
+     * @brief Sets the number of largest cascades kept.
+     * @param cascadeCount Must be greater or equal to zero.
+     */
+    void setCascadeCount(int cascadeCount);
+
+    /**
+     * @brief Returns the number of cascades traced.
+     * @return
+     */
+    quint64 getTracedCount() const;
+
+    /**
+     * @brief Returns a snapshot of the cascades with the most emissions, as
+     *        trees rooted at the signal that started them, largest first.
+     * @return
+     */
+    QVector<Node> getLargestCascades() const;
+
+    /**
+     * @brief Returns a snapshot of the statistics of each signal and slot,
+     *        ordered by inclusive duration, longest first.
+     * @return
+     */
+    QVector<MethodStatistics> getMethodStatistics() const;
+
+    /**
+     * @brief Returns a snapshot of the statistics of each caller and callee
+     *        pair, ordered by inclusive duration, longest first.
+     * @return
+     */
+    QVector<CallStatistics> getCallStatistics() const;
+
+    /**
+     * @brief Clears the cascades and the statistics.
+     */
+    void clear();
+
+private:
+
+    /**
+     * @brief A signal or slot being executed.
+     */
+    struct Frame {
+        int generation;
+        Node node;
+        qint64 childrenDuration;
+    };
+
+    typedef QPair<Method, Method> CallKey;
+
+    virtual void signalBegin(const SignalInfo& signalInfo) override;
+    virtual void signalEnd(const SignalInfo& signalInfo) override;
+    virtual void slotBegin(const SignalInfo& signalInfo, const SlotInfo& slotInfo) override;
+    virtual void slotEnd(const SignalInfo& signalInfo, const SlotInfo& slotInfo) override;
+
+    /**
+     * @brief Returns the calling thread's stack of signals and slots being
+     *        executed.
+     */
+    QVector<Frame>& getFrames();
+
+    /**
+     * @brief Pushes a signal or slot into the calling thread's stack.
+     */
+    void begin(Method::Type type, const QObject* object, int methodIndex);
+
+    /**
+     * @brief Pops a signal or slot from the calling thread's stack and adds it
+     *        to its parent, or records the cascade if it is the root.
+     */
+    void end(Method::Type type, const QObject* object, int methodIndex);
+
+    /**
+     * @brief Drops the frames left open by a previous enabling of the tracer
+     *        from the top of the calling thread's stack.
+     */
+    void dropStaleFrames(QVector<Frame>& frames) const;
+
+    /**
+     * @brief Adds a finished cascade to the statistics and to the largest
+     *        cascades if it is large enough.
+     */
+    void recordCascade(const Node& root);
+
+    /**
+     * @brief Adds the node and its descendants to the statistics.
+     * @param active Number of times each method is in the node's ancestors.
+     * @note Must be called with _mutex locked.
+     */
+    void aggregate(const Node& node, const Method& caller, QHash<Method, int>& active);
+
+    QElapsedTimer _timer;
+    QThreadStorage<QVector<Frame>> _frames;
+    mutable QMutex _mutex;
+    QHash<Method, MethodStatistics> _methods;
+    QHash<CallKey, CallStatistics> _calls;
+    QVector<Node> _largest;
+    quint64 _tracedCount;
+    int _cascadeCount;
+
+};
+
+uint qHash(const QSignalCascadeTracer::Method& method, uint seed = 0);
+
+#endif // QSIGNALCASCADETRACER_H
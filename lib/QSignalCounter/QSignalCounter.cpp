@@ -0,0 +1,260 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QSignalCounter.h"
+
+#include <QThread>
+#include <QPair>
+
+#include <algorithm>
+
+/**
+ * @brief The counters of the signals emited by one thread.
+ * @details Only the owner thread looks up and increments the counters, so the
+ *          increments are plain loads and stores. The table's structure is
+ *          only changed by the owner thread, holding the mutex, so other
+ *          threads can read the counters holding the mutex.
+ */
+class QSignalCounterTable {
+
+public:
+
+    typedef QHash<QPair<const QMetaObject*, int>, QPair<quint64, quint64>> Totals;
+
+    struct Counters {
+        QAtomicInteger<quint64> emissionCount;
+        QAtomicInteger<quint64> slotCallCount;
+    };
+
+    QSignalCounterTable()
+        : _mutex()
+        , _entries()
+        , _lastMetaObject(nullptr)
+        , _lastEntry() {
+    }
+
+    ~QSignalCounterTable() {
+        for(const Entry& entry : _entries) {
+            delete[] entry.counters;
+        }
+    }
+
+    /**
+     * @brief Returns the counters of the given signal, or nullptr if the index
+     *        is out of range.
+     * @note Must only be called by the owner thread.
+     */
+    inline Counters* getCounters(const QMetaObject* metaObject, int signalIndex) {
+        if(metaObject != _lastMetaObject) {
+            findEntry(metaObject);
+        }
+        if(signalIndex < 0 || signalIndex >= _lastEntry.count) {
+            return nullptr;
+        }
+        return _lastEntry.counters + signalIndex;
+    }
+
+    /**
+     * @brief Increments the given counter.
+     * @note Must only be called by the owner thread.
+     */
+    static inline void increment(QAtomicInteger<quint64>& counter) {
+        counter.store(counter.load() + 1);
+    }
+
+    /**
+     * @brief Adds the counters to the given totals.
+     */
+    void collect(Totals& totals) const {
+        QMutexLocker locker(&_mutex);
+        for(auto iter = _entries.constBegin(); iter != _entries.constEnd(); ++iter) {
+            const Entry& entry = iter.value();
+            for(int signalIndex = 0; signalIndex < entry.count; ++signalIndex) {
+                const quint64 emissionCount = entry.counters[signalIndex].emissionCount.load();
+                const quint64 slotCallCount = entry.counters[signalIndex].slotCallCount.load();
+                if(emissionCount != 0 || slotCallCount != 0) {
+                    QPair<quint64, quint64>& total = totals[qMakePair(iter.key(), signalIndex)];
+                    total.first += emissionCount;
+                    total.second += slotCallCount;
+                }
+            }
+        }
+    }
+
+private:
+
+    struct Entry {
+        int count;
+        Counters* counters;
+    };
+
+    void findEntry(const QMetaObject* metaObject) {
+        auto iter = _entries.constFind(metaObject);
+        if(iter == _entries.constEnd()) {
+            int count = 0;
+            for(int methodIndex = 0; methodIndex < metaObject->methodCount(); ++methodIndex) {
+                if(metaObject->method(methodIndex).methodType() == QMetaMethod::Signal) {
+                    ++count;
+                }
+            }
+            const Entry entry = { count, new Counters[count] };
+            QMutexLocker locker(&_mutex);
+            iter = _entries.insert(metaObject, entry);
+        }
+        _lastMetaObject = metaObject;
+        _lastEntry = iter.value();
+    }
+
+    mutable QMutex _mutex;
+    QHash<const QMetaObject*, Entry> _entries;
+    const QMetaObject* _lastMetaObject;
+    Entry _lastEntry;
+
+};
+
+/* Source of the ids of the counters' tables. Zero is never used. */
+static QAtomicInt nextId(0);
+
+/**
+ * @brief Returns the method index of each signal index of the given meta object.
+ */
+static QVector<int> getMethodIndexes(const QMetaObject* metaObject) {
+    QVector<int> methodIndexes;
+    for(int methodIndex = 0; methodIndex < metaObject->methodCount(); ++methodIndex) {
+        if(metaObject->method(methodIndex).methodType() == QMetaMethod::Signal) {
+            methodIndexes.append(methodIndex);
+        }
+    }
+    return methodIndexes;
+}
+
+const QMetaObject* QSignalCounter::Count::getMetaObject() const {
+    return _metaObject;
+}
+
+int QSignalCounter::Count::getSignalIndex() const {
+    return _signalIndex;
+}
+
+int QSignalCounter::Count::getMethodIndex() const {
+    return _methodIndex;
+}
+
+QMetaMethod QSignalCounter::Count::getMetaMethod() const {
+    return _metaObject->method(_methodIndex);
+}
+
+quint64 QSignalCounter::Count::getEmissionCount() const {
+    return _emissionCount;
+}
+
+quint64 QSignalCounter::Count::getSlotCallCount() const {
+    return _slotCallCount;
+}
+
+QSignalCounter::QSignalCounter(QObject* parent)
+    : QSignalSlotMonitor(parent)
+    , _id(nextId.fetchAndAddOrdered(1) + 1)
+    , _cache()
+    , _mutex()
+    , _tables() {
+}
+
+QSignalCounter::~QSignalCounter() {
+    disableMonitor();
+}
+
+QVector<QSignalCounter::Count> QSignalCounter::getCounts() const {
+    QSignalCounterTable::Totals totals;
+    {
+        QMutexLocker locker(&_mutex);
+        for(const QSharedPointer<QSignalCounterTable>& table : _tables) {
+            table->collect(totals);
+        }
+    }
+    QHash<const QMetaObject*, QVector<int>> methodIndexes;
+    QVector<Count> counts;
+    counts.reserve(totals.count());
+    for(auto iter = totals.constBegin(); iter != totals.constEnd(); ++iter) {
+        const QMetaObject* const metaObject = iter.key().first;
+        QVector<int>& indexes = methodIndexes[metaObject];
+        if(indexes.isEmpty()) {
+            indexes = getMethodIndexes(metaObject);
+        }
+        Count count;
+        count._metaObject = metaObject;
+        count._signalIndex = iter.key().second;
+        count._methodIndex = indexes.value(count._signalIndex, -1);
+        count._emissionCount = iter.value().first;
+        count._slotCallCount = iter.value().second;
+        counts.append(count);
+    }
+    std::sort(counts.begin(), counts.end(), [] (const Count& a, const Count& b) {
+        return a._emissionCount != b._emissionCount
+                ? a._emissionCount > b._emissionCount
+                : a._slotCallCount > b._slotCallCount;
+    });
+    return counts;
+}
+
+void QSignalCounter::clear() {
+    QMutexLocker locker(&_mutex);
+    _tables.clear();
+    _id.storeRelease(nextId.fetchAndAddOrdered(1) + 1);
+}
+
+inline QSignalCounterTable& QSignalCounter::getTable() {
+    if(! _cache.hasLocalData()) {
+        const Cache cache = { 0, QSharedPointer<QSignalCounterTable>() };
+        _cache.setLocalData(cache);
+    }
+    Cache& cache = _cache.localData();
+    if(cache.id != _id.loadAcquire()) {
+        return findTable(cache);
+    }
+    return *cache.table;
+}
+
+void QSignalCounter::signalBegin(const SignalInfo& signalInfo) {
+    QSignalCounterTable::Counters* const counters = getTable().getCounters(
+                signalInfo.getSignaler()->metaObject(), signalInfo.getSignalIndex());
+    if(counters) {
+        QSignalCounterTable::increment(counters->emissionCount);
+    }
+}
+
+void QSignalCounter::slotBegin(const SignalInfo& signalInfo, const SlotInfo& slotInfo) {
+    Q_UNUSED(slotInfo);
+    QSignalCounterTable::Counters* const counters = getTable().getCounters(
+                signalInfo.getSignaler()->metaObject(), signalInfo.getSignalIndex());
+    if(counters) {
+        QSignalCounterTable::increment(counters->slotCallCount);
+    }
+}
+
+QSignalCounterTable& QSignalCounter::findTable(Cache& cache) {
+    QMutexLocker locker(&_mutex);
+    QSharedPointer<QSignalCounterTable>& table = _tables[QThread::currentThreadId()];
+    if(! table) {
+        table.reset(new QSignalCounterTable());
+    }
+    cache.id = _id.loadAcquire();
+    cache.table = table;
+    return *table;
+}
@@ -0,0 +1,158 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#ifndef QSIGNALCOUNTER_H
+#define QSIGNALCOUNTER_H
+
+#include "QSignalSlotMonitor.h"
+
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QThreadStorage>
+
+class QSignalCounterTable;
+
+class QSignalCounter : public QSignalSlotMonitor {
+    Q_OBJECT
+
+public:
+
+    class Count {
+
+        friend class QSignalCounter;
+        template <typename T> friend class QVector;
+
+    public:
+
+        /**
+         * @brief Returns the signaler's meta object.
+         * @return
+         */
+        const QMetaObject* getMetaObject() const;
+
+        /**
+         * @brief Returns the signal's index.
+         * @return
+         */
+        int getSignalIndex() const;
+
+        /**
+         * @brief Returns the signal's method index.
+         * @return
+         */
+        int getMethodIndex() const;
+
+        /**
+         * @brief Returns the signal's meta method.
+         * @return
+         */
+        QMetaMethod getMetaMethod() const;
+
+        /**
+         * @brief Returns the number of times the signal was emited.
+         * @return
+         */
+        quint64 getEmissionCount() const;
+
+        /**
+         * @brief Returns the number of slots called by the signal.
+         * @return
+         */
+        quint64 getSlotCallCount() const;
+
+    private:
+
+        /**
+         * @brief Default constructor needed by QVector<Count>.
+         */
+        Count() = default;
+
+        const QMetaObject* _metaObject;
+        int _signalIndex;
+        int _methodIndex;
+        quint64 _emissionCount;
+        quint64 _slotCallCount;
+    };
+
+    /**
+     * @brief Constructor.
+     * @param parent
+     * @note The counter must be enabled with enableMonitor() to start counting.
+     */
+    explicit QSignalCounter(QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor.
+     * @note Disables the monitor.
+     */
+    ~QSignalCounter();
+
+    /**
+     * @brief Returns the counts of all the threads merged, for each signal
+     *        emited, ordered by number of emissions, most emited first.
+     * @note The counts being incremented by other threads while the report is
+     *       built may or may not be included.
+     * @return
+     */
+    QVector<Count> getCounts() const;
+
+    /**
+     * @brief Resets all the counts to zero.
+     * @note The counts being incremented by other threads while the counts are
+     *       reset may be lost.
+     */
+    void clear();
+
+private:
+
+    /**
+     * @brief The table last used by a thread and the id of the tables it
+     *        belongs to.
+     */
+    struct Cache {
+        int id;
+        QSharedPointer<QSignalCounterTable> table;
+    };
+
+    virtual void signalBegin(const SignalInfo& signalInfo) override;
+    virtual void slotBegin(const SignalInfo& signalInfo, const SlotInfo& slotInfo) override;
+
+    /**
+     * @brief Returns the calling thread's table of counters.
+     */
+    QSignalCounterTable& getTable();
+
+    /**
+     * @brief Returns the calling thread's table of counters, creating it if
+     *        needed, and stores it in the thread's cache.
+     */
+    QSignalCounterTable& findTable(Cache& cache);
+
+    /** @brief Identifies the current tables, changed by clear(). */
+    QAtomicInt _id;
+    QThreadStorage<Cache> _cache;
+    mutable QMutex _mutex;
+    QHash<Qt::HANDLE, QSharedPointer<QSignalCounterTable>> _tables;
+
+};
+
+#endif // QSIGNALCOUNTER_H
@@ -22,6 +22,249 @@
 #include <QIODevice>
 #include <QByteArray>
 #include <QDebug>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <utility>
+
+/**
+ * @brief Everything needed to dump a received signal.
+ */
+struct QSignalDumperRecord {
+    uint flags;
+    QByteArray marker;
+    QIODevice* targetQIODevice;
+    QByteArray* targetQByteArray;
+    const void* signalerAddress;
+    QString signalerObjectName;
+    const QMetaObject* metaObject;
+    QMetaMethod metaMethod;
+    QVector<QVariant> parameters;
+    /** @brief The line already stringified, without the marker, if not empty. */
+    QByteArray line;
+
+    inline bool isEnabled(QSignalDumper::Flag flag) const {
+        return (flags & static_cast<uint>(flag)) != 0;
+    }
+};
+
+/**
+ * @brief Returns true if the given value is, or contains, a pointer to a QObject.
+ */
+static bool containsQObject(const QVariant& value) {
+    const int typeId = value.userType();
+    if(QMetaType::typeFlags(typeId) & QMetaType::PointerToQObject) {
+        return true;
+    }
+    if(typeId == QMetaType::QVariantList) {
+        for(const QVariant& item : value.toList()) {
+            if(containsQObject(item)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Appends the line for the given record to the given buffer, in UTF-8,
+ *        without the marker and the line terminator.
+ * @note The line is stringified directly into the buffer, without a QString.
+ */
+static void stringifyRecord(QMethodStringifier& methodStringifier
+                            , const QSignalDumperRecord& record, QByteArray& buffer) {
+    static const QVector<QVariant> noParameters;
+    if(! record.line.isEmpty()) {
+        buffer.append(record.line);
+        return;
+    }
+    methodStringifier.stringify(record.signalerAddress
+                                , record.signalerObjectName
+                                , record.metaObject
+                                , record.metaMethod
+                                , record.isEnabled(QSignalDumper::Flag::Parameters)
+                                ? record.parameters : noParameters
+                                , buffer);
+}
+
+/**
+ * @brief Appends the line for the given record to the given buffer, in UTF-8,
+ *        with the line terminator, and outputs it to qDebug if that target is
+ *        enabled.
+ */
+static void dumpRecord(QMethodStringifier& methodStringifier
+                       , const QSignalDumperRecord& record, QByteArray& buffer) {
+    if(record.isEnabled(QSignalDumper::Flag::Marker)) {
+        buffer.append(record.marker);
+    }
+    stringifyRecord(methodStringifier, record, buffer);
+    if(record.isEnabled(QSignalDumper::Flag::TargetQDebug)) {
+        qDebug(buffer.data());
+    }
+    buffer.append('\n');
+}
+
+/**
+ * @brief Thread that writes the records queued by a QSignalDumper in Async mode.
+ */
+class QSignalDumperWriter : public QThread {
+
+public:
+
+    QSignalDumperWriter(int capacity, QSignalDumper::QueueFullPolicy policy)
+        : _capacity(capacity)
+        , _policy(policy)
+        , _stopping(false)
+        , _busy(false) {
+        _queue.reserve(capacity);
+    }
+
+    enum class Result {
+        Queued,     ///< The record was queued.
+        Dropped,    ///< The record was dropped because the queue was full.
+        Stopped     ///< The writer is stopped and has written its last record.
+    };
+
+    /**
+     * @brief Queues the given record.
+     * @note Once the writer is stopping no more records are queued. This
+     *       function then waits for the queued records to be written, so the
+     *       caller can write the record itself, in order.
+     */
+    Result enqueue(QSignalDumperRecord&& record) {
+        const bool isWriterThread = QThread::currentThread() == this;
+        _mutex.lock();
+        while(! _stopping && _queue.size() >= _capacity) {
+            // Never block the writer thread itself, e.g. on signals emitted
+            // by the targets while being written.
+            if(_policy == QSignalDumper::QueueFullPolicy::Drop || isWriterThread) {
+                _mutex.unlock();
+                return Result::Dropped;
+            }
+            _notFull.wait(&_mutex);
+        }
+        if(_stopping) {
+            _mutex.unlock();
+            if(! isWriterThread) {
+                wait();
+            }
+            return Result::Stopped;
+        }
+        _queue.append(std::move(record));
+        _notEmpty.wakeOne();
+        _mutex.unlock();
+        return Result::Queued;
+    }
+
+    /**
+     * @brief Waits until all the queued records are written.
+     */
+    void flush() {
+        QMutexLocker locker(&_mutex);
+        while(! _queue.isEmpty() || _busy) {
+            _drained.wait(&_mutex);
+        }
+    }
+
+    /**
+     * @brief Writes the queued records and stops the thread.
+     */
+    void stop() {
+        _mutex.lock();
+        _stopping = true;
+        _notEmpty.wakeOne();
+        _notFull.wakeAll();
+        _mutex.unlock();
+        wait();
+    }
+
+protected:
+
+    virtual void run() override {
+        QMethodStringifier methodStringifier;
+        QVector<QSignalDumperRecord> batch;
+        batch.reserve(_capacity);
+        QByteArray line;
+        line.reserve(4096);
+        QByteArray deviceBatch;
+        QByteArray byteArrayBatch;
+        QIODevice* device = nullptr;
+        QByteArray* byteArray = nullptr;
+        forever {
+            _mutex.lock();
+            while(_queue.isEmpty() && ! _stopping) {
+                _notEmpty.wait(&_mutex);
+            }
+            if(_queue.isEmpty()) {
+                _mutex.unlock();
+                return;
+            }
+            batch.swap(_queue);
+            _busy = true;
+            _notFull.wakeAll();
+            _mutex.unlock();
+
+            for(const QSignalDumperRecord& record : batch) {
+                dumpRecord(methodStringifier, record, line);
+                if(record.isEnabled(QSignalDumper::Flag::TargetQIODevice)
+                   && record.targetQIODevice) {
+                    if(record.targetQIODevice != device) {
+                        writeBatch(device, deviceBatch);
+                        device = record.targetQIODevice;
+                    }
+                    deviceBatch.append(line);
+                }
+                if(record.isEnabled(QSignalDumper::Flag::TargetQByteArray)
+                   && record.targetQByteArray) {
+                    if(record.targetQByteArray != byteArray) {
+                        writeBatch(byteArray, byteArrayBatch);
+                        byteArray = record.targetQByteArray;
+                    }
+                    byteArrayBatch.append(line);
+                }
+                line.truncate(0);
+            }
+            writeBatch(device, deviceBatch);
+            writeBatch(byteArray, byteArrayBatch);
+            device = nullptr;
+            byteArray = nullptr;
+            batch.clear();
+
+            _mutex.lock();
+            _busy = false;
+            _drained.wakeAll();
+            _mutex.unlock();
+        }
+    }
+
+private:
+
+    static void writeBatch(QIODevice* device, QByteArray& batch) {
+        if(device && ! batch.isEmpty()) {
+            device->write(batch);
+        }
+        batch.truncate(0);
+    }
+
+    static void writeBatch(QByteArray* byteArray, QByteArray& batch) {
+        if(byteArray && ! batch.isEmpty()) {
+            byteArray->append(batch);
+        }
+        batch.truncate(0);
+    }
+
+    const int _capacity;
+    const QSignalDumper::QueueFullPolicy _policy;
+    QMutex _mutex;
+    QWaitCondition _notEmpty;
+    QWaitCondition _notFull;
+    QWaitCondition _drained;
+    QVector<QSignalDumperRecord> _queue;
+    bool _stopping;
+    bool _busy;
+
+};
 
 QSignalDumper::QSignalDumper(QObject* parent)
     : QUniversalSlot(parent)
@@ -32,10 +275,18 @@ QSignalDumper::QSignalDumper(QObject* parent)
     , _targetQIODevice(nullptr)
     , _methodStringifier()
     , _buffer()
-    , _marker(QByteArrayLiteral("[QSignalDumper] ")) {
+    , _marker(QByteArrayLiteral("[QSignalDumper] "))
+    , _writer(nullptr)
+    , _writerUsers(0)
+    , _asyncQueueCapacity(1024)
+    , _queueFullPolicy(QueueFullPolicy::Block)
+    , _droppedCount(0) {
     _buffer.reserve(4096);
 }
 
+QSignalDumper::~QSignalDumper() {
+    stopWriter();
+}
 QIODevice* QSignalDumper::getTargetQIODevice() const {
     return _targetQIODevice;
 }
@@ -60,12 +311,54 @@ void QSignalDumper::setMarker(const QByteArray& marker) {
     _marker = marker;
 }
 
+int QSignalDumper::getAsyncQueueCapacity() const {
+    return _asyncQueueCapacity;
+}
+
+void QSignalDumper::setAsyncQueueCapacity(int capacity) {
+    Q_ASSERT(capacity > 0);
+    _asyncQueueCapacity = capacity;
+    if(_writer.load()) {
+        stopWriter();
+        startWriter();
+    }
+}
+
+QSignalDumper::QueueFullPolicy QSignalDumper::getQueueFullPolicy() const {
+    return _queueFullPolicy;
+}
+
+void QSignalDumper::setQueueFullPolicy(QSignalDumper::QueueFullPolicy policy) {
+    _queueFullPolicy = policy;
+    if(_writer.load()) {
+        stopWriter();
+        startWriter();
+    }
+}
+
+int QSignalDumper::getDroppedCount() const {
+    return _droppedCount.load();
+}
+
+void QSignalDumper::flush() {
+    QSignalDumperWriter* const writer = _writer.loadAcquire();
+    if(writer) {
+        writer->flush();
+    }
+}
+
 void QSignalDumper::enable(QSignalDumper::Flag flag) {
     _flags |= static_cast<uint>(flag);
+    if(flag == Flag::Async) {
+        startWriter();
+    }
 }
 
 void QSignalDumper::disable(QSignalDumper::Flag flag) {
     _flags &= ~static_cast<uint>(flag);
+    if(flag == Flag::Async) {
+        stopWriter();
+    }
 }
 
 bool QSignalDumper::isEnabled(QSignalDumper::Flag flag) const {
@@ -80,21 +373,43 @@ void QSignalDumper::universal(QObject* signaler
                               , const QMetaMethod& signalMetaMethod
                               , const QVector<QVariant>& parameters) {
     if(isEnabled(Flag::Dump)) {
-        if(isEnabled(Flag::Marker)) {
-            _buffer.append(_marker);
+        QSignalDumperRecord record{
+            _flags,
+            _marker,
+            _targetQIODevice,
+            _targetQByteArray,
+            signaler,
+            signaler->objectName(),
+            signaler->metaObject(),
+            signalMetaMethod,
+            isEnabled(Flag::Parameters) ? parameters : QVector<QVariant>(),
+            QByteArray()
+        };
+        // stopWriter() waits for the users to drop to zero before deleting the
+        // writer they may have loaded.
+        _writerUsers.ref();
+        QSignalDumperWriter* const writer = _writer.loadAcquire();
+        if(writer) {
+            // The objects pointed to by the parameters may be deleted before
+            // the writer thread gets to them, so stringify them now.
+            for(const QVariant& parameter : record.parameters) {
+                if(containsQObject(parameter)) {
+                    stringifyRecord(_methodStringifier, record, record.line);
+                    record.parameters.clear();
+                    break;
+                }
+            }
+            const QSignalDumperWriter::Result result = writer->enqueue(std::move(record));
+            if(result != QSignalDumperWriter::Result::Stopped) {
+                if(result == QSignalDumperWriter::Result::Dropped) {
+                    _droppedCount.ref();
+                }
+                _writerUsers.deref();
+                return;
+            }
         }
-        _buffer.append(_methodStringifier
-                      .stringify(signaler
-                                 , signaler->objectName()
-                                 , signaler->metaObject()
-                                 , signalMetaMethod
-                                 , isEnabled(Flag::Parameters)
-                                 ? parameters : QVector<QVariant>())
-                      .toLocal8Bit());
-        if(isEnabled(Flag::TargetQDebug)) {
-            qDebug(_buffer.data());
-        }
-        _buffer.append('\n');
+        _writerUsers.deref();
+        dumpRecord(_methodStringifier, record, _buffer);
         if(isEnabled(Flag::TargetQIODevice) && _targetQIODevice) {
             _targetQIODevice->write(_buffer);
         }
@@ -104,3 +419,24 @@ void QSignalDumper::universal(QObject* signaler
         _buffer.truncate(0);
     }
 }
+
+void QSignalDumper::startWriter() {
+    if(! _writer.load()) {
+        QSignalDumperWriter* const writer
+                = new QSignalDumperWriter(_asyncQueueCapacity, _queueFullPolicy);
+        writer->start();
+        _writer.storeRelease(writer);
+    }
+}
+
+void QSignalDumper::stopWriter() {
+    QSignalDumperWriter* const writer = _writer.fetchAndStoreOrdered(nullptr);
+    if(writer) {
+        writer->stop();
+        // Wait for the threads that loaded the writer before it was cleared.
+        while(_writerUsers.fetchAndAddOrdered(0) != 0) {
+            QThread::yieldCurrentThread();
+        }
+        delete writer;
+    }
+}
@@ -23,6 +23,10 @@
 #include "QMethodStringifier.h"
 
 #include <QIODevice>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+
+class QSignalDumperWriter;
 
 class QSignalDumper : public QUniversalSlot {
     Q_OBJECT
@@ -36,6 +40,13 @@ public:
      */
     explicit QSignalDumper(QObject* parent = nullptr);
 
+    /**
+     * @brief Destructor.
+     * @note If the Async flag is enabled, waits for the queued signals to be
+     *       written.
+     */
+    ~QSignalDumper();
+
     /**
      * @brief Returns a pointer to the current QIODevice target.
      *        Default is nullptr.
@@ -75,8 +86,65 @@ public:
      */
     void setMarker(const QByteArray& marker);
 
+    /**
+     * @brief What to do when a signal is received in Async mode and the queue
+     *        is full.
+     */
+    enum class QueueFullPolicy {
+        Block,  ///< Wait for the writer thread to make room in the queue.
+        Drop,   ///< Drop the signal.
+    };
+
+    /**
+     * @brief Returns the maximum number of signals waiting to be written in
+     *        Async mode. Default is 1024.
+     * @return
+     */
+    int getAsyncQueueCapacity() const;
+
+    /**
+     * @brief Sets the maximum number of signals waiting to be written in Async
+     *        mode.
+     * @param capacity Must be greater than zero.
+     */
+    void setAsyncQueueCapacity(int capacity);
+
+    /**
+     * @brief Returns the policy for when the Async mode queue is full.
+     *        Default is QueueFullPolicy::Block.
+     * @return
+     */
+    QueueFullPolicy getQueueFullPolicy() const;
+
+    /**
+     * @brief Sets the policy for when the Async mode queue is full.
+     * @param policy
+     */
+    void setQueueFullPolicy(QueueFullPolicy policy);
+
+    /**
+     * @brief Returns the number of signals dropped because the Async mode queue
+     *        was full.
+     * @return
+     */
+    int getDroppedCount() const;
+
+    /**
+     * @brief In Async mode, waits until all the queued signals are written.
+     *        Does nothing otherwise.
+     * @note After this function returns and until more signals are received,
+     *       the QByteArray and QIODevice targets can be safely accessed.
+     */
+    void flush();
+
     /**
      * @brief Flags to control QSignalDumper's behaviour.
+     * @note With the Async flag enabled, the receiving thread only queues the
+     *       signal and a dedicated writer thread stringifies it and writes it
+     *       to the targets, in batches. While it is enabled, the targets must
+     *       only be accessed after calling flush(). Signals with parameters
+     *       that point to QObjects are stringified when received, since the
+     *       objects may be deleted before the writer thread gets to them.
      */
     enum class Flag {
         Dump = 1,
@@ -85,6 +153,7 @@ public:
         TargetQByteArray = 8,
         TargetQDebug = 16,
         Marker = 32,
+        Async = 64,
     };
 
     /**
@@ -128,12 +197,27 @@ private:
     virtual void universal(QObject* signaler, const QMetaMethod& signalMetaMethod
                            , const QVector<QVariant>& parameters) override;
 
+    /**
+     * @brief Starts the writer thread for the Async mode.
+     */
+    void startWriter();
+
+    /**
+     * @brief Stops the writer thread, after the queued signals are written.
+     */
+    void stopWriter();
+
     uint _flags;
     QByteArray* _targetQByteArray;
     QIODevice* _targetQIODevice;
     QMethodStringifier _methodStringifier;
     QByteArray _buffer;
     QByteArray _marker;
+    QAtomicPointer<QSignalDumperWriter> _writer;
+    QAtomicInt _writerUsers;
+    int _asyncQueueCapacity;
+    QueueFullPolicy _queueFullPolicy;
+    QAtomicInt _droppedCount;
 
 };
 
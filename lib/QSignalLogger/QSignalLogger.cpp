@@ -17,11 +17,514 @@
 ** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
 *******************************************************************************/
 #include "QSignalLogger.h"
+#include "QValueSerializer.h"
+#include "QSignalCaptureReader.h"
+
+#include <QFile>
+#include <QMutex>
+#include <QAtomicPointer>
+#include <QHash>
+#include <QSet>
+#include <QPair>
+#include <QDateTime>
+
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+/**
+ * @brief Fixed layout header of the ring buffer records.
+ *        The serialized parameters follow the header.
+ */
+struct RecordHeader {
+    quint32 size;
+    qint32 methodIndex;
+    qint64 timestamp;
+    const void* signalerAddress;
+    const QMetaObject* metaObject;
+};
+
+/**
+ * @brief Key of the interned sources.
+ */
+struct QSignalLoggerSourceKey {
+    const void* signalerAddress;
+    const QMetaObject* metaObject;
+    int methodIndex;
+    QString objectName;
+
+    bool operator==(const QSignalLoggerSourceKey& other) const {
+        return signalerAddress == other.signalerAddress && metaObject == other.metaObject
+                && methodIndex == other.methodIndex && objectName == other.objectName;
+    }
+};
+
+inline uint qHash(const QSignalLoggerSourceKey& key, uint seed = 0) {
+    return qHash(key.signalerAddress, seed) ^ qHash(key.methodIndex, seed)
+            ^ qHash(key.objectName, seed);
+}
+
+/**
+ * @brief Process wide store of the signalers, object names and signals of the
+ *        log entries, which only keep the id of their source.
+ * @details Sources are appended under a lock and never move nor are removed,
+ *          so they are read without locking and the entries stay valid after
+ *          their logger is cleared or destroyed. A source is only shared by
+ *          the signals of the same signaler while it keeps its object name.
+ */
+class QSignalLoggerSources {
+
+public:
+
+    struct Source {
+        QPointer<QObject> signaler;
+        const void* signalerAddress;
+        QString objectName;
+        const QMetaObject* metaObject;
+        QMetaMethod metaMethod;
+    };
+
+    static QSignalLoggerSources& instance() {
+        // Never destroyed, so entries in static storage stay valid at exit.
+        static QSignalLoggerSources* const sources = new QSignalLoggerSources();
+        return *sources;
+    }
+
+    const Source& at(quint32 id) const {
+        Q_ASSERT(id < CHUNK_SIZE * MAX_CHUNKS);
+        return _chunks[id / CHUNK_SIZE].loadAcquire()[id % CHUNK_SIZE];
+    }
+
+    /**
+     * @brief Returns the id of the source of the given signal, interning it
+     *        if needed.
+     * @return Returns 0, an empty source, if the store is full.
+     */
+    quint32 intern(QObject* signaler, const QString& objectName, const QMetaMethod& metaMethod) {
+        const QSignalLoggerSourceKey key = {
+            signaler, signaler->metaObject(), metaMethod.methodIndex(), objectName
+        };
+        QMutexLocker locker(&_mutex);
+        const auto it = _ids.constFind(key);
+        // A destroyed signaler's source is not reused by a new object at its
+        // address.
+        if(it != _ids.constEnd() && at(it.value()).signaler.data() == signaler) {
+            return it.value();
+        }
+        if(_size == CHUNK_SIZE * MAX_CHUNKS) {
+            if(! _full) {
+                _full = true;
+                qWarning("QSignalLogger: the store of the signals' sources is full.");
+            }
+            return 0;
+        }
+        const Source source = {signaler, signaler, objectName, key.metaObject, metaMethod};
+        const quint32 id = append(source);
+        _ids.insert(key, id);
+        return id;
+    }
+
+private:
+
+    static const quint32 CHUNK_SIZE = 1024;
+    static const quint32 MAX_CHUNKS = 16384;
+
+    QSignalLoggerSources()
+        : _mutex()
+        , _ids()
+        , _size(0)
+        , _full(false) {
+        // Id 0 is the empty source.
+        const Source source = {QPointer<QObject>(), nullptr, QString(), nullptr, QMetaMethod()};
+        append(source);
+    }
+
+    quint32 append(const Source& source) {
+        Source* chunk = _chunks[_size / CHUNK_SIZE].load();
+        if(! chunk) {
+            chunk = new Source[CHUNK_SIZE];
+            _chunks[_size / CHUNK_SIZE].storeRelease(chunk);
+        }
+        chunk[_size % CHUNK_SIZE] = source;
+        return _size++;
+    }
+
+    QMutex _mutex;
+    QHash<QSignalLoggerSourceKey, quint32> _ids;
+    /** @brief Chunks of CHUNK_SIZE sources, so they never move. */
+    QAtomicPointer<Source> _chunks[MAX_CHUNKS];
+    quint32 _size;
+    bool _full;
+};
+
+/**
+ * @brief Writes the signals to the memory mapped segments of a capture file.
+ *        See QSignalCaptureReader for the file format.
+ */
+class QSignalCaptureWriter {
+
+public:
+
+    typedef QSignalCaptureReader::FileHeader FileHeader;
+    typedef QSignalCaptureReader::RecordHeader RecordHeader;
+    typedef QSignalCaptureReader::StringRecord StringRecord;
+    typedef QSignalCaptureReader::TypeRecord TypeRecord;
+    typedef QSignalCaptureReader::EventRecord EventRecord;
+
+    QSignalCaptureWriter(const QString& filePath, qint64 segmentSize)
+        : _filePath(filePath)
+        , _segmentSize(segmentSize)
+        , _file()
+        , _data(nullptr)
+        , _used(0)
+        , _segmentIndex(0)
+        , _startTime(QDateTime::currentMSecsSinceEpoch())
+        , _timer()
+        , _eventCount(0)
+        , _droppedCount(0)
+        , _internFailed(false)
+        , _nextStringId(1) {
+        Q_ASSERT(_segmentSize > static_cast<qint64>(sizeof(FileHeader)));
+        _parameters.reserve(1024);
+        _timer.start();
+    }
+
+    ~QSignalCaptureWriter() {
+        closeSegment();
+    }
+
+    const QString& getFilePath() const {
+        return _filePath;
+    }
+
+    qint64 getEventCount() const {
+        return _eventCount;
+    }
+
+    qint64 getDroppedCount() const {
+        return _droppedCount;
+    }
+
+    bool open() {
+        return openSegment(0);
+    }
+
+    void writeEvent(QObject* signaler, const QMetaMethod& signalMetaMethod
+                    , const QVector<QVariant>& parameters) {
+        if(! _data) {
+            ++_droppedCount;
+            return;
+        }
+        const qint64 timestamp = _timer.nsecsElapsed();
+        _parameters.clear();
+        for(const QVariant& parameter : parameters) {
+            QValueSerializer::serialize(parameter, _parameters);
+        }
+        const quint32 size = static_cast<quint32>(sizeof(EventRecord)) + _parameters.size();
+        if(alignedSize(size) > _segmentSize - static_cast<qint64>(sizeof(FileHeader))) {
+            ++_droppedCount;
+            return;
+        }
+        const QMetaObject* const metaObject = signaler->metaObject();
+        // Interning may fill the segment and start a new one, where the ids of
+        // the previous segment are not valid, so try again in the new segment
+        // until one holds the strings and the record.
+        const int firstSegmentIndex = _segmentIndex;
+        for(;;) {
+            const int segmentIndex = _segmentIndex;
+            _internFailed = false;
+            EventRecord record;
+            std::memset(&record, 0, sizeof(record));
+            record.header.size = alignedSize(size);
+            record.header.kind = QSignalCaptureReader::EventKind;
+            record.timestamp = timestamp;
+            record.signalerAddress = static_cast<quint64>(reinterpret_cast<quintptr>(signaler));
+            record.classNameId = internClassName(metaObject);
+            record.signatureId = internSignature(metaObject, signalMetaMethod);
+            record.objectNameId = internObjectName(signaler->objectName());
+            record.methodIndex = signalMetaMethod.methodIndex();
+            record.parametersSize = static_cast<quint32>(_parameters.size());
+            for(const QVariant& parameter : parameters) {
+                internType(parameter.userType());
+            }
+            uchar* const data = _internFailed ? nullptr : reserve(size);
+            if(! data) {
+                ++_droppedCount;
+                return;
+            }
+            if(segmentIndex != _segmentIndex) {
+                // A segment started for this signal only holds its strings, so
+                // if it is also filled the signal never fits in a segment.
+                if(segmentIndex != firstSegmentIndex) {
+                    ++_droppedCount;
+                    return;
+                }
+                continue;
+            }
+            std::memcpy(data, &record, sizeof(record));
+            std::memcpy(data + sizeof(record), _parameters.constData(), _parameters.size());
+            commit(size);
+            ++_eventCount;
+            return;
+        }
+    }
+
+private:
+
+    static quint32 alignedSize(quint32 size) {
+        const quint32 alignment = QSignalCaptureReader::RECORD_ALIGNMENT;
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    bool openSegment(int segmentIndex) {
+        Q_ASSERT(! _data);
+        _segmentIndex = segmentIndex;
+        _file.setFileName(QSignalCaptureReader::segmentFilePath(_filePath, segmentIndex));
+        if(! _file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+            return false;
+        }
+        if(! _file.resize(_segmentSize)) {
+            _file.close();
+            return false;
+        }
+        _data = _file.map(0, _segmentSize);
+        if(! _data) {
+            _file.close();
+            return false;
+        }
+        FileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        header.magic = QSignalCaptureReader::MAGIC;
+        header.version = QSignalCaptureReader::VERSION;
+        header.headerSize = static_cast<quint32>(sizeof(header));
+        header.segmentIndex = static_cast<quint32>(segmentIndex);
+        header.usedSize = sizeof(header);
+        header.startTime = _startTime;
+        std::memcpy(_data, &header, sizeof(header));
+        _used = sizeof(header);
+        return true;
+    }
+
+    void closeSegment() {
+        if(_data) {
+            _file.unmap(_data);
+            _data = nullptr;
+            _file.resize(_used);
+        }
+        _file.close();
+        _used = 0;
+        _nextStringId = 1;
+        _stringIds.clear();
+        _classNameIds.clear();
+        _signatureIds.clear();
+        _objectNameIds.clear();
+        _typeIds.clear();
+    }
+
+    /**
+     * @brief Returns where to write a record of the given size, starting the
+     *        next segment if the current one is full.
+     * @return Returns nullptr if no segment could be created or if the record
+     *         does not fit in a segment.
+     */
+    uchar* reserve(quint32 size) {
+        if(! _data || alignedSize(size) > _segmentSize - static_cast<qint64>(sizeof(FileHeader))) {
+            return nullptr;
+        }
+        if(_used + alignedSize(size) > _segmentSize) {
+            closeSegment();
+            if(! openSegment(_segmentIndex + 1)) {
+                return nullptr;
+            }
+        }
+        return _data + _used;
+    }
+
+    /**
+     * @brief Pads the record written at the reserved space and publishes it
+     *        in the segment's header.
+     */
+    void commit(quint32 size) {
+        const quint32 recordSize = alignedSize(size);
+        std::memset(_data + _used + size, 0, recordSize - size);
+        _used += recordSize;
+        const quint64 usedSize = static_cast<quint64>(_used);
+        std::memcpy(_data + offsetof(FileHeader, usedSize), &usedSize, sizeof(usedSize));
+    }
+
+    quint32 internString(const QByteArray& string) {
+        if(string.isEmpty()) {
+            return 0;
+        }
+        const auto it = _stringIds.constFind(string);
+        if(it != _stringIds.constEnd()) {
+            return it.value();
+        }
+        const quint32 size = static_cast<quint32>(sizeof(StringRecord)) + string.size();
+        uchar* const data = reserve(size);
+        if(! data) {
+            _internFailed = true;
+            return 0;
+        }
+        StringRecord record;
+        record.header.size = alignedSize(size);
+        record.header.kind = QSignalCaptureReader::StringKind;
+        record.id = _nextStringId++;
+        record.length = static_cast<quint32>(string.size());
+        std::memcpy(data, &record, sizeof(record));
+        std::memcpy(data + sizeof(record), string.constData(), string.size());
+        commit(size);
+        _stringIds.insert(string, record.id);
+        return record.id;
+    }
+
+    quint32 internClassName(const QMetaObject* metaObject) {
+        const auto it = _classNameIds.constFind(metaObject);
+        if(it != _classNameIds.constEnd()) {
+            return it.value();
+        }
+        const quint32 id = internString(QByteArray(metaObject->className()));
+        if(id != 0) {
+            _classNameIds.insert(metaObject, id);
+        }
+        return id;
+    }
+
+    quint32 internSignature(const QMetaObject* metaObject, const QMetaMethod& metaMethod) {
+        const QPair<const QMetaObject*, int> key(metaObject, metaMethod.methodIndex());
+        const auto it = _signatureIds.constFind(key);
+        if(it != _signatureIds.constEnd()) {
+            return it.value();
+        }
+        const quint32 id = internString(metaMethod.methodSignature());
+        if(id != 0) {
+            _signatureIds.insert(key, id);
+        }
+        return id;
+    }
+
+    quint32 internObjectName(const QString& objectName) {
+        if(objectName.isEmpty()) {
+            return 0;
+        }
+        const auto it = _objectNameIds.constFind(objectName);
+        if(it != _objectNameIds.constEnd()) {
+            return it.value();
+        }
+        const quint32 id = internString(objectName.toUtf8());
+        if(id != 0) {
+            _objectNameIds.insert(objectName, id);
+        }
+        return id;
+    }
+
+    /**
+     * @brief Writes the name of user types, whose ids are not the same in
+     *        other processes.
+     */
+    void internType(int typeId) {
+        if(typeId < QMetaType::User || _typeIds.contains(typeId)) {
+            return;
+        }
+        const int segmentIndex = _segmentIndex;
+        TypeRecord record;
+        record.header.size = alignedSize(sizeof(record));
+        record.header.kind = QSignalCaptureReader::TypeKind;
+        record.typeId = typeId;
+        record.nameId = internString(QByteArray(QMetaType::typeName(typeId)));
+        if(_internFailed) {
+            return;
+        }
+        uchar* const data = reserve(sizeof(record));
+        if(! data || segmentIndex != _segmentIndex) {
+            return;
+        }
+        std::memcpy(data, &record, sizeof(record));
+        commit(sizeof(record));
+        _typeIds.insert(typeId);
+    }
+
+    const QString _filePath;
+    const qint64 _segmentSize;
+    QFile _file;
+    /** @brief The mapped segment or nullptr. */
+    uchar* _data;
+    /** @brief Offset of the end of the segment's records. */
+    qint64 _used;
+    int _segmentIndex;
+    const qint64 _startTime;
+    QElapsedTimer _timer;
+    qint64 _eventCount;
+    /** @brief Signals that could not be written to any segment. */
+    qint64 _droppedCount;
+    /** @brief Buffer where the parameters are serialized. */
+    QByteArray _parameters;
+    /** @brief Set when a string of the signal being written was not written. */
+    bool _internFailed;
+
+    // The interned strings and types of the current segment.
+    quint32 _nextStringId;
+    QHash<QByteArray, quint32> _stringIds;
+    QHash<const QMetaObject*, quint32> _classNameIds;
+    QHash<QPair<const QMetaObject*, int>, quint32> _signatureIds;
+    QHash<QString, quint32> _objectNameIds;
+    QSet<int> _typeIds;
+};
 
 QSignalLogger::QSignalLogger(QObject* parent, uint reserve)
     : QUniversalSlot(parent)
-    , _log() {
+    , _log()
+    , _lastSignaler(nullptr)
+    , _lastMethodIndex(-1)
+    , _lastObjectName()
+    , _lastSourceId(0)
+    , _indexes(0)
+    , _signalerIndex()
+    , _metaObjectIndex()
+    , _signalIndex()
+    , _ring()
+    , _ringHead(0)
+    , _ringTail(0)
+    , _ringWrap(-1)
+    , _ringCount(0)
+    , _recordBuffer()
+    , _timer()
+    , _captureWriter(nullptr) {
     _log.reserve(reserve);
+    _recordBuffer.reserve(1024);
+    _timer.start();
+}
+
+QSignalLogger::~QSignalLogger() {
+    closeCaptureFile();
+}
+
+bool QSignalLogger::setCaptureFile(const QString& filePath, qint64 segmentSize) {
+    closeCaptureFile();
+    QSignalCaptureWriter* const writer = new QSignalCaptureWriter(filePath, segmentSize);
+    if(! writer->open()) {
+        delete writer;
+        return false;
+    }
+    _captureWriter = writer;
+    return true;
+}
+
+void QSignalLogger::closeCaptureFile() {
+    delete _captureWriter;
+    _captureWriter = nullptr;
+}
+
+QString QSignalLogger::getCaptureFile() const {
+    return _captureWriter ? _captureWriter->getFilePath() : QString();
+}
+
+qint64 QSignalLogger::getCapturedCount() const {
+    return _captureWriter ? _captureWriter->getEventCount() : 0;
+}
+
+qint64 QSignalLogger::getCaptureDroppedCount() const {
+    return _captureWriter ? _captureWriter->getDroppedCount() : 0;
 }
 
 const QVector<QSignalLogger::Entry>& QSignalLogger::getLog() const {
@@ -30,36 +533,262 @@ const QVector<QSignalLogger::Entry>& QSignalLogger::getLog() const {
 
 void QSignalLogger::clear() {
     _log.clear();
+    _signalerIndex.clear();
+    _metaObjectIndex.clear();
+    _signalIndex.clear();
+    _ringHead = 0;
+    _ringTail = 0;
+    _ringWrap = -1;
+    _ringCount = 0;
+}
+
+int QSignalLogger::getRingBufferCapacity() const {
+    return _ring.size();
+}
+
+void QSignalLogger::setRingBufferCapacity(int capacity) {
+    Q_ASSERT(capacity >= 0);
+    _ring = capacity > 0 ? QByteArray(capacity, '\0') : QByteArray();
+    _ringHead = 0;
+    _ringTail = 0;
+    _ringWrap = -1;
+    _ringCount = 0;
+}
+
+int QSignalLogger::getRecordCount() const {
+    return _ringCount;
+}
+
+QVector<QSignalLogger::Record> QSignalLogger::getRecords() const {
+    QVector<Record> records;
+    records.reserve(_ringCount);
+    int offset = _ringHead;
+    for(int I = 0; I < _ringCount; ++I) {
+        RecordHeader header;
+        std::memcpy(&header, _ring.constData() + offset, sizeof(header));
+        Record record;
+        record._timestamp = header.timestamp;
+        record._signalerAddress = header.signalerAddress;
+        record._metaObject = header.metaObject;
+        record._methodIndex = header.methodIndex;
+        record._parameters = QByteArray(_ring.constData() + offset + sizeof(header)
+                                        , header.size - sizeof(header));
+        records.append(record);
+        offset += header.size;
+        if(_ringWrap >= 0 && offset >= _ringWrap) {
+            offset = 0;
+        }
+    }
+    return records;
+}
+
+void QSignalLogger::enableIndex(Index index) {
+    if(isIndexEnabled(index)) {
+        return;
+    }
+    // Index the entries already in the log only in the new index.
+    const uint indexes = _indexes;
+    _indexes = static_cast<uint>(index);
+    for(int I = 0; I < _log.size(); ++I) {
+        indexEntry(I);
+    }
+    _indexes = indexes | static_cast<uint>(index);
+}
+
+void QSignalLogger::disableIndex(Index index) {
+    _indexes &= ~static_cast<uint>(index);
+    switch(index) {
+    case Index::Signaler:
+        _signalerIndex = QHash<const void*, QVector<int>>();
+        break;
+    case Index::MetaObject:
+        _metaObjectIndex = QHash<const QMetaObject*, QVector<int>>();
+        break;
+    case Index::Signal:
+        _signalIndex = QHash<QPair<const QMetaObject*, int>, QVector<int>>();
+        break;
+    }
+}
+
+bool QSignalLogger::isIndexEnabled(Index index) const {
+    return _indexes & static_cast<uint>(index);
+}
+
+template<typename PREDICATE>
+QSignalLogger::View QSignalLogger::scanLog(PREDICATE predicate) const {
+    QVector<int> positions;
+    for(int I = 0; I < _log.size(); ++I) {
+        if(predicate(_log.at(I))) {
+            positions.append(I);
+        }
+    }
+    return View(&_log, positions);
+}
+
+QSignalLogger::View QSignalLogger::getEntriesBySignaler(const void* signalerAddress) const {
+    if(isIndexEnabled(Index::Signaler)) {
+        return View(&_log, _signalerIndex.value(signalerAddress));
+    }
+    return scanLog([signalerAddress](const Entry& entry) {
+        return entry.getSignalerAddress() == signalerAddress;
+    });
 }
 
-QSignalLogger::Entry::Entry(QObject* signaler, const QMetaMethod& metaMethod
+QSignalLogger::View QSignalLogger::getEntriesByMetaObject(const QMetaObject* metaObject) const {
+    if(isIndexEnabled(Index::MetaObject)) {
+        return View(&_log, _metaObjectIndex.value(metaObject));
+    }
+    return scanLog([metaObject](const Entry& entry) {
+        return entry.getSignalerMetaObject() == metaObject;
+    });
+}
+
+QSignalLogger::View QSignalLogger::getEntriesBySignal(const QMetaMethod& signalMetaMethod) const {
+    const QMetaObject* const metaObject = signalMetaMethod.enclosingMetaObject();
+    const int methodIndex = signalMetaMethod.methodIndex();
+    if(isIndexEnabled(Index::Signal)) {
+        return View(&_log, _signalIndex.value(qMakePair(metaObject, methodIndex)));
+    }
+    return scanLog([metaObject, methodIndex](const Entry& entry) {
+        const QMetaMethod& entryMetaMethod = entry.getSignalMetaMethod();
+        return entryMetaMethod.methodIndex() == methodIndex
+                && entryMetaMethod.enclosingMetaObject() == metaObject;
+    });
+}
+
+int QSignalLogger::getSignalCount(const QMetaMethod& signalMetaMethod) const {
+    return getEntriesBySignal(signalMetaMethod).size();
+}
+
+QSignalLogger::View QSignalLogger::getEntriesInTimeWindow(qint64 from, qint64 to) const {
+    const auto first = std::lower_bound(_log.constBegin(), _log.constEnd(), from
+                                        , [](const Entry& entry, qint64 timestamp) {
+        return entry.getTimestamp() < timestamp;
+    });
+    const auto last = std::lower_bound(first, _log.constEnd(), qMax(from, to)
+                                       , [](const Entry& entry, qint64 timestamp) {
+        return entry.getTimestamp() < timestamp;
+    });
+    return View(&_log, static_cast<int>(first - _log.constBegin())
+                , static_cast<int>(last - first));
+}
+
+qint64 QSignalLogger::getElapsedTime() const {
+    return _timer.nsecsElapsed();
+}
+
+void QSignalLogger::indexEntry(int position) {
+    const Entry& entry = _log.at(position);
+    if(isIndexEnabled(Index::Signaler)) {
+        _signalerIndex[entry.getSignalerAddress()].append(position);
+    }
+    if(isIndexEnabled(Index::MetaObject)) {
+        _metaObjectIndex[entry.getSignalerMetaObject()].append(position);
+    }
+    if(isIndexEnabled(Index::Signal)) {
+        const QMetaMethod& metaMethod = entry.getSignalMetaMethod();
+        _signalIndex[qMakePair(metaMethod.enclosingMetaObject(), metaMethod.methodIndex())]
+                .append(position);
+    }
+}
+
+QSignalLogger::View::View()
+    : _log(nullptr)
+    , _positions()
+    , _first(0)
+    , _count(0) {
+}
+
+QSignalLogger::View::View(const QVector<Entry>* log, int first, int count)
+    : _log(log)
+    , _positions()
+    , _first(first)
+    , _count(count) {
+}
+
+QSignalLogger::View::View(const QVector<Entry>* log, const QVector<int>& positions)
+    : _log(log)
+    , _positions(positions)
+    , _first(-1)
+    , _count(positions.size()) {
+}
+
+int QSignalLogger::View::size() const {
+    return _count;
+}
+
+bool QSignalLogger::View::isEmpty() const {
+    return _count == 0;
+}
+
+const QSignalLogger::Entry& QSignalLogger::View::at(int position) const {
+    Q_ASSERT(position >= 0 && position < _count);
+    return _log->at(_first >= 0 ? _first + position : _positions.at(position));
+}
+
+QSignalLogger::View::const_iterator QSignalLogger::View::begin() const {
+    return const_iterator(this, 0);
+}
+
+QSignalLogger::View::const_iterator QSignalLogger::View::end() const {
+    return const_iterator(this, _count);
+}
+
+QSignalLogger::View::const_iterator::const_iterator(const View* view, int position)
+    : _view(view)
+    , _position(position) {
+}
+
+const QSignalLogger::Entry& QSignalLogger::View::const_iterator::operator*() const {
+    return _view->at(_position);
+}
+
+const QSignalLogger::Entry* QSignalLogger::View::const_iterator::operator->() const {
+    return &_view->at(_position);
+}
+
+QSignalLogger::View::const_iterator& QSignalLogger::View::const_iterator::operator++() {
+    ++_position;
+    return *this;
+}
+
+bool QSignalLogger::View::const_iterator::operator==(const const_iterator& other) const {
+    return _view == other._view && _position == other._position;
+}
+
+bool QSignalLogger::View::const_iterator::operator!=(const const_iterator& other) const {
+    return ! (*this == other);
+}
+
+QSignalLogger::Entry::Entry(qint64 timestamp, quint32 sourceId
                             , const QVector<QVariant>& parameters)
-    : _signaler(signaler)
-    , _signalerObjectName(signaler->objectName())
-    , _signalerAddress(signaler)
-    , _metaObject(signaler->metaObject())
-    , _metaMethod(metaMethod)
+    : _timestamp(timestamp)
+    , _sourceId(sourceId)
     , _parameters(parameters) {
 }
 
+qint64 QSignalLogger::Entry::getTimestamp() const {
+    return _timestamp;
+}
+
 const QPointer<QObject>& QSignalLogger::Entry::getSignaler() const {
-    return _signaler;
+    return QSignalLoggerSources::instance().at(_sourceId).signaler;
 }
 
 const void* QSignalLogger::Entry::getSignalerAddress() const {
-    return _signalerAddress;
+    return QSignalLoggerSources::instance().at(_sourceId).signalerAddress;
 }
 
 const QString& QSignalLogger::Entry::getSignalerObjectName() const {
-    return _signalerObjectName;
+    return QSignalLoggerSources::instance().at(_sourceId).objectName;
 }
 
 const QMetaObject* QSignalLogger::Entry::getSignalerMetaObject() const {
-    return _metaObject;
+    return QSignalLoggerSources::instance().at(_sourceId).metaObject;
 }
 
 const QMetaMethod& QSignalLogger::Entry::getSignalMetaMethod() const {
-    return _metaMethod;
+    return QSignalLoggerSources::instance().at(_sourceId).metaMethod;
 }
 
 const QVector<QVariant>& QSignalLogger::Entry::getParameters() const {
@@ -71,7 +800,134 @@ QVariant QSignalLogger::Entry::getParameterByName(const QByteArray& name) const
 }
 
 
+qint64 QSignalLogger::Record::getTimestamp() const {
+    return _timestamp;
+}
+
+const void* QSignalLogger::Record::getSignalerAddress() const {
+    return _signalerAddress;
+}
+
+const QMetaObject* QSignalLogger::Record::getSignalerMetaObject() const {
+    return _metaObject;
+}
+
+int QSignalLogger::Record::getSignalMethodIndex() const {
+    return _methodIndex;
+}
+
+QMetaMethod QSignalLogger::Record::getSignalMetaMethod() const {
+    return _metaObject->method(_methodIndex);
+}
+
+const QByteArray& QSignalLogger::Record::getSerializedParameters() const {
+    return _parameters;
+}
+
+QVector<QVariant> QSignalLogger::Record::getParameters() const {
+    const int parameterCount = getSignalMetaMethod().parameterCount();
+    QVector<QVariant> parameters;
+    parameters.reserve(parameterCount);
+    const char* data = _parameters.constData();
+    const char* const end = data + _parameters.size();
+    for(int I = 0; I < parameterCount; ++I) {
+        QVariant parameter;
+        QValueSerializer::deserialize(data, end, parameter);
+        parameters.append(parameter);
+    }
+    return parameters;
+}
+
 void QSignalLogger::universal(QObject* signaler, const QMetaMethod& signalMetaMethod
                               , const QVector<QVariant>& parameters) {
-    _log.append(Entry(signaler, signalMetaMethod, parameters));
+    if(_captureWriter) {
+        _captureWriter->writeEvent(signaler, signalMetaMethod, parameters);
+    } else if(_ring.isEmpty()) {
+        _log.append(Entry(_timer.nsecsElapsed(), sourceId(signaler, signalMetaMethod)
+                          , parameters));
+        if(_indexes) {
+            indexEntry(_log.size() - 1);
+        }
+    } else {
+        appendRecord(signaler, signalMetaMethod, parameters);
+    }
+}
+
+quint32 QSignalLogger::sourceId(QObject* signaler, const QMetaMethod& signalMetaMethod) {
+    const QString objectName = signaler->objectName();
+    // Consecutive signals usually come from the same signal of the same
+    // object, whose name is implicitly shared.
+    QSignalLoggerSources& sources = QSignalLoggerSources::instance();
+    if(signaler != _lastSignaler || signalMetaMethod.methodIndex() != _lastMethodIndex
+            || ! objectName.isSharedWith(_lastObjectName)
+            || sources.at(_lastSourceId).signaler.data() != signaler) {
+        _lastSignaler = signaler;
+        _lastMethodIndex = signalMetaMethod.methodIndex();
+        _lastObjectName = objectName;
+        _lastSourceId = sources.intern(signaler, objectName, signalMetaMethod);
+    }
+    return _lastSourceId;
+}
+
+void QSignalLogger::appendRecord(QObject* signaler, const QMetaMethod& signalMetaMethod
+                                 , const QVector<QVariant>& parameters) {
+    // Serialize the record.
+    _recordBuffer.resize(sizeof(RecordHeader));
+    for(const QVariant& parameter : parameters) {
+        QValueSerializer::serialize(parameter, _recordBuffer);
+    }
+    const int size = _recordBuffer.size();
+    const int capacity = _ring.size();
+    if(size > capacity) {
+        return;
+    }
+    RecordHeader header;
+    header.size = static_cast<quint32>(size);
+    header.methodIndex = signalMetaMethod.methodIndex();
+    header.timestamp = _timer.nsecsElapsed();
+    header.signalerAddress = signaler;
+    header.metaObject = signaler->metaObject();
+    std::memcpy(_recordBuffer.data(), &header, sizeof(header));
+
+    // Make room for the record, overwriting the oldest records if needed.
+    forever {
+        if(_ringCount == 0) {
+            _ringHead = 0;
+            _ringTail = 0;
+            _ringWrap = -1;
+        }
+        if(_ringWrap < 0) {
+            // Records are in [head, tail).
+            if(capacity - _ringTail >= size) {
+                break;
+            }
+            _ringWrap = _ringTail;
+            _ringTail = 0;
+        }
+        // Records are in [head, wrap) and [0, tail).
+        if(_ringHead - _ringTail >= size) {
+            break;
+        }
+        removeOldestRecord();
+    }
+
+    std::memcpy(_ring.data() + _ringTail, _recordBuffer.constData(), size);
+    _ringTail += size;
+    ++_ringCount;
+}
+
+void QSignalLogger::removeOldestRecord() {
+    Q_ASSERT(_ringCount > 0);
+    _ringHead += recordSize(_ringHead);
+    --_ringCount;
+    if(_ringWrap >= 0 && _ringHead >= _ringWrap) {
+        _ringHead = 0;
+        _ringWrap = -1;
+    }
+}
+
+int QSignalLogger::recordSize(int offset) const {
+    quint32 size;
+    std::memcpy(&size, _ring.constData() + offset, sizeof(size));
+    return static_cast<int>(size);
 }
@@ -22,12 +22,24 @@
 #include "QUniversalSlot.h"
 
 #include <QPointer>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPair>
+
+class QSignalCaptureWriter;
 
 class QSignalLogger : public QUniversalSlot {
     Q_OBJECT
 
 public:
 
+    /**
+     * @brief A logged signal.
+     * @note The signaler, its object name and the signal's meta method are
+     *       interned in a process wide store, so an entry only keeps their id
+     *       and stays valid after the logger is cleared or destroyed.
+     */
     class Entry {
 
         friend class QSignalLogger;
@@ -35,6 +47,13 @@ public:
 
     public:
 
+        /**
+         * @brief Returns the time the signal was received, in nanoseconds
+         *        since the logger was constructed.
+         * @return
+         */
+        qint64 getTimestamp() const;
+
         /**
          * @brief Returns a QPointer to the signaler object.
          * @note Check the pointer for validity before using it because the
@@ -101,20 +120,177 @@ public:
 
         /**
          * @brief Constructor.
-         * @param signaler Pointer to the QObject that sent the signal.
-         * @param methodIndex Signal's method index.
-         * @param arguments Vector with the signal's parameters, in the correct
-         *                  order.
+         * @param timestamp Time the signal was received.
+         * @param sourceId Id of the interned signaler, object name and signal.
+         * @param parameters Vector with the signal's parameters, in the correct
+         *                   order.
+         */
+        Entry(qint64 timestamp, quint32 sourceId, const QVector<QVariant>& parameters);
+
+        qint64 _timestamp;
+        quint32 _sourceId;
+        QVector<QVariant> _parameters;
+    };
+
+    /**
+     * @brief A view of some of the log's entries, in the order they were
+     *        logged, that refers to the entries without copying them.
+     * @note Views are invalidated by clear().
+     */
+    class View {
+
+        friend class QSignalLogger;
+
+    public:
+
+        class const_iterator {
+
+            friend class View;
+
+        public:
+
+            const Entry& operator*() const;
+            const Entry* operator->() const;
+            const_iterator& operator++();
+            bool operator==(const const_iterator& other) const;
+            bool operator!=(const const_iterator& other) const;
+
+        private:
+
+            const_iterator(const View* view, int position);
+
+            const View* _view;
+            int _position;
+        };
+
+        /**
+         * @brief Constructs an empty view.
+         */
+        View();
+
+        /**
+         * @brief Returns the number of entries in the view.
+         * @return
+         */
+        int size() const;
+
+        /**
+         * @brief Returns true if the view has no entries.
+         * @return
+         */
+        bool isEmpty() const;
+
+        /**
+         * @brief Returns the entry at the given position of the view.
+         * @param position Position in the view, in the range [0, size()).
+         * @return
+         */
+        const Entry& at(int position) const;
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+    private:
+
+        /**
+         * @brief Constructs a view of a contiguous range of the log.
+         */
+        View(const QVector<Entry>* log, int first, int count);
+
+        /**
+         * @brief Constructs a view of the entries at the given log positions.
+         */
+        View(const QVector<Entry>* log, const QVector<int>& positions);
+
+        const QVector<Entry>* _log;
+        /** @brief Positions of the entries in the log. Empty for ranges. */
+        QVector<int> _positions;
+        int _first;
+        int _count;
+    };
+
+    /**
+     * @brief Secondary indexes of the log, updated as entries are appended.
+     */
+    enum class Index {
+        /** @brief Index by the signaler's address. */
+        Signaler = 1,
+        /** @brief Index by the signaler's meta object. */
+        MetaObject = 2,
+        /** @brief Index by the signal. */
+        Signal = 4,
+    };
+
+    class Record {
+
+        friend class QSignalLogger;
+        template <typename T> friend class QVector;
+
+    public:
+
+        /**
+         * @brief Returns the time the signal was received, in nanoseconds
+         *        since the logger was constructed.
+         * @return
+         */
+        qint64 getTimestamp() const;
+
+        /**
+         * @brief Returns the memory address of the signaler object.
+         * @warning Do not use this pointer to access the object because there is
+         *          no way of knowing if the object is still valid.
+         * @return
+         */
+        const void* getSignalerAddress() const;
+
+        /**
+         * @brief Returns the signaler's meta object.
+         * @return
+         */
+        const QMetaObject* getSignalerMetaObject() const;
+
+        /**
+         * @brief Returns the signal's method index.
+         * @return
+         */
+        int getSignalMethodIndex() const;
+
+        /**
+         * @brief Returns the signal's meta method.
+         * @return
+         */
+        QMetaMethod getSignalMetaMethod() const;
+
+        /**
+         * @brief Returns the signal's serialized parameters, one
+         *        QValueSerializer record per parameter.
+         * @return
+         */
+        const QByteArray& getSerializedParameters() const;
+
+        /**
+         * @brief Returns the signal's parameters, deserialized.
+         * @note Values of types without a QValueSerializer or stream operators
+         *       are not recorded and are returned as invalid QVariants.
+         *       Pointers are recorded by value.
+         * @warning Be careful of pointers in the parameters that may point to
+         *     objects/memory freed or relocated after the signal was emitted.
+         * @return
+         */
+        QVector<QVariant> getParameters() const;
+
+    private:
+
+        /**
+         * @brief Default constructor needed by QVector<Record>.
          */
-        Entry(QObject* _signaler, const QMetaMethod& methodIndex
-              , const QVector<QVariant>& _parameters);
+        Record() = default;
 
-        QPointer<QObject> _signaler;
-        QString _signalerObjectName;
+        qint64 _timestamp;
         const void* _signalerAddress;
         const QMetaObject* _metaObject;
-        const QMetaMethod _metaMethod;
-        QVector<QVariant> _parameters;
+        int _methodIndex;
+        QByteArray _parameters;
     };
 
     /**
@@ -124,6 +300,89 @@ public:
      */
     explicit QSignalLogger(QObject* parent = nullptr, uint reserve = 0);
 
+    /**
+     * @brief Destructor. Closes the capture file.
+     */
+    ~QSignalLogger();
+
+    /**
+     * @brief Returns the ring buffer capacity in bytes. Zero, the default,
+     *        means that the ring buffer mode is disabled.
+     * @return
+     */
+    int getRingBufferCapacity() const;
+
+    /**
+     * @brief Sets the ring buffer capacity, in bytes, and clears the ring buffer.
+     * @details In ring buffer mode the signals are stored as compact binary
+     *          records in a buffer of fixed capacity, instead of being appended
+     *          as entries to the log. When the buffer is full, the oldest
+     *          records are overwritten, so memory usage never exceeds the
+     *          capacity. Signals whose record alone is larger than the
+     *          capacity are not recorded.
+     * @param capacity Ring buffer capacity in bytes or zero to disable the ring
+     *                 buffer mode.
+     */
+    void setRingBufferCapacity(int capacity);
+
+    /**
+     * @brief Returns the number of records in the ring buffer.
+     * @return
+     */
+    int getRecordCount() const;
+
+    /**
+     * @brief Returns the records in the ring buffer, from oldest to newest.
+     * @return
+     */
+    QVector<Record> getRecords() const;
+
+    /**
+     * @brief Starts writing the signals to a capture file, closing the
+     *        previous capture file, if any.
+     * @details In capture file mode the signals are appended as fixed layout
+     *          records to memory mapped segment files of fixed size, instead of
+     *          being appended as entries to the log or to the ring buffer. The
+     *          class, signal and object names are interned in a string table
+     *          per segment and the parameters are serialized with
+     *          QValueSerializer. When a segment is full, the next segment is
+     *          created with the capture's file path followed by ".1", ".2", ...
+     *          Closed segments are truncated to their used size.
+     *          Use QSignalCaptureReader to read the capture.
+     * @param filePath Capture's file path. Existing segments are overwritten.
+     * @param segmentSize Size of each segment, in bytes.
+     * @return Returns false if the first segment could not be created and
+     *         mapped to memory.
+     */
+    bool setCaptureFile(const QString& filePath, qint64 segmentSize = 64 * 1024 * 1024);
+
+    /**
+     * @brief Closes the capture file, if any, and disables the capture file
+     *        mode.
+     */
+    void closeCaptureFile();
+
+    /**
+     * @brief Returns the capture's file path or an empty string if the
+     *        capture file mode is disabled.
+     * @return
+     */
+    QString getCaptureFile() const;
+
+    /**
+     * @brief Returns the number of signals written to the capture file.
+     * @return
+     */
+    qint64 getCapturedCount() const;
+
+    /**
+     * @brief Returns the number of signals that could not be written to the
+     *        capture file, because a segment could not be created or because
+     *        the signal and its names do not fit in a segment.
+     * @return
+     */
+    qint64 getCaptureDroppedCount() const;
+
     /**
      * @brief Returns the log.
      * @return
@@ -131,10 +390,83 @@ public:
     const QVector<Entry>& getLog() const;
 
     /**
-     * @brief Clears the log.
+     * @brief Clears the log and the ring buffer. The capture file is not
+     *        affected.
      */
     void clear();
 
+    /**
+     * @brief Enables the given index, indexing the entries already in the log.
+     * @note Queries work without indexes, scanning the log. Indexes make them
+     *       proportional to the number of entries found instead.
+     * @param index The index to enable.
+     */
+    void enableIndex(Index index);
+
+    /**
+     * @brief Disables the given index and frees its memory.
+     * @param index The index to disable.
+     */
+    void disableIndex(Index index);
+
+    /**
+     * @brief Returns true if the given index is enabled.
+     * @param index The index to check.
+     * @return
+     */
+    bool isIndexEnabled(Index index) const;
+
+    /**
+     * @brief Returns the entries of the signals emited by the object with the
+     *        given address. Uses the Signaler index, if enabled.
+     * @param signalerAddress Signaler's address.
+     * @return
+     */
+    View getEntriesBySignaler(const void* signalerAddress) const;
+
+    /**
+     * @brief Returns the entries of the signals emited by objects whose class
+     *        is exactly the given meta object's. Uses the MetaObject index, if
+     *        enabled.
+     * @param metaObject Signaler's meta object.
+     * @return
+     */
+    View getEntriesByMetaObject(const QMetaObject* metaObject) const;
+
+    /**
+     * @brief Returns the entries of the given signal, emited by objects of the
+     *        class that declares it or of derived classes. Uses the Signal
+     *        index, if enabled.
+     * @param signalMetaMethod The signal's meta method.
+     * @return
+     */
+    View getEntriesBySignal(const QMetaMethod& signalMetaMethod) const;
+
+    /**
+     * @brief Returns the number of entries of the given signal.
+     * @param signalMetaMethod The signal's meta method.
+     * @return
+     */
+    int getSignalCount(const QMetaMethod& signalMetaMethod) const;
+
+    /**
+     * @brief Returns the entries whose timestamps are in the interval
+     *        [from, to). Entries are in timestamp order, so no index is needed.
+     * @param from Start of the interval, in nanoseconds since the logger was
+     *             constructed.
+     * @param to End of the interval, excluded.
+     * @return
+     */
+    View getEntriesInTimeWindow(qint64 from, qint64 to) const;
+
+    /**
+     * @brief Returns the time elapsed since the logger was constructed, in
+     *        nanoseconds, the same clock as the entries' and records'
+     *        timestamps.
+     * @return
+     */
+    qint64 getElapsedTime() const;
+
 private:
 
     /**
@@ -146,11 +478,84 @@ private:
     virtual void universal(QObject* signaler, const QMetaMethod& signalMetaMethod
                            , const QVector<QVariant>& parameters) override;
 
+    /**
+     * @brief Returns the id of the interned source of a signal.
+     */
+    quint32 sourceId(QObject* signaler, const QMetaMethod& signalMetaMethod);
+
+    /**
+     * @brief Appends the record for a signal to the ring buffer.
+     */
+    void appendRecord(QObject* signaler, const QMetaMethod& signalMetaMethod
+                      , const QVector<QVariant>& parameters);
+
+    /**
+     * @brief Removes the oldest record from the ring buffer.
+     */
+    void removeOldestRecord();
+
+    /**
+     * @brief Returns the size of the record at the given ring buffer offset.
+     */
+    int recordSize(int offset) const;
+
+    /**
+     * @brief Appends the entry at the given log position to the enabled
+     *        indexes.
+     */
+    void indexEntry(int position);
+
+    /**
+     * @brief Returns a view of the entries that satisfy the given predicate,
+     *        scanning the log.
+     */
+    template<typename PREDICATE>
+    View scanLog(PREDICATE predicate) const;
+
     /**
      * @brief The vector with the log entries.
      */
     QVector<Entry> _log;
 
+    // The source of the last logged signal.
+    const void* _lastSignaler;
+    int _lastMethodIndex;
+    QString _lastObjectName;
+    quint32 _lastSourceId;
+
+    /** @brief Enabled indexes, flags of Index. */
+    uint _indexes;
+    /** @brief Log positions by signaler address. */
+    QHash<const void*, QVector<int>> _signalerIndex;
+    /** @brief Log positions by signaler meta object. */
+    QHash<const QMetaObject*, QVector<int>> _metaObjectIndex;
+    /** @brief Log positions by signal, the class that declares it and its method index. */
+    QHash<QPair<const QMetaObject*, int>, QVector<int>> _signalIndex;
+
+    /**
+     * @brief Ring buffer with the records. Empty if the ring buffer mode is
+     *        disabled.
+     */
+    QByteArray _ring;
+
+    /** @brief Offset of the oldest record. */
+    int _ringHead;
+    /** @brief Offset where the next record will be written. */
+    int _ringTail;
+    /** @brief End of the records before the tail wrapped or -1 if not wrapped. */
+    int _ringWrap;
+    /** @brief Number of records in the ring buffer. */
+    int _ringCount;
+
+    /** @brief Buffer where each record is serialized before being copied to the ring. */
+    QByteArray _recordBuffer;
+
+    /** @brief Timer for the records timestamps. */
+    QElapsedTimer _timer;
+
+    /** @brief Writer of the capture file or nullptr if the capture file mode is disabled. */
+    QSignalCaptureWriter* _captureWriter;
+
 };
 
 #endif // QSIGNALLOGGER_H
@@ -0,0 +1,380 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+#include "QSignalQueueMonitor.h"
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QThread>
+
+#include <algorithm>
+
+/* Data members of QMetaCallEvent, taken from qobject_p.h of Qt 5.4 to 5.13 */
+/* BEGIN */
+class QMetaCallEventLayout : public QEvent {
+public:
+    void* slotObj_;
+    const QObject* sender_;
+    int signalId_;
+    int nargs_;
+    int* types_;
+    void** args_;
+    void* semaphore_;
+    void* callFunction_;
+    ushort method_offset_;
+    ushort method_relative_;
+};
+/* END */
+
+/**
+ * @brief The QSignalQueueMonitor instances, that receive the queued slot calls
+ *        from the event notify callback.
+ * @details Qt does not report the slots called by queued connections to the
+ *          signal spy callbacks. They are delivered as QEvent::MetaCall events,
+ *          which are seen by the event notify callback, in the receiver's
+ *          thread, before they are delivered.
+ */
+class QSignalQueueMonitorRegistry {
+
+public:
+
+    static void add(QSignalQueueMonitor* monitor) {
+        QSignalQueueMonitorRegistry& registry = instance();
+        QMutexLocker locker(&registry._mutex);
+        if(! registry._registered) {
+#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
+            // The callbacks can not be safely unregistered while other
+            // threads may be calling them, so it is never unregistered.
+            QInternal::registerCallback(QInternal::EventNotifyCallback, &eventNotifyCallback);
+#else
+            qWarning("QSignalQueueMonitor: the queued slot calls can not be"
+                     " monitored with Qt %s, only with Qt 5.4 to 5.13."
+                     , QT_VERSION_STR);
+#endif
+            registry._registered = true;
+        }
+        registry._monitors.append(monitor);
+    }
+
+    static void remove(QSignalQueueMonitor* monitor) {
+        QSignalQueueMonitorRegistry& registry = instance();
+        QMutexLocker locker(&registry._mutex);
+        registry._monitors.removeAll(monitor);
+    }
+
+    static void monitorEnabledChanged(bool enabled) {
+        QSignalQueueMonitorRegistry& registry = instance();
+        if(enabled) {
+            registry._enabledCount.ref();
+        } else {
+            registry._enabledCount.deref();
+        }
+    }
+
+private:
+
+    QSignalQueueMonitorRegistry()
+        : _enabledCount(0)
+        , _mutex()
+        , _monitors()
+        , _registered(false) {
+    }
+
+    static QSignalQueueMonitorRegistry& instance() {
+        static QSignalQueueMonitorRegistry registry;
+        return registry;
+    }
+
+    static bool eventNotifyCallback(void** data) {
+        // Every event of the application goes through here.
+        QSignalQueueMonitorRegistry& registry = instance();
+        if(registry._enabledCount.loadAcquire() == 0) {
+            return false;
+        }
+        QObject* const receiver = static_cast<QObject*>(data[0]);
+        const QEvent* const event = static_cast<const QEvent*>(data[1]);
+        if(! receiver || ! event || event->type() != QEvent::MetaCall) {
+            return false;
+        }
+        // The signaler may have been deleted after the call was queued, so
+        // it is only used as a key.
+        const QMetaCallEventLayout* const metaCallEvent
+                = static_cast<const QMetaCallEventLayout*>(event);
+        const void* const signaler = metaCallEvent->sender_;
+        const int signalIndex = metaCallEvent->signalId_;
+        // Calls queued by QMetaObject::invokeMethod() have no signal.
+        if(! signaler || signalIndex < 0) {
+            return false;
+        }
+        const quintptr slot = metaCallEvent->slotObj_
+                ? reinterpret_cast<quintptr>(metaCallEvent->slotObj_)
+                : static_cast<quintptr>(metaCallEvent->method_offset_
+                                        + metaCallEvent->method_relative_);
+        QMutexLocker locker(&registry._mutex);
+        for(QSignalQueueMonitor* const monitor : registry._monitors) {
+            if(monitor->isMonitorEnabled()) {
+                monitor->queuedDelivery(receiver, signaler, signalIndex, slot);
+            }
+        }
+        // Let the event be delivered.
+        return false;
+    }
+
+    /** @brief Number of enabled monitors, checked without locking. */
+    QAtomicInt _enabledCount;
+    QMutex _mutex;
+    QVector<QSignalQueueMonitor*> _monitors;
+    bool _registered;
+};
+
+const QMetaObject* QSignalQueueMonitor::QueueStatistics::getSignalerMetaObject() const {
+    return _metaObject;
+}
+
+int QSignalQueueMonitor::QueueStatistics::getSignalMethodIndex() const {
+    return _methodIndex;
+}
+
+QMetaMethod QSignalQueueMonitor::QueueStatistics::getSignalMetaMethod() const {
+    return _metaObject->method(_methodIndex);
+}
+
+const QThread* QSignalQueueMonitor::QueueStatistics::getReceiverThread() const {
+    return _thread;
+}
+
+const QSignalQueueMonitor::Histogram& QSignalQueueMonitor::QueueStatistics::getHistogram() const {
+    return _histogram;
+}
+
+int QSignalQueueMonitor::QueueStatistics::getBacklog() const {
+    return _backlog;
+}
+
+int QSignalQueueMonitor::QueueStatistics::getMaxBacklog() const {
+    return _maxBacklog;
+}
+
+QSignalQueueMonitor::QSignalQueueMonitor(QObject* parent, int historySize)
+    : QSignalSlotMonitor(parent)
+    , _historySize(qMax(historySize, 1))
+    , _timer()
+    , _emissionsCount(0)
+    , _mutex()
+    , _emissions()
+    , _statistics()
+    , _receivers()
+    , _unmatchedCount(0) {
+    Q_ASSERT(historySize > 0);
+    _timer.start();
+    QSignalQueueMonitorRegistry::add(this);
+}
+
+QSignalQueueMonitor::~QSignalQueueMonitor() {
+    disableMonitor();
+    QSignalQueueMonitorRegistry::remove(this);
+}
+
+int QSignalQueueMonitor::getHistorySize() const {
+    return _historySize;
+}
+
+QVector<QSignalQueueMonitor::QueueStatistics> QSignalQueueMonitor::getQueueStatistics() const {
+    QVector<QueueStatistics> statistics;
+    {
+        QMutexLocker locker(&_mutex);
+        statistics.reserve(_statistics.count());
+        for(auto iter = _statistics.constBegin(); iter != _statistics.constEnd(); ++iter) {
+            QueueStatistics queueStatistics;
+            queueStatistics._metaObject = iter.key().first.first;
+            queueStatistics._methodIndex = iter.key().first.second;
+            queueStatistics._thread = iter.key().second;
+            queueStatistics._histogram = iter.value().histogram;
+            queueStatistics._backlog = iter.value().backlog;
+            queueStatistics._maxBacklog = iter.value().maxBacklog;
+            statistics.append(queueStatistics);
+        }
+    }
+    std::sort(statistics.begin(), statistics.end()
+              , [] (const QueueStatistics& a, const QueueStatistics& b) {
+        return a.getHistogram().getTotal() > b.getHistogram().getTotal();
+    });
+    return statistics;
+}
+
+quint64 QSignalQueueMonitor::getUnmatchedCount() const {
+    QMutexLocker locker(&_mutex);
+    return _unmatchedCount;
+}
+
+void QSignalQueueMonitor::clear() {
+    QMutexLocker locker(&_mutex);
+    for(Statistics& statistics : _statistics) {
+        statistics.histogram = Histogram();
+        statistics.maxBacklog = statistics.backlog;
+    }
+    _unmatchedCount = 0;
+}
+
+void QSignalQueueMonitor::signalBegin(const SignalInfo& signalInfo) {
+    // Only the signals already delivered through queued connections are
+    // stamped.
+    if(_emissionsCount.load() == 0) {
+        return;
+    }
+    const qint64 timestamp = _timer.nsecsElapsed();
+    const QThread* const thread = QThread::currentThread();
+    QObject* const signaler = signalInfo.getSignaler();
+    QMutexLocker locker(&_mutex);
+    const auto iter = _emissions.find(EmissionsKey(signaler, signalInfo.getSignalIndex()));
+    if(iter == _emissions.end()) {
+        return;
+    }
+    Emissions& emissions = iter.value();
+    const QMetaObject* const metaObject = signaler->metaObject();
+    if(emissions.metaObject != metaObject) {
+        // A new signaler at the address of a deleted one.
+        if(emissions.metaObject) {
+            while(! emissions.streams.isEmpty()) {
+                removeStream(emissions, emissions.streams.count() - 1);
+            }
+        }
+        emissions.metaObject = metaObject;
+        emissions.methodIndex = signalInfo.getMethodIndex();
+    }
+    const quint64 emission = emissions.count;
+    Emission& entry = emissions.history[static_cast<int>(emission % _historySize)];
+    entry.timestamp = timestamp;
+    entry.thread = thread;
+    ++emissions.count;
+    for(int I = emissions.streams.count() - 1; I >= 0; --I) {
+        Stream& stream = emissions.streams[I];
+        if(stream.pending > 0 && emission - stream.next >= static_cast<quint64>(_historySize)) {
+            // The receiver fell too far behind or was disconnected.
+            removeStream(emissions, I);
+            continue;
+        }
+        // Emissions in the receiver's thread call the slot directly, unless
+        // the connection is queued explicitly, and are not counted.
+        if(stream.thread == thread) {
+            continue;
+        }
+        if(stream.pending == 0) {
+            stream.next = emission;
+        }
+        ++stream.pending;
+        Statistics& statistics = _statistics[StatisticsKey(
+                    qMakePair(metaObject, emissions.methodIndex), stream.thread)];
+        ++statistics.backlog;
+        statistics.maxBacklog = qMax(statistics.maxBacklog, statistics.backlog);
+    }
+}
+
+void QSignalQueueMonitor::monitorEnabledChanged(bool enabled) {
+    QSignalQueueMonitorRegistry::monitorEnabledChanged(enabled);
+}
+
+void QSignalQueueMonitor::queuedDelivery(QObject* receiver, const void* signaler
+                                         , int signalIndex, quintptr slot) {
+    const qint64 timestamp = _timer.nsecsElapsed();
+    const QThread* const thread = QThread::currentThread();
+    bool watchReceiver = false;
+    {
+        QMutexLocker locker(&_mutex);
+        auto iter = _emissions.find(EmissionsKey(signaler, signalIndex));
+        if(iter == _emissions.end()) {
+            Emissions emissions;
+            emissions.metaObject = nullptr;
+            emissions.methodIndex = -1;
+            emissions.count = 0;
+            emissions.history.resize(_historySize);
+            iter = _emissions.insert(EmissionsKey(signaler, signalIndex), emissions);
+            _emissionsCount.store(_emissions.count());
+        }
+        Emissions& emissions = iter.value();
+        int streamIndex = 0;
+        while(streamIndex < emissions.streams.count()
+              && (emissions.streams.at(streamIndex).receiver != receiver
+                  || emissions.streams.at(streamIndex).slot != slot)) {
+            ++streamIndex;
+        }
+        if(streamIndex < emissions.streams.count()
+                && emissions.streams.at(streamIndex).thread != thread) {
+            // The receiver was moved to another thread.
+            removeStream(emissions, streamIndex);
+        }
+        if(streamIndex == emissions.streams.count()) {
+            // The calls queued before the stream is known can not be matched.
+            const Stream stream = {receiver, slot, thread, 0, 0};
+            emissions.streams.append(stream);
+            ++_unmatchedCount;
+            if(! _receivers.contains(receiver)) {
+                _receivers.insert(receiver);
+                watchReceiver = true;
+            }
+        } else {
+            Stream& stream = emissions.streams[streamIndex];
+            if(stream.pending == 0) {
+                ++_unmatchedCount;
+            } else {
+                // Queued calls are delivered in the order they were queued.
+                const qint64 emitted = emissions.history.at(
+                            static_cast<int>(stream.next % _historySize)).timestamp;
+                --stream.pending;
+                if(stream.pending > 0) {
+                    // Skip the emissions of the receiver's thread.
+                    do {
+                        ++stream.next;
+                    } while(emissions.history.at(static_cast<int>(stream.next % _historySize))
+                            .thread == thread);
+                }
+                Statistics& statistics = _statistics[StatisticsKey(
+                            qMakePair(emissions.metaObject, emissions.methodIndex), thread)];
+                --statistics.backlog;
+                statistics.histogram.record(timestamp - emitted);
+            }
+        }
+    }
+    if(watchReceiver) {
+        // The queued calls of a destroyed receiver are never delivered.
+        connect(receiver, &QObject::destroyed, this, [this] (QObject* object) {
+            removeReceiver(object);
+        }, Qt::DirectConnection);
+    }
+}
+
+void QSignalQueueMonitor::removeReceiver(QObject* receiver) {
+    QMutexLocker locker(&_mutex);
+    _receivers.remove(receiver);
+    for(Emissions& emissions : _emissions) {
+        for(int I = emissions.streams.count() - 1; I >= 0; --I) {
+            if(emissions.streams.at(I).receiver == receiver) {
+                removeStream(emissions, I);
+            }
+        }
+    }
+}
+
+void QSignalQueueMonitor::removeStream(Emissions& emissions, int streamIndex) {
+    const Stream& stream = emissions.streams.at(streamIndex);
+    if(stream.pending > 0) {
+        _statistics[StatisticsKey(qMakePair(emissions.metaObject, emissions.methodIndex)
+                                  , stream.thread)].backlog -= stream.pending;
+    }
+    emissions.streams.remove(streamIndex);
+}
@@ -0,0 +1,239 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+#ifndef QSIGNALQUEUEMONITOR_H
+#define QSIGNALQUEUEMONITOR_H
+
+#include "QSignalSlotMonitor.h"
+#include "QSlotProfiler.h"
+
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QPair>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+
+class QThread;
+
+class QSignalQueueMonitor : public QSignalSlotMonitor {
+    Q_OBJECT
+
+    friend class QSignalQueueMonitorRegistry;
+
+public:
+
+    /**
+     * @brief Histogram of the queue delays, in nanoseconds.
+     */
+    typedef QSlotProfiler::Histogram Histogram;
+
+    class QueueStatistics {
+
+        friend class QSignalQueueMonitor;
+        template <typename T> friend class QVector;
+
+    public:
+
+        /**
+         * @brief Returns the signaler's meta object.
+         * @return
+         */
+        const QMetaObject* getSignalerMetaObject() const;
+
+        /**
+         * @brief Returns the signal's method index.
+         * @return
+         */
+        int getSignalMethodIndex() const;
+
+        /**
+         * @brief Returns the signal's meta method.
+         * @return
+         */
+        QMetaMethod getSignalMetaMethod() const;
+
+        /**
+         * @brief Returns the thread of the receivers.
+         * @warning Do not use this pointer to access the thread because there
+         *          is no way of knowing if the thread is still valid.
+         * @return
+         */
+        const QThread* getReceiverThread() const;
+
+        /**
+         * @brief Returns the histogram of the delays between the emissions of
+         *        the signal and the calls of the queued slots.
+         * @return
+         */
+        const Histogram& getHistogram() const;
+
+        /**
+         * @brief Returns the number of queued slot calls of the signal waiting
+         *        to be delivered in the thread.
+         * @return
+         */
+        int getBacklog() const;
+
+        /**
+         * @brief Returns the maximum backlog.
+         * @return
+         */
+        int getMaxBacklog() const;
+
+    private:
+
+        /**
+         * @brief Default constructor needed by QVector<QueueStatistics>.
+         */
+        QueueStatistics() = default;
+
+        const QMetaObject* _metaObject;
+        int _methodIndex;
+        const QThread* _thread;
+        Histogram _histogram;
+        int _backlog;
+        int _maxBacklog;
+    };
+
+    /**
+     * @brief Constructor.
+     * @param parent
+     * @param historySize Number of emissions of each signal whose timestamps
+     *                    are kept, how far behind the signal a queued
+     *                    connection can fall.
+     * @note The monitor must be enabled with enableMonitor() to start
+     *       monitoring.
+     */
+    explicit QSignalQueueMonitor(QObject* parent = nullptr, int historySize = 1024);
+
+    /**
+     * @brief Destructor.
+     * @note Disables the monitor.
+     */
+    ~QSignalQueueMonitor();
+
+    /**
+     * @brief Returns the number of emissions of each signal whose timestamps
+     *        are kept.
+     * @return
+     */
+    int getHistorySize() const;
+
+    /**
+     * @brief Returns a snapshot of the statistics of each signal and receiver
+     *        thread, ordered by total queue delay, longest first.
+     * @return
+     */
+    QVector<QueueStatistics> getQueueStatistics() const;
+
+    /**
+     * @brief Returns the number of queued slot calls that could not be
+     *        matched to an emission, like the first call of each queued
+     *        connection.
+     * @return
+     */
+    quint64 getUnmatchedCount() const;
+
+    /**
+     * @brief Clears the histograms, the maximum backlogs and the unmatched
+     *        count. The backlogs are kept.
+     */
+    void clear();
+
+private:
+
+    typedef QPair<const void*, int> EmissionsKey;
+    typedef QPair<QPair<const QMetaObject*, int>, const QThread*> StatisticsKey;
+
+    /**
+     * @brief The queued slot calls of a signal to one slot of a receiver.
+     */
+    struct Stream {
+        const void* receiver;
+        quintptr slot;
+        const QThread* thread;
+        /** @brief Emissions not yet delivered. */
+        int pending;
+        /** @brief The oldest emission not yet delivered, if any. */
+        quint64 next;
+    };
+
+    /**
+     * @brief An emission of a signal with queued connections.
+     */
+    struct Emission {
+        qint64 timestamp;
+        const QThread* thread;
+    };
+
+    /**
+     * @brief The emissions of a signal of a signaler with queued connections.
+     */
+    struct Emissions {
+        /** @brief The signaler's meta object or nullptr until the first emission. */
+        const QMetaObject* metaObject;
+        int methodIndex;
+        quint64 count;
+        /** @brief Ring with the last emissions. */
+        QVector<Emission> history;
+        QVector<Stream> streams;
+    };
+
+    struct Statistics {
+        Histogram histogram;
+        int backlog = 0;
+        int maxBacklog = 0;
+    };
+
+    virtual void signalBegin(const SignalInfo& signalInfo) override;
+    virtual void monitorEnabledChanged(bool enabled) override;
+
+    /**
+     * @brief Called by the registry before a queued slot call is delivered
+     *        to the receiver, in the receiver's thread.
+     */
+    void queuedDelivery(QObject* receiver, const void* signaler, int signalIndex
+                        , quintptr slot);
+
+    /**
+     * @brief Removes the streams of a destroyed receiver.
+     */
+    void removeReceiver(QObject* receiver);
+
+    /**
+     * @brief Removes the stream with the given index from the emissions,
+     *        discounting its pending calls from the backlog.
+     */
+    void removeStream(Emissions& emissions, int streamIndex);
+
+    const int _historySize;
+    QElapsedTimer _timer;
+    /** @brief Number of signals with queued connections, checked without locking. */
+    QAtomicInt _emissionsCount;
+    mutable QMutex _mutex;
+    QHash<EmissionsKey, Emissions> _emissions;
+    QHash<StatisticsKey, Statistics> _statistics;
+    /** @brief Receivers whose destruction is being watched. */
+    QSet<const void*> _receivers;
+    quint64 _unmatchedCount;
+
+};
+
+#endif // QSIGNALQUEUEMONITOR_H
@@ -19,6 +19,16 @@
 #include "QSignalSlotMonitor.h"
 
 #include <QMutex>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+#include <QRecursiveMutex>
+#endif
+#include <QHash>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+#include <QThread>
 
 /* Taken from qobject_p.h */
 /* BEGIN */
@@ -33,98 +43,627 @@ struct QSignalSpyCallbackSet
 extern void qt_register_signal_spy_callbacks(const QSignalSpyCallbackSet &callback_set);
 /* END */
 
+/**
+ * @brief Shared state of the monitors.
+ * @details The enabled monitors are published as an immutable snapshot that is
+ *          replaced, never modified, when a monitor is enabled or disabled.
+ *          An instance of this class is a read side critical section: it
+ *          takes the current snapshot, without locking, and keeps it valid
+ *          until it is destroyed.
+ *          A replaced snapshot is only deleted after a grace period, i.e.
+ *          after all the critical sections that could hold it have ended.
+ *          The readers count themselves in one of two counters, selected by
+ *          the current epoch, and the grace period flips the epoch and waits
+ *          for each of the counters to drain.
+ *          When thread safe monitoring is enabled, the critical section also
+ *          holds a lock that serializes the callbacks of all the threads.
+ */
 class QSignalSlotMonitorData {
 
 public:
 
+    typedef QVector<QSignalSlotMonitor*> Monitors;
+
     QSignalSlotMonitorData()
-        : _useMutex(_threadSafeAccess) {
+        : _useMutex(_threadSafeAccess.loadAcquire() != 0)
+        , _epoch(_currentEpoch.loadAcquire()) {
         if(_useMutex) {
-            _mutex.lock();
+            _callbacksMutex.lock();
         }
+        _readers[_epoch].ref();
+        ++_nesting;
+        _monitors = _snapshot.loadAcquire();
     }
 
     ~QSignalSlotMonitorData() {
+        --_nesting;
+        _readers[_epoch].deref();
         if(_useMutex) {
-            _mutex.unlock();
+            _callbacksMutex.unlock();
         }
     }
 
-    inline QVector<QSignalSlotMonitor*>& getMonitors() {
-        return _monitors;
+    inline const Monitors& getMonitors() const {
+        return *_monitors;
     }
 
-    inline QVector<QSignalSlotMonitor::SignalInfo>& getSignalInfos() {
+    /**
+     * @brief Returns the calling thread's stack of signals being dispatched.
+     * @note The stack is thread local so it is accessed without locking.
+     */
+    static inline QVector<QSignalSlotMonitor::SignalInfo>& getSignalInfos() {
         return _signalInfos;
     }
 
+    /**
+     * @brief Returns the calling thread's stack of the monitors that sampled
+     *        the signals being dispatched.
+     * @note The stack is only used while some monitor samples the signals.
+     *       Each signal info keeps the index of its first sampling monitor in
+     *       the stack, or -1 if every monitor receives the signal.
+     */
+    static inline QVector<QSignalSlotMonitor*>& getSampledMonitors() {
+        return _sampledMonitors;
+    }
+
+    /**
+     * @brief Pushes the given monitors that sample the given signal to the
+     *        calling thread's stack, if some monitor samples the signals.
+     */
+    static inline void sampleSignal(QSignalSlotMonitor::SignalInfo& signalInfo
+                                    , const Monitors& monitors);
+
+    /**
+     * @brief Returns true if the given monitor receives the given signal,
+     *        which must be the last signal of the calling thread's stack.
+     */
+    static inline bool isSampledBy(const QSignalSlotMonitor::SignalInfo& signalInfo
+                                   , const QSignalSlotMonitor* monitor) {
+        const int index = signalInfo._sampledMonitorsIndex;
+        if(index < 0) {
+            return true;
+        }
+        for(int I = index; I < _sampledMonitors.count(); ++I) {
+            if(_sampledMonitors.at(I) == monitor) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Pops the monitors that sampled the given signal from the calling
+     *        thread's stack.
+     */
+    static inline void unsampleSignal(const QSignalSlotMonitor::SignalInfo& signalInfo) {
+        if(signalInfo._sampledMonitorsIndex >= 0) {
+            _sampledMonitors.resize(signalInfo._sampledMonitorsIndex);
+        }
+    }
+
     static inline void enableThreadSafeAccess() {
-        _threadSafeAccess = true;
+        _threadSafeAccess.storeRelease(1);
     }
 
     static inline void disableThreadSafeAccess() {
-        _threadSafeAccess = false;
+        _threadSafeAccess.storeRelease(0);
+    }
+
+    static bool enableMonitor(QSignalSlotMonitor* monitor) {
+        {
+            QMutexLocker locker(&_mutex);
+            Monitors monitors = *_snapshot.loadAcquire();
+            if(monitors.contains(monitor)) {
+                return false;
+            }
+            if(monitors.isEmpty()) {
+                static const QSignalSpyCallbackSet callbackSet = {
+                    &QSignalSlotMonitor::signalBeginCallback
+                    , &QSignalSlotMonitor::slotBeginCallback
+                    , &QSignalSlotMonitor::signalEndCallback
+                    , &QSignalSlotMonitor::slotEndCallback
+                };
+                qt_register_signal_spy_callbacks(callbackSet);
+            }
+            monitor->_generation.ref();
+            monitors.append(monitor);
+            publish(monitors);
+        }
+        synchronize();
+        return true;
+    }
+
+    static bool disableMonitor(QSignalSlotMonitor* monitor) {
+        {
+            QMutexLocker locker(&_mutex);
+            Monitors monitors = *_snapshot.loadAcquire();
+            if(! monitors.removeOne(monitor)) {
+                return false;
+            }
+            publish(monitors);
+            if(monitors.isEmpty()) {
+                static const QSignalSpyCallbackSet nullCallbackSet
+                        = {nullptr, nullptr, nullptr, nullptr};
+                qt_register_signal_spy_callbacks(nullCallbackSet);
+            }
+        }
+        synchronize();
+        return true;
     }
 
 private:
 
-    const bool _useMutex;
+    /**
+     * @brief Replaces the current snapshot by a copy of the given monitors and
+     *        retires the previous snapshot.
+     * @note Must be called with _mutex locked.
+     */
+    static void publish(const Monitors& monitors) {
+        const Monitors* const snapshot
+                = monitors.isEmpty() ? &_noMonitors : new Monitors(monitors);
+        const Monitors* const previous = _snapshot.fetchAndStoreOrdered(snapshot);
+        if(previous != &_noMonitors) {
+            _retired.append(previous);
+        }
+    }
+
+    /**
+     * @brief Waits for a grace period and deletes the snapshots retired before
+     *        it started.
+     * @note When called from inside a callback the grace period could never
+     *       end (or dead lock with another thread doing the same), so the
+     *       retired snapshots are left to be deleted by a later call.
+     */
+    static void synchronize() {
+        if(_nesting > 0) {
+            return;
+        }
+        QMutexLocker locker(&_synchronizeMutex);
+        QVector<const Monitors*> retired;
+        _mutex.lock();
+        retired.swap(_retired);
+        _mutex.unlock();
+        for(int I = 0; I < 2; ++I) {
+            const int epoch = _currentEpoch.loadAcquire();
+            _currentEpoch.fetchAndStoreOrdered(epoch ^ 1);
+            while(_readers[epoch].fetchAndAddOrdered(0) != 0) {
+                QThread::yieldCurrentThread();
+            }
+        }
+        qDeleteAll(retired);
+    }
 
-    static QVector<QSignalSlotMonitor::SignalInfo> _signalInfos;
-    static QVector<QSignalSlotMonitor*> _monitors;
+    const bool _useMutex;
+    const int _epoch;
+    const Monitors* _monitors;
+
+    static thread_local QVector<QSignalSlotMonitor::SignalInfo> _signalInfos;
+    static thread_local QVector<QSignalSlotMonitor*> _sampledMonitors;
+    static thread_local int _nesting;
+    static const Monitors _noMonitors;
+    static QAtomicPointer<const Monitors> _snapshot;
+    static QAtomicInt _currentEpoch;
+    static QAtomicInt _readers[2];
+    static QVector<const Monitors*> _retired;
     static QMutex _mutex;
-    static bool _threadSafeAccess;
+    static QMutex _synchronizeMutex;
+    static QAtomicInt _threadSafeAccess;
+    /** @brief Recursive, for the monitors that emit signals from their callbacks. */
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    static QRecursiveMutex _callbacksMutex;
+#else
+    static QMutex _callbacksMutex;
+#endif
 
 };
 
-QVector<QSignalSlotMonitor::SignalInfo> QSignalSlotMonitorData::_signalInfos;
-QVector<QSignalSlotMonitor*> QSignalSlotMonitorData::_monitors;
+thread_local QVector<QSignalSlotMonitor::SignalInfo> QSignalSlotMonitorData::_signalInfos;
+thread_local QVector<QSignalSlotMonitor*> QSignalSlotMonitorData::_sampledMonitors;
+thread_local int QSignalSlotMonitorData::_nesting = 0;
+const QSignalSlotMonitorData::Monitors QSignalSlotMonitorData::_noMonitors;
+QAtomicPointer<const QSignalSlotMonitorData::Monitors> QSignalSlotMonitorData::_snapshot(
+        &QSignalSlotMonitorData::_noMonitors);
+QAtomicInt QSignalSlotMonitorData::_currentEpoch;
+QAtomicInt QSignalSlotMonitorData::_readers[2];
+QVector<const QSignalSlotMonitorData::Monitors*> QSignalSlotMonitorData::_retired;
 QMutex QSignalSlotMonitorData::_mutex;
-bool QSignalSlotMonitorData::_threadSafeAccess = false;
+QMutex QSignalSlotMonitorData::_synchronizeMutex;
+QAtomicInt QSignalSlotMonitorData::_threadSafeAccess;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+QRecursiveMutex QSignalSlotMonitorData::_callbacksMutex;
+#else
+QMutex QSignalSlotMonitorData::_callbacksMutex(QMutex::Recursive);
+#endif
+
+/**
+ * @brief Rate limiter with the generic cell rate algorithm, equivalent to a
+ *        token bucket but with a single atomic state: the theoretical arrival
+ *        time of the next signal.
+ * @param arrivalTime The theoretical arrival time, in nanoseconds.
+ * @param now The current time, in nanoseconds.
+ * @param interval The time between signals at the maximum rate.
+ * @param tolerance How early a signal can arrive, (burst - 1) * interval.
+ * @return Returns true if the signal is admitted and false otherwise.
+ */
+static bool admitSignal(QAtomicInteger<qint64>& arrivalTime, qint64 now
+                        , qint64 interval, qint64 tolerance) {
+    qint64 current = arrivalTime.loadAcquire();
+    forever {
+        const qint64 start = qMax(current, now);
+        if(start - now > tolerance) {
+            return false;
+        }
+        if(arrivalTime.testAndSetOrdered(current, start + interval, current)) {
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Translation table between signal indexes and method indexes of a
+ *        QMetaObject.
+ * @details The tables are built lazily, once per QMetaObject, and are shared by
+ *          all threads. Each thread caches the tables it already used so the
+ *          lookup only locks the first time a thread meets a QMetaObject.
+ *          Dynamic meta objects can be freed and their address reused by a
+ *          different meta object, so each table keeps the identity of the
+ *          meta object it was built for and is rebuilt when it no longer
+ *          matches. A replaced table is freed when no thread caches it.
+ */
+class QSignalIndexes {
+
+public:
+
+    enum { INDEX_UNKNOWN = QSignalSlotMonitor::SignalInfo::INDEX_UNKNOWN };
+
+    typedef QSharedPointer<const QSignalIndexes> Pointer;
+
+    /**
+     * @brief Returns the tables of the given meta object.
+     * @note The returned reference is valid until the calling thread looks up
+     *       the tables of a different meta object at the same address.
+     */
+    static const QSignalIndexes& forMetaObject(const QMetaObject* metaObject) {
+        Pointer& cached = _cache[metaObject];
+        if(! cached || ! cached->isFor(metaObject)) {
+            QMutexLocker locker(&_mutex);
+            Pointer& indexes = _indexes[metaObject];
+            if(! indexes || ! indexes->isFor(metaObject)) {
+                indexes = Pointer(new QSignalIndexes(metaObject));
+            }
+            cached = indexes;
+        }
+        return *cached;
+    }
+
+    /**
+     * @brief Returns true if these tables were built for the given meta object
+     *        and false if it is a different meta object at the same address.
+     * @note Only compares pointers, the method offset and count walk the
+     *       superclass chain and are only computed when the tables are built.
+     */
+    inline bool isFor(const QMetaObject* metaObject) const {
+        return metaObject->d.data == _data
+                && metaObject->d.stringdata == _stringdata
+                && metaObject->d.superdata == _superdata;
+    }
+
+    inline int getSignalIndex(int methodIndex) const {
+        return _signalIndexes.value(methodIndex, INDEX_UNKNOWN);
+    }
+
+    inline int getMethodIndex(int signalIndex) const {
+        return _methodIndexes.value(signalIndex, INDEX_UNKNOWN);
+    }
+
+    /** @brief Number of monitors that can use Sampling::PerSignalRate at once. */
+    enum { SAMPLING_SLOT_COUNT = 32 };
+
+    /**
+     * @brief Returns true if the signal with the given index is admitted by
+     *        its own rate limiter of the given sampling slot.
+     * @see admitSignal()
+     */
+    inline bool admitSignal(int samplingSlot, int signalIndex, qint64 now
+                            , qint64 interval, qint64 tolerance) const {
+        if(signalIndex < 0 || signalIndex >= _methodIndexes.count()) {
+            return true;
+        }
+        QAtomicInteger<qint64>* arrivalTimes = _arrivalTimes[samplingSlot].loadAcquire();
+        if(! arrivalTimes) {
+            QAtomicInteger<qint64>* const newArrivalTimes
+                    = new QAtomicInteger<qint64>[_methodIndexes.count()]();
+            if(_arrivalTimes[samplingSlot].testAndSetOrdered(
+                   nullptr, newArrivalTimes, arrivalTimes)) {
+                arrivalTimes = newArrivalTimes;
+            } else {
+                delete[] newArrivalTimes;
+            }
+        }
+        return ::admitSignal(arrivalTimes[signalIndex], now, interval, tolerance);
+    }
+
+    /**
+     * @brief Resets the rate limiters of the given sampling slot of all the
+     *        tables, for the next monitor that uses the slot.
+     */
+    static void resetSamplingSlot(int samplingSlot) {
+        QMutexLocker locker(&_mutex);
+        for(const Pointer& indexes : _indexes) {
+            QAtomicInteger<qint64>* const arrivalTimes
+                    = indexes->_arrivalTimes[samplingSlot].loadAcquire();
+            if(arrivalTimes) {
+                for(int I = 0; I < indexes->_methodIndexes.count(); ++I) {
+                    arrivalTimes[I].storeRelease(0);
+                }
+            }
+        }
+    }
+
+    ~QSignalIndexes() {
+        for(const auto& arrivalTimes : _arrivalTimes) {
+            delete[] arrivalTimes.load();
+        }
+    }
+
+private:
+
+    explicit QSignalIndexes(const QMetaObject* metaObject)
+        : _data(metaObject->d.data)
+        , _stringdata(metaObject->d.stringdata)
+        , _superdata(metaObject->d.superdata) {
+        const int methodCount = metaObject->methodCount();
+        _signalIndexes.fill(INDEX_UNKNOWN, methodCount);
+        _methodIndexes.reserve(methodCount);
+        for(int methodIndex = 0; methodIndex < methodCount; ++methodIndex) {
+            if(metaObject->method(methodIndex).methodType() == QMetaMethod::Signal) {
+                _signalIndexes[methodIndex] = _methodIndexes.count();
+                _methodIndexes.append(methodIndex);
+            }
+        }
+        _methodIndexes.squeeze();
+    }
+
+    /** @brief Identity of the meta object the tables were built for. */
+    const uint* const _data;
+    const QByteArrayData* const _stringdata;
+    const QMetaObject* const _superdata;
+    /** @brief Method index of each signal index. */
+    QVector<int> _methodIndexes;
+    /** @brief Signal index of each method index (INDEX_UNKNOWN if not a signal). */
+    QVector<int> _signalIndexes;
+    /** @brief Rate limiter state of each signal index, for Sampling::PerSignalRate,
+     *         of each sampling slot. Allocated on first use. */
+    mutable QAtomicPointer<QAtomicInteger<qint64>> _arrivalTimes[SAMPLING_SLOT_COUNT];
+
+    static thread_local QHash<const QMetaObject*, Pointer> _cache;
+    static QHash<const QMetaObject*, Pointer> _indexes;
+    static QMutex _mutex;
+
+};
+
+thread_local QHash<const QMetaObject*, QSignalIndexes::Pointer> QSignalIndexes::_cache;
+QHash<const QMetaObject*, QSignalIndexes::Pointer> QSignalIndexes::_indexes;
+QMutex QSignalIndexes::_mutex;
+
+/**
+ * @brief Decides which signals are forwarded to a monitor.
+ * @details The settings are independent atomics, with the mode stored last, so
+ *          the decision never locks.
+ */
+class QSignalSampling {
+
+public:
+
+    typedef QSignalSlotMonitor::Sampling Sampling;
+
+    QSignalSampling()
+        : _mode(static_cast<int>(Sampling::All))
+        , _rate(1)
+        , _burst(1)
+        , _interval(1000000000)
+        , _tolerance(0)
+        , _arrivalTime(0)
+        , _counter(0)
+        , _samplingSlot(-1) {
+    }
+
+    ~QSignalSampling() {
+        set(Sampling::All, 1, 1);
+    }
+
+    void set(Sampling sampling, int rate, int burst) {
+        Q_ASSERT(rate > 0);
+        Q_ASSERT(burst > 0);
+        QMutexLocker locker(&_mutex);
+        rate = qMax(rate, 1);
+        burst = qMax(burst, 1);
+        const Sampling previous = getMode();
+        if(previous == Sampling::PerSignalRate && sampling != Sampling::PerSignalRate) {
+            releaseSamplingSlot(_samplingSlot.fetchAndStoreOrdered(-1));
+        } else if(previous != Sampling::PerSignalRate && sampling == Sampling::PerSignalRate) {
+            const int samplingSlot = acquireSamplingSlot();
+            if(samplingSlot < 0) {
+                qWarning("QSignalSlotMonitor: at most %d monitors can use"
+                         " Sampling::PerSignalRate at once, using"
+                         " Sampling::TokenBucket instead."
+                         , static_cast<int>(QSignalIndexes::SAMPLING_SLOT_COUNT));
+                sampling = Sampling::TokenBucket;
+            }
+            _samplingSlot.storeRelease(samplingSlot);
+        }
+        const qint64 interval = qMax<qint64>(1000000000 / rate, 1);
+        _rate.storeRelease(rate);
+        _burst.storeRelease(burst);
+        _interval.storeRelease(interval);
+        _tolerance.storeRelease(interval * (burst - 1));
+        _arrivalTime.storeRelease(0);
+        _counter.storeRelease(0);
+        _mode.storeRelease(static_cast<int>(sampling));
+        if(previous == Sampling::All && sampling != Sampling::All) {
+            _samplingCount.ref();
+        } else if(previous != Sampling::All && sampling == Sampling::All) {
+            _samplingCount.deref();
+        }
+    }
+
+    inline Sampling getMode() const {
+        return static_cast<Sampling>(_mode.loadAcquire());
+    }
+
+    inline int getRate() const {
+        return _rate.loadAcquire();
+    }
+
+    inline int getBurst() const {
+        return _burst.loadAcquire();
+    }
+
+    /**
+     * @brief Returns true if some monitor samples the signals, i.e. does not
+     *        use Sampling::All.
+     */
+    static inline bool isAnySampling() {
+        return _samplingCount.loadAcquire() != 0;
+    }
+
+    /**
+     * @brief Returns true if the given signal is to be forwarded to the monitor.
+     */
+    inline bool isSampled(const QObject* signaler, int signalIndex) {
+        switch(getMode()) {
+        case Sampling::All:
+            return true;
+        case Sampling::OneInN:
+            return (_counter.fetchAndAddRelaxed(1) + 1)
+                    % static_cast<quint32>(_rate.loadAcquire()) == 0;
+        case Sampling::PerSignalRate: {
+            const int samplingSlot = _samplingSlot.loadAcquire();
+            return samplingSlot < 0
+                    || QSignalIndexes::forMetaObject(signaler->metaObject())
+                    .admitSignal(samplingSlot, signalIndex, now()
+                                 , _interval.loadAcquire(), _tolerance.loadAcquire());
+        }
+        case Sampling::TokenBucket:
+            return ::admitSignal(_arrivalTime, now(), _interval.loadAcquire()
+                                 , _tolerance.loadAcquire());
+        }
+        return true;
+    }
+
+private:
+
+    static qint64 now() {
+        static const QElapsedTimer timer = startedTimer();
+        return timer.nsecsElapsed();
+    }
+
+    static QElapsedTimer startedTimer() {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }
+
+    /**
+     * @brief Returns a free sampling slot, with its rate limiters reset, or -1
+     *        if all the slots are in use.
+     */
+    static int acquireSamplingSlot() {
+        forever {
+            const quint32 usedSlots = _usedSamplingSlots.loadAcquire();
+            int samplingSlot = 0;
+            while(samplingSlot < QSignalIndexes::SAMPLING_SLOT_COUNT
+                  && (usedSlots & (1u << samplingSlot)) != 0) {
+                ++samplingSlot;
+            }
+            if(samplingSlot == QSignalIndexes::SAMPLING_SLOT_COUNT) {
+                return -1;
+            }
+            if(_usedSamplingSlots.testAndSetOrdered(usedSlots, usedSlots | (1u << samplingSlot))) {
+                QSignalIndexes::resetSamplingSlot(samplingSlot);
+                return samplingSlot;
+            }
+        }
+    }
+
+    static void releaseSamplingSlot(int samplingSlot) {
+        if(samplingSlot >= 0) {
+            _usedSamplingSlots.fetchAndAndOrdered(~(1u << samplingSlot));
+        }
+    }
+
+    QAtomicInt _mode;
+    QAtomicInt _rate;
+    QAtomicInt _burst;
+    QAtomicInteger<qint64> _interval;
+    QAtomicInteger<qint64> _tolerance;
+    QAtomicInteger<qint64> _arrivalTime;
+    QAtomicInteger<quint32> _counter;
+    QAtomicInt _samplingSlot;
+    QMutex _mutex;
+
+    static QAtomicInt _samplingCount;
+    static QAtomicInteger<quint32> _usedSamplingSlots;
+
+};
+
+QAtomicInt QSignalSampling::_samplingCount;
+QAtomicInteger<quint32> QSignalSampling::_usedSamplingSlots;
+
+void QSignalSlotMonitorData::sampleSignal(QSignalSlotMonitor::SignalInfo& signalInfo
+                                          , const Monitors& monitors) {
+    if(! QSignalSampling::isAnySampling()) {
+        return;
+    }
+    signalInfo._sampledMonitorsIndex = _sampledMonitors.count();
+    for(QSignalSlotMonitor* monitor : monitors) {
+        if(monitor->_sampling->isSampled(signalInfo.getSignaler()
+                                         , signalInfo.getSignalIndex())) {
+            _sampledMonitors.append(monitor);
+        }
+    }
+}
 
 QSignalSlotMonitor::QSignalSlotMonitor(QObject* parent)
-    : QObject(parent) {
-    QSignalSlotMonitorData data;
-    auto& signalInfos = data.getSignalInfos();
-    signalInfos.reserve(32);
+    : QObject(parent)
+    , _sampling(new QSignalSampling())
+    , _generation(0) {
+    auto& signalInfos = QSignalSlotMonitorData::getSignalInfos();
+    if(signalInfos.capacity() < 32) {
+        signalInfos.reserve(32);
+    }
+    auto& sampledMonitors = QSignalSlotMonitorData::getSampledMonitors();
+    if(sampledMonitors.capacity() < 32) {
+        sampledMonitors.reserve(32);
+    }
 }
 
 QSignalSlotMonitor::~QSignalSlotMonitor() {
     disableMonitor();
+    delete _sampling;
 }
 
 bool QSignalSlotMonitor::isMonitorEnabled() const {
-    QSignalSlotMonitorData data;
-    auto& monitors = data.getMonitors();
-    return monitors.contains(const_cast<QSignalSlotMonitor*>(this));
+    return QSignalSlotMonitorData().getMonitors()
+            .contains(const_cast<QSignalSlotMonitor*>(this));
 }
 
 void QSignalSlotMonitor::enableMonitor() {
-    QSignalSlotMonitorData data;
-    auto& monitors = data.getMonitors();
-    if(monitors.contains(this)) {
-        return;
-    }
-    if(monitors.isEmpty()) {
-        static const QSignalSpyCallbackSet callbackSet = {
-            &signalBeginCallback, &slotBeginCallback,
-            &signalEndCallback, &slotEndCallback
-        };
-        qt_register_signal_spy_callbacks(callbackSet);
+    if(QSignalSlotMonitorData::enableMonitor(this)) {
+        monitorEnabledChanged(true);
     }
-    monitors.append(this);
 }
 
 void QSignalSlotMonitor::disableMonitor() {
-    QSignalSlotMonitorData data;
-    auto& monitors = data.getMonitors();
-    if(monitors.removeOne(this) && monitors.isEmpty()) {
-        static const QSignalSpyCallbackSet nullCallbackSet
-                = {nullptr, nullptr, nullptr, nullptr};
-        qt_register_signal_spy_callbacks(nullCallbackSet);
+    if(QSignalSlotMonitorData::disableMonitor(this)) {
+        monitorEnabledChanged(false);
     }
 }
 
+int QSignalSlotMonitor::getMonitorGeneration() const {
+    return _generation.loadAcquire();
+}
+
 void QSignalSlotMonitor::enableThreadSafe() {
     QSignalSlotMonitorData::enableThreadSafeAccess();
 }
@@ -133,6 +672,22 @@ void QSignalSlotMonitor::disableThreadSafe() {
     QSignalSlotMonitorData::disableThreadSafeAccess();
 }
 
+void QSignalSlotMonitor::setSampling(Sampling sampling, int rate, int burst) {
+    _sampling->set(sampling, rate, burst);
+}
+
+QSignalSlotMonitor::Sampling QSignalSlotMonitor::getSampling() const {
+    return _sampling->getMode();
+}
+
+int QSignalSlotMonitor::getSamplingRate() const {
+    return _sampling->getRate();
+}
+
+int QSignalSlotMonitor::getSamplingBurst() const {
+    return _sampling->getBurst();
+}
+
 void QSignalSlotMonitor::signalBegin(const SignalInfo& signalInfo) {
     Q_UNUSED(signalInfo);
 }
@@ -153,55 +708,67 @@ void QSignalSlotMonitor::slotEnd(const SignalInfo& signalInfo
     Q_UNUSED(slotInfo);
 }
 
+void QSignalSlotMonitor::monitorEnabledChanged(bool enabled) {
+    Q_UNUSED(enabled);
+}
+
 void QSignalSlotMonitor::signalBeginCallback(QObject* signaler, int signalIndex
                                              , void** signalParametersPointers) {
-    QSignalSlotMonitorData data;
-    auto& signalInfos = data.getSignalInfos();
-    auto& monitors = data.getMonitors();
+    auto& signalInfos = QSignalSlotMonitorData::getSignalInfos();
     SignalInfo signalInfo(signaler, signalIndex, -1, signalParametersPointers);
+    QSignalSlotMonitorData data;
+    QSignalSlotMonitorData::sampleSignal(signalInfo, data.getMonitors());
     signalInfos.push_back(signalInfo);
-    for(QSignalSlotMonitor* monitor : monitors) {
-        monitor->signalBegin(signalInfo);
+    for(QSignalSlotMonitor* monitor : data.getMonitors()) {
+        if(QSignalSlotMonitorData::isSampledBy(signalInfo, monitor)) {
+            monitor->signalBegin(signalInfo);
+        }
     }
 }
 
 void QSignalSlotMonitor::signalEndCallback(QObject* signaler, int signalIndex) {
-    QSignalSlotMonitorData data;
-    auto& signalInfos = data.getSignalInfos();
-    auto& monitors = data.getMonitors();
+    auto& signalInfos = QSignalSlotMonitorData::getSignalInfos();
     Q_ASSERT(signalInfos.size() >= 1);
     const SignalInfo& signalInfo = signalInfos.constLast();
     Q_ASSERT(signalInfo.getSignaler() == signaler);
     Q_ASSERT(signalInfo.getSignalIndex() == signalIndex);
-    for(QSignalSlotMonitor* monitor: monitors) {
-        monitor->signalEnd(signalInfo);
+    {
+        QSignalSlotMonitorData data;
+        for(QSignalSlotMonitor* monitor: data.getMonitors()) {
+            if(QSignalSlotMonitorData::isSampledBy(signalInfo, monitor)) {
+                monitor->signalEnd(signalInfo);
+            }
+        }
     }
+    QSignalSlotMonitorData::unsampleSignal(signalInfo);
     signalInfos.pop_back();
 }
 
 void QSignalSlotMonitor::slotBeginCallback(QObject* receiver, int methodIndex
                                            , void** signalParametersPointers) {
-    QSignalSlotMonitorData data;
-    auto& signalInfos = data.getSignalInfos();
-    auto& monitors = data.getMonitors();
+    const auto& signalInfos = QSignalSlotMonitorData::getSignalInfos();
     Q_ASSERT(signalInfos.size() >= 1);
     const SignalInfo& signalInfo = signalInfos.constLast();
     Q_ASSERT(signalInfo.getParametersPointers() == signalParametersPointers);
     const SlotInfo slotInfo(receiver, methodIndex);
-    for(QSignalSlotMonitor* monitor : monitors) {
-        monitor->slotBegin(signalInfo, slotInfo);
+    QSignalSlotMonitorData data;
+    for(QSignalSlotMonitor* monitor : data.getMonitors()) {
+        if(QSignalSlotMonitorData::isSampledBy(signalInfo, monitor)) {
+            monitor->slotBegin(signalInfo, slotInfo);
+        }
     }
 }
 
 void QSignalSlotMonitor::slotEndCallback(QObject* receiver, int methodIndex) {
-    QSignalSlotMonitorData data;
-    auto& signalInfos = data.getSignalInfos();
-    auto& monitors = data.getMonitors();
+    const auto& signalInfos = QSignalSlotMonitorData::getSignalInfos();
     Q_ASSERT(signalInfos.size() >= 1);
     const SignalInfo& signalInfo = signalInfos.constLast();
     const SlotInfo slotInfo(receiver, methodIndex);
-    for(QSignalSlotMonitor* monitor : monitors) {
-        monitor->slotEnd(signalInfo, slotInfo);
+    QSignalSlotMonitorData data;
+    for(QSignalSlotMonitor* monitor : data.getMonitors()) {
+        if(QSignalSlotMonitorData::isSampledBy(signalInfo, monitor)) {
+            monitor->slotEnd(signalInfo, slotInfo);
+        }
     }
 }
 
@@ -211,32 +778,16 @@ QObject* QSignalSlotMonitor::SignalInfo::getSignaler() const {
 
 int QSignalSlotMonitor::SignalInfo::getSignalIndex() const {
     if(_signalIndex == INDEX_UNKNOWN) {
-        const QMetaObject* const metaObject = _signaler->metaObject();
-        const int methodCount = metaObject->methodCount();
-        for(int methodIndex = 0, signalIndex = -1; methodIndex < methodCount ; ++methodIndex) {
-            if(metaObject->method(methodIndex).methodType() == QMetaMethod::Signal) {
-                ++signalIndex;
-                if(methodIndex == _methodIndex) {
-                    const_cast<int&>(_signalIndex) = signalIndex;
-                    break;
-                }
-            }
-        }
+        const_cast<int&>(_signalIndex) = QSignalIndexes::forMetaObject(
+                    _signaler->metaObject()).getSignalIndex(_methodIndex);
     }
     return _signalIndex;
 }
 
 int QSignalSlotMonitor::SignalInfo::getMethodIndex() const {
     if(_methodIndex == INDEX_UNKNOWN) {
-        const QMetaObject* const metaObject = _signaler->metaObject();
-        const int methodCount = metaObject->methodCount();
-        for(int methodIndex = 0, signalIndex = -1; methodIndex < methodCount; ++methodIndex) {
-            if(metaObject->method(methodIndex).methodType() == QMetaMethod::Signal
-               && (++signalIndex) == _signalIndex) {
-                const_cast<int&>(_methodIndex) = methodIndex;
-                break;
-            }
-        }
+        const_cast<int&>(_methodIndex) = QSignalIndexes::forMetaObject(
+                    _signaler->metaObject()).getMethodIndex(_signalIndex);
     }
     return _methodIndex;
 }
@@ -249,6 +800,10 @@ const void* const* QSignalSlotMonitor::SignalInfo::getParametersPointers() const
     return _parametersPointers;
 }
 
+QSignalSlotMonitor::ParametersView QSignalSlotMonitor::SignalInfo::getParametersView() const {
+    return ParametersView(getMetaMethod(), _parametersPointers);
+}
+
 const QVector<QVariant>& QSignalSlotMonitor::SignalInfo::getParameters() const {
     if(getMetaMethod().parameterCount() != _parameters.count()) {
         const_cast<SignalInfo*>(this)->processParameters();
@@ -258,23 +813,9 @@ const QVector<QVariant>& QSignalSlotMonitor::SignalInfo::getParameters() const {
 
 void QSignalSlotMonitor::SignalInfo::processParameters() {
     Q_ASSERT(_signaler);
-    const QMetaMethod metaMethod = getMetaMethod();
-    Q_ASSERT(metaMethod.isValid());
-    Q_ASSERT(metaMethod.methodType() == QMetaMethod::Signal);
-    const int parameterCount = metaMethod.parameterCount();
-    Q_ASSERT(_parametersPointers || parameterCount == 0);
-    _parameters.reserve(parameterCount);
-    for(int I = 0 ; I < parameterCount; ++I) {
-        const QMetaType::Type type
-                = static_cast<QMetaType::Type>(metaMethod.parameterType(I));
-        // I + 1 because the parameter pointers start at index 1.
-        const void* const parameterPointer = _parametersPointers[I + 1];
-        if(type == QMetaType::QVariant) {
-            _parameters.append(*reinterpret_cast<const QVariant*>(parameterPointer));
-        } else {
-            _parameters.append(QVariant(type, parameterPointer));
-        }
-    }
+    Q_ASSERT(getMetaMethod().isValid());
+    Q_ASSERT(getMetaMethod().methodType() == QMetaMethod::Signal);
+    _parameters = getParametersView().toVariants();
 }
 
 QSignalSlotMonitor::SignalInfo::SignalInfo(QObject* signaler
@@ -284,7 +825,8 @@ QSignalSlotMonitor::SignalInfo::SignalInfo(QObject* signaler
     , _signalIndex(signalIndex)
     , _methodIndex(methodIndex)
     , _parametersPointers(parametersPointers)
-    , _parameters() {
+    , _parameters()
+    , _sampledMonitorsIndex(-1) {
     Q_ASSERT(signaler);
     Q_ASSERT(signalIndex >= 0 || methodIndex >= 0);
     Q_ASSERT(parametersPointers);
@@ -296,6 +838,69 @@ QSignalSlotMonitor::SignalInfo::SignalInfo(QObject* signaler
     Q_ASSERT(getMetaMethod().methodType() == QMetaMethod::Signal);
 }
 
+QSignalSlotMonitor::Parameter::Parameter(int typeId, const void* data)
+    : _typeId(typeId)
+    , _data(data) {
+}
+
+int QSignalSlotMonitor::Parameter::getTypeId() const {
+    return _typeId;
+}
+
+const void* QSignalSlotMonitor::Parameter::getData() const {
+    return _data;
+}
+
+QVariant QSignalSlotMonitor::Parameter::toVariant() const {
+    if(_typeId == QMetaType::QVariant) {
+        return *static_cast<const QVariant*>(_data);
+    }
+    return QVariant(_typeId, _data);
+}
+
+int QSignalSlotMonitor::ParametersView::count() const {
+    return _count;
+}
+
+bool QSignalSlotMonitor::ParametersView::isEmpty() const {
+    return _count == 0;
+}
+
+QSignalSlotMonitor::Parameter QSignalSlotMonitor::ParametersView::at(int index) const {
+    Q_ASSERT(index >= 0 && index < _count);
+    // index + 1 because the parameter pointers start at index 1.
+    return Parameter(_metaMethod.parameterType(index), _parametersPointers[index + 1]);
+}
+
+QSignalSlotMonitor::Parameter QSignalSlotMonitor::ParametersView::operator[](int index) const {
+    return at(index);
+}
+
+QSignalSlotMonitor::ParametersView::const_iterator QSignalSlotMonitor::ParametersView::begin() const {
+    return const_iterator(this, 0);
+}
+
+QSignalSlotMonitor::ParametersView::const_iterator QSignalSlotMonitor::ParametersView::end() const {
+    return const_iterator(this, _count);
+}
+
+QVector<QVariant> QSignalSlotMonitor::ParametersView::toVariants() const {
+    QVector<QVariant> variants;
+    variants.reserve(_count);
+    for(const Parameter parameter : *this) {
+        variants.append(parameter.toVariant());
+    }
+    return variants;
+}
+
+QSignalSlotMonitor::ParametersView::ParametersView(const QMetaMethod& metaMethod
+                                                   , const void* const* parametersPointers)
+    : _metaMethod(metaMethod)
+    , _parametersPointers(parametersPointers)
+    , _count(metaMethod.parameterCount()) {
+    Q_ASSERT(_parametersPointers || _count == 0);
+}
+
 QObject* QSignalSlotMonitor::SlotInfo::getReceiver() const {
     return _receiver;
 }
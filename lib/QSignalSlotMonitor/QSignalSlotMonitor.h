@@ -20,14 +20,19 @@
 #define QSIGNALSLOTMONITOR_H
 
 #include <QObject>
+#include <QAtomicInt>
 #include <QVector>
 #include <QVariant>
 #include <QMetaMethod>
 
+class QSignalSampling;
+class QSignalSlotMonitorData;
+
 class QSignalSlotMonitor : public QObject {
     Q_OBJECT
 
     friend class QSignalSlotMonitorData;
+    friend class QSignalIndexes;
 
 public:
 
@@ -50,32 +55,211 @@ public:
 
     /**
      * @brief Enables the monitor.
+     * @note Monitors can be enabled and disabled from any thread.
      */
     void enableMonitor();
 
     /**
      * @brief Disables the monitor.
+     * @note When called from outside of the monitors' callbacks, this function
+     *       only returns after every callback running in other threads that
+     *       could still call this monitor has returned, so the monitor can be
+     *       safely destroyed afterwards.
+     *       When called from inside a callback it does not wait, so a monitor
+     *       disabled from a callback should be destroyed with deleteLater().
      */
     void disableMonitor();
 
     /**
-     * @brief Enable thread safe monitoring.
-     * @note Thread safe monitoring is disabled by default, to avoid overhead.
-     *       On threaded programs, this function should be called before enabling
-     *       monitoring.
+     * @brief Enables thread safe monitoring: the callbacks of all the monitors
+     *        run under a single lock, so monitors that do not synchronize
+     *        their own state can receive signals from several threads.
+     * @note Disabled by default, to avoid overhead. When disabled, the
+     *       callbacks of different threads run concurrently and each monitor
+     *       must synchronize itself.
      */
     static void enableThreadSafe();
 
     /**
-     * @brief Disable thread safe monitoring.
-     * @note Thread safe monitoring is disabled by default, to avoid overhead.
+     * @brief Disables thread safe monitoring.
+     * @see enableThreadSafe()
      */
     static void disableThreadSafe();
 
+    /**
+     * @brief Which of the emited signals are forwarded to a monitor.
+     */
+    enum class Sampling {
+        /** Every signal (the default). */
+        All,
+        /** One in every rate signals, counted over all threads. */
+        OneInN,
+        /** At most rate signals per second, with bursts of up to burst
+         *  signals, for each signal of each class. */
+        PerSignalRate,
+        /** At most rate signals per second, with bursts of up to burst
+         *  signals, for all the signals. */
+        TokenBucket
+    };
+
+    /**
+     * @brief Sets which of the emited signals are forwarded to this monitor.
+     * @param sampling The sampling mode.
+     * @param rate For Sampling::OneInN, one in every rate signals is forwarded.
+     *             For Sampling::PerSignalRate and Sampling::TokenBucket, the
+     *             maximum signals per second that are forwarded.
+     *             Must be greater than zero.
+     * @param burst For Sampling::PerSignalRate and Sampling::TokenBucket, the
+     *              maximum signals that are forwarded in a burst.
+     *              Must be greater than zero.
+     * @note The sampling decision is made for each monitor before its
+     *       callbacks are called. The slot callbacks of a signal that is not
+     *       sampled are skipped too.
+     * @note At most 32 monitors can use Sampling::PerSignalRate at once. The
+     *       others use Sampling::TokenBucket instead.
+     * @note Can be called from any thread. Signals already being dispatched
+     *       keep the decision made when they were emited.
+     */
+    void setSampling(Sampling sampling, int rate = 1, int burst = 1);
+
+    /**
+     * @brief Returns the sampling mode.
+     * @return
+     */
+    Sampling getSampling() const;
+
+    /**
+     * @brief Returns the sampling rate.
+     * @return
+     */
+    int getSamplingRate() const;
+
+    /**
+     * @brief Returns the sampling burst.
+     * @return
+     */
+    int getSamplingBurst() const;
+
 protected:
 
+    class SignalInfo;
+
+    class Parameter {
+
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param typeId The parameter's type id.
+         * @param data Pointer to the parameter's value.
+         */
+        Parameter(int typeId, const void* data);
+
+        /**
+         * @brief Returns the parameter's type id.
+         * @return
+         */
+        int getTypeId() const;
+
+        /**
+         * @brief Returns the pointer to the parameter's value.
+         * @warning The pointer is only valid while the signal is being handled.
+         * @return
+         */
+        const void* getData() const;
+
+        /**
+         * @brief Returns a reference to the parameter's value, without copying it.
+         * @note TYPE must be the parameter's type.
+         * @warning The reference is only valid while the signal is being handled.
+         * @return
+         */
+        template<typename TYPE>
+        const TYPE& getValue() const;
+
+        /**
+         * @brief Returns a copy of the parameter's value in a QVariant.
+         *        If the parameter is a QVariant, returns a copy of it.
+         * @return
+         */
+        QVariant toVariant() const;
+
+    private:
+
+        int _typeId;
+        const void* _data;
+    };
+
+    class ParametersView {
+
+        friend class SignalInfo;
+
+    public:
+
+        class const_iterator {
+
+        public:
+
+            const_iterator(const ParametersView* view, int index)
+                : _view(view), _index(index) {}
+            Parameter operator*() const { return _view->at(_index); }
+            const_iterator& operator++() { ++_index; return *this; }
+            bool operator==(const const_iterator& other) const { return _index == other._index; }
+            bool operator!=(const const_iterator& other) const { return _index != other._index; }
+
+        private:
+
+            const ParametersView* _view;
+            int _index;
+        };
+
+        /**
+         * @brief Returns the number of parameters.
+         * @return
+         */
+        int count() const;
+
+        /**
+         * @brief Returns true if there are no parameters.
+         * @return
+         */
+        bool isEmpty() const;
+
+        /**
+         * @brief Returns the parameter at the given index.
+         * @param index Parameter index. Must be greater or equal to zero and
+         *              less than count().
+         * @return
+         */
+        Parameter at(int index) const;
+
+        /**
+         * @brief Same as at().
+         */
+        Parameter operator[](int index) const;
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        /**
+         * @brief Returns a vector with a copy of the parameters' values.
+         * @return
+         */
+        QVector<QVariant> toVariants() const;
+
+    private:
+
+        ParametersView(const QMetaMethod& metaMethod
+                       , const void* const* parametersPointers);
+
+        QMetaMethod _metaMethod;
+        const void* const* _parametersPointers;
+        int _count;
+    };
+
     class SignalInfo {
         template<typename T> friend class QVector;
+        friend class ::QSignalSlotMonitorData;
 
     public:
 
@@ -125,13 +309,24 @@ protected:
 
         /**
          * @brief Returns the pointer to signal's parameters.
-         * @note Use getParameters() if you want to acces the parameters values.
+         * @note Use getParametersView() or getParameters() if you want to
+         *       acces the parameters values.
          * @return
          */
         const void* const* getParametersPointers() const;
 
+        /**
+         * @brief Returns a non owning view of the signal's parameters.
+         *        Values are read in place, with no copies or allocations.
+         * @warning The view is only valid while the signal is being handled.
+         * @return
+         */
+        ParametersView getParametersView() const;
+
         /**
          * @brief Returns the signal's parameters.
+         * @note The parameters are copied into QVariants on the first call.
+         *       Use getParametersView() to avoid the copies.
          * @return
          */
         const QVector<QVariant>& getParameters() const;
@@ -153,6 +348,9 @@ protected:
         int _methodIndex;
         const void* const* _parametersPointers;
         QVector<QVariant> _parameters;
+        /** @brief Index of the first monitor that sampled the signal in the
+         *         thread's stack, or -1 if every monitor receives it. */
+        int _sampledMonitorsIndex;
     };
 
     class SlotInfo {
@@ -191,6 +389,15 @@ protected:
         int _methodIndex;
     };
 
+    /**
+     * @brief Returns the monitor's generation, which changes every time the
+     *        monitor is enabled.
+     * @note Monitors that keep per thread stacks of signals or slots tag their
+     *       frames with it, so the frames left open by a previous enabling
+     *       can be told apart from the current ones.
+     */
+    int getMonitorGeneration() const;
+
 private:
 
     /**
@@ -221,6 +428,16 @@ private:
      */
     virtual void slotEnd(const SignalInfo& signalInfo, const SlotInfo& slotInfo);
 
+    /**
+     * @brief This function is called after the monitor is enabled or disabled,
+     *        in the thread that enabled or disabled it.
+     * @param enabled True if the monitor was enabled and false if it was
+     *                disabled.
+     * @note Monitors that override it must disable themselves in their
+     *       destructor, because it is not called by this class' destructor.
+     */
+    virtual void monitorEnabledChanged(bool enabled);
+
     /**
      * @brief This functions is called by Qt's internal signal dispatcher at the
      *        beginning of the signal handling.
@@ -263,6 +480,15 @@ private:
      */
     static void slotEndCallback(QObject* signaler, int slotMethodIndex);
 
+    QSignalSampling* const _sampling;
+    QAtomicInt _generation;
+
 };
 
+template<typename TYPE>
+const TYPE& QSignalSlotMonitor::Parameter::getValue() const {
+    Q_ASSERT(_typeId == qMetaTypeId<TYPE>());
+    return *static_cast<const TYPE*>(_data);
+}
+
 #endif // QSIGNALSLOTMONITOR_H
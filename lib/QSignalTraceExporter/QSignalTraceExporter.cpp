@@ -0,0 +1,282 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QSignalTraceExporter.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QAtomicInt>
+
+#include <chrono>
+
+/* Sequential ids of the threads, shorter than the native ones in the trace. */
+static QAtomicInt nextThreadId(0);
+static thread_local int currentThreadId = 0;
+
+/* Set while a thread writes to the device, to ignore the signals emited by it. */
+static thread_local bool writingChunk = false;
+
+static inline int getThreadId() {
+    if(currentThreadId == 0) {
+        currentThreadId = nextThreadId.fetchAndAddOrdered(1) + 1;
+    }
+    return currentThreadId;
+}
+
+/**
+ * @brief Returns the monotonic clock's time in nanoseconds, the same clock used
+ *        by other tracing tools, so the traces can be shown together.
+ */
+static inline qint64 getTimestamp() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void appendNumber(QByteArray& buffer, qint64 number) {
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    char* begin = end;
+    const bool negative = number < 0;
+    quint64 value = negative ? 0 - static_cast<quint64>(number) : static_cast<quint64>(number);
+    do {
+        *--begin = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while(value != 0);
+    if(negative) {
+        *--begin = '-';
+    }
+    buffer.append(begin, static_cast<int>(end - begin));
+}
+
+/**
+ * @brief Appends the given nanoseconds as microseconds with 3 decimals.
+ */
+static void appendMicroseconds(QByteArray& buffer, qint64 nanoseconds) {
+    appendNumber(buffer, nanoseconds / 1000);
+    const int fraction = static_cast<int>(nanoseconds % 1000);
+    const char decimals[4] = {
+        '.'
+        , static_cast<char>('0' + fraction / 100)
+        , static_cast<char>('0' + fraction / 10 % 10)
+        , static_cast<char>('0' + fraction % 10)
+    };
+    buffer.append(decimals, 4);
+}
+
+static void appendAddress(QByteArray& buffer, const void* address) {
+    static const char hex[] = "0123456789abcdef";
+    char digits[2 + 2 * sizeof(quintptr)];
+    quintptr value = reinterpret_cast<quintptr>(address);
+    digits[0] = '0';
+    digits[1] = 'x';
+    for(int index = static_cast<int>(sizeof(digits)) - 1; index >= 2; --index) {
+        digits[index] = hex[value & 0xF];
+        value >>= 4;
+    }
+    buffer.append(digits, sizeof(digits));
+}
+
+/**
+ * @brief Appends the given UTF-8 text as a JSON string, with the quotes.
+ */
+static void appendJsonString(QByteArray& buffer, const QByteArray& text) {
+    static const char hex[] = "0123456789abcdef";
+    buffer.append('"');
+    for(const char character : text) {
+        const uchar code = static_cast<uchar>(character);
+        if(character == '"' || character == '\\') {
+            buffer.append('\\');
+            buffer.append(character);
+        } else if(code < 0x20) {
+            buffer.append("\\u00", 4);
+            buffer.append(hex[code >> 4]);
+            buffer.append(hex[code & 0xF]);
+        } else {
+            buffer.append(character);
+        }
+    }
+    buffer.append('"');
+}
+
+QSignalTraceExporter::QSignalTraceExporter(QObject* parent, QIODevice* device, int chunkSize)
+    : QSignalSlotMonitor(parent)
+    , _mutex()
+    , _targetQIODevice(device)
+    , _chunkSize(qMax(chunkSize, 0))
+    , _chunk()
+    , _processId(QByteArray::number(QCoreApplication::applicationPid()))
+    , _names()
+    , _namedThreads()
+    , _started(false) {
+    Q_ASSERT(chunkSize >= 0);
+    _chunk.reserve(_chunkSize + 1024);
+}
+
+QSignalTraceExporter::~QSignalTraceExporter() {
+    disableMonitor();
+    close();
+}
+
+QIODevice* QSignalTraceExporter::getTargetQIODevice() const {
+    QMutexLocker locker(&_mutex);
+    return _targetQIODevice;
+}
+
+void QSignalTraceExporter::setTargetQIODevice(QIODevice* device) {
+    QMutexLocker locker(&_mutex);
+    if(_started) {
+        _chunk.append("\n]\n");
+        writeChunk(true);
+        _started = false;
+    }
+    _targetQIODevice = device;
+    _namedThreads.clear();
+}
+
+int QSignalTraceExporter::getChunkSize() const {
+    QMutexLocker locker(&_mutex);
+    return _chunkSize;
+}
+
+void QSignalTraceExporter::setChunkSize(int chunkSize) {
+    Q_ASSERT(chunkSize >= 0);
+    QMutexLocker locker(&_mutex);
+    _chunkSize = qMax(chunkSize, 0);
+    writeChunk(false);
+}
+
+void QSignalTraceExporter::flush() {
+    QMutexLocker locker(&_mutex);
+    writeChunk(true);
+}
+
+void QSignalTraceExporter::close() {
+    setTargetQIODevice(nullptr);
+}
+
+void QSignalTraceExporter::signalBegin(const SignalInfo& signalInfo) {
+    writeBegin("signal", signalInfo.getSignaler(), signalInfo.getMethodIndex());
+}
+
+void QSignalTraceExporter::signalEnd(const SignalInfo& signalInfo) {
+    Q_UNUSED(signalInfo);
+    writeEnd();
+}
+
+void QSignalTraceExporter::slotBegin(const SignalInfo& signalInfo, const SlotInfo& slotInfo) {
+    Q_UNUSED(signalInfo);
+    writeBegin("slot", slotInfo.getReceiver(), slotInfo.getMethodIndex());
+}
+
+void QSignalTraceExporter::slotEnd(const SignalInfo& signalInfo, const SlotInfo& slotInfo) {
+    Q_UNUSED(signalInfo);
+    Q_UNUSED(slotInfo);
+    writeEnd();
+}
+
+void QSignalTraceExporter::writeBegin(const char* category, const QObject* object, int methodIndex) {
+    const qint64 timestamp = getTimestamp();
+    if(writingChunk) {
+        return;
+    }
+    const QString objectName = object->objectName();
+    QMutexLocker locker(&_mutex);
+    if(! _targetQIODevice) {
+        return;
+    }
+    writeEventStart('B', timestamp, getThreadId());
+    _chunk.append(",\"cat\":\"");
+    _chunk.append(category);
+    _chunk.append("\",\"name\":");
+    _chunk.append(getName(object->metaObject(), methodIndex));
+    _chunk.append(",\"args\":{\"object\":\"");
+    appendAddress(_chunk, object);
+    _chunk.append('"');
+    if(! objectName.isEmpty()) {
+        _chunk.append(",\"objectName\":");
+        appendJsonString(_chunk, objectName.toUtf8());
+    }
+    _chunk.append("}}");
+    writeChunk(false);
+}
+
+void QSignalTraceExporter::writeEnd() {
+    const qint64 timestamp = getTimestamp();
+    if(writingChunk) {
+        return;
+    }
+    QMutexLocker locker(&_mutex);
+    if(! _targetQIODevice) {
+        return;
+    }
+    writeEventStart('E', timestamp, getThreadId());
+    _chunk.append('}');
+    writeChunk(false);
+}
+
+void QSignalTraceExporter::writeEventStart(char phase, qint64 timestamp, int threadId) {
+    _chunk.append(_started ? ",\n" : "[\n");
+    _started = true;
+    if(! _namedThreads.contains(threadId)) {
+        _namedThreads.insert(threadId);
+        QString threadName = QThread::currentThread()->objectName();
+        if(threadName.isEmpty()) {
+            threadName = QStringLiteral("Thread %1").arg(threadId);
+        }
+        _chunk.append("{\"ph\":\"M\",\"pid\":");
+        _chunk.append(_processId);
+        _chunk.append(",\"tid\":");
+        appendNumber(_chunk, threadId);
+        _chunk.append(",\"name\":\"thread_name\",\"args\":{\"name\":");
+        appendJsonString(_chunk, threadName.toUtf8());
+        _chunk.append("}},\n");
+    }
+    _chunk.append("{\"ph\":\"");
+    _chunk.append(phase);
+    _chunk.append("\",\"ts\":");
+    appendMicroseconds(_chunk, timestamp);
+    _chunk.append(",\"pid\":");
+    _chunk.append(_processId);
+    _chunk.append(",\"tid\":");
+    appendNumber(_chunk, threadId);
+}
+
+const QByteArray& QSignalTraceExporter::getName(const QMetaObject* metaObject, int methodIndex) {
+    const MethodKey key(metaObject, methodIndex);
+    auto iter = _names.find(key);
+    if(iter == _names.end()) {
+        QByteArray name;
+        appendJsonString(name, QByteArray(metaObject->className()) + "::"
+                         + metaObject->method(methodIndex).methodSignature());
+        iter = _names.insert(key, name);
+    }
+    return iter.value();
+}
+
+void QSignalTraceExporter::writeChunk(bool force) {
+    if(_chunk.isEmpty() || (! force && _chunk.size() < _chunkSize)) {
+        return;
+    }
+    if(_targetQIODevice) {
+        writingChunk = true;
+        _targetQIODevice->write(_chunk);
+        writingChunk = false;
+    }
+    _chunk.truncate(0);
+}
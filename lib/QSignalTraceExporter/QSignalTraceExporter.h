@@ -0,0 +1,144 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#ifndef QSIGNALTRACEEXPORTER_H
+#define QSIGNALTRACEEXPORTER_H
+
+#include "QSignalSlotMonitor.h"
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QMutex>
+
+class QSignalTraceExporter : public QSignalSlotMonitor {
+    Q_OBJECT
+
+public:
+
+    /**
+     * @brief Constructor.
+     * @param parent
+     * @param device The QIODevice to write the trace to, or nullptr to set it
+     *               later with setTargetQIODevice().
+     * @param chunkSize Number of bytes buffered before being written to the
+     *                  device.
+     * @note The exporter must be enabled with enableMonitor() to start
+     *       exporting.
+     */
+    explicit QSignalTraceExporter(QObject* parent = nullptr, QIODevice* device = nullptr
+                                  , int chunkSize = 64 * 1024);
+
+    /**
+     * @brief Destructor.
+     * @note Disables the monitor and closes the trace.
+     */
+    ~QSignalTraceExporter();
+
+    /**
+     * @brief Returns a pointer to the current QIODevice target.
+     * @return Returns a QIODevice pointer or nullptr if none was set.
+     */
+    QIODevice* getTargetQIODevice() const;
+
+    /**
+     * @brief Closes the trace in the current QIODevice target, if any, and
+     *        starts a new trace in the given device.
+     * @param device Pointer to a QIODevice or nullptr to reset the target.
+     */
+    void setTargetQIODevice(QIODevice* device);
+
+    /**
+     * @brief Returns the number of bytes buffered before being written to the
+     *        device.
+     * @return
+     */
+    int getChunkSize() const;
+
+    /**
+     * @brief Sets the number of bytes buffered before being written to the
+     *        device.
+     * @param chunkSize Must be greater or equal to zero.
+     */
+    void setChunkSize(int chunkSize);
+
+    /**
+     * @brief Writes the buffered events to the device.
+     */
+    void flush();
+
+    /**
+     * @brief Writes the buffered events and the end of the trace to the device
+     *        and resets the target.
+     */
+    void close();
+
+private:
+
+    typedef QPair<const QMetaObject*, int> MethodKey;
+
+    virtual void signalBegin(const SignalInfo& signalInfo) override;
+    virtual void signalEnd(const SignalInfo& signalInfo) override;
+    virtual void slotBegin(const SignalInfo& signalInfo, const SlotInfo& slotInfo) override;
+    virtual void slotEnd(const SignalInfo& signalInfo, const SlotInfo& slotInfo) override;
+
+    /**
+     * @brief Appends a begin event for the given signal or slot.
+     */
+    void writeBegin(const char* category, const QObject* object, int methodIndex);
+
+    /**
+     * @brief Appends an end event.
+     */
+    void writeEnd();
+
+    /**
+     * @brief Appends the start of an event to the chunk, with the separator
+     *        from the previous event, and the metadata event naming the
+     *        calling thread if it was not written yet.
+     * @note Must be called with _mutex locked.
+     */
+    void writeEventStart(char phase, qint64 timestamp, int threadId);
+
+    /**
+     * @brief Returns the event name of the given method, already escaped.
+     * @note Must be called with _mutex locked.
+     */
+    const QByteArray& getName(const QMetaObject* metaObject, int methodIndex);
+
+    /**
+     * @brief Writes the chunk to the device if it is full.
+     * @note Must be called with _mutex locked.
+     */
+    void writeChunk(bool force);
+
+    mutable QMutex _mutex;
+    QIODevice* _targetQIODevice;
+    int _chunkSize;
+    QByteArray _chunk;
+    QByteArray _processId;
+    QHash<MethodKey, QByteArray> _names;
+    QSet<int> _namedThreads;
+    bool _started;
+
+};
+
+#endif // QSIGNALTRACEEXPORTER_H
@@ -0,0 +1,298 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+#include "QSlotProfiler.h"
+
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <limits>
+
+static const int SUB_BUCKET_BITS = QSlotProfiler::Histogram::SUB_BUCKET_BITS;
+static const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+
+QSlotProfiler::Histogram::Histogram()
+    : _count(0)
+    , _total(0)
+    , _min(0)
+    , _max(0)
+    , _buckets(BUCKET_COUNT, 0) {
+}
+
+void QSlotProfiler::Histogram::record(qint64 duration) {
+    duration = qMax<qint64>(duration, 0);
+    _min = _count == 0 ? duration : qMin(_min, duration);
+    _max = qMax(_max, duration);
+    ++_count;
+    _total += duration;
+    ++_buckets[getBucketIndex(duration)];
+}
+
+quint64 QSlotProfiler::Histogram::getCount() const {
+    return _count;
+}
+
+qint64 QSlotProfiler::Histogram::getTotal() const {
+    return _total;
+}
+
+qint64 QSlotProfiler::Histogram::getMin() const {
+    return _min;
+}
+
+qint64 QSlotProfiler::Histogram::getMax() const {
+    return _max;
+}
+
+qint64 QSlotProfiler::Histogram::getMean() const {
+    return _count == 0 ? 0 : _total / static_cast<qint64>(_count);
+}
+
+qint64 QSlotProfiler::Histogram::getPercentile(double percentile) const {
+    if(_count == 0) {
+        return 0;
+    }
+    const double target = qBound(0.0, percentile, 100.0) * _count / 100.0;
+    quint64 cumulative = 0;
+    int index = 0;
+    for(; index < BUCKET_COUNT - 1; ++index) {
+        cumulative += _buckets.at(index);
+        if(cumulative > 0 && cumulative >= target) {
+            break;
+        }
+    }
+    const qint64 lowerBound = getBucketLowerBound(index);
+    const qint64 upperBound = index == BUCKET_COUNT - 1
+            ? std::numeric_limits<qint64>::max() : getBucketLowerBound(index + 1) - 1;
+    return qBound(_min, lowerBound + (upperBound - lowerBound + 1) / 2, _max);
+}
+
+quint64 QSlotProfiler::Histogram::getBucket(int index) const {
+    Q_ASSERT(index >= 0 && index < BUCKET_COUNT);
+    return _buckets.at(index);
+}
+
+int QSlotProfiler::Histogram::getBucketIndex(qint64 duration) {
+    if(duration < SUB_BUCKET_COUNT) {
+        return static_cast<int>(qMax<qint64>(duration, 0));
+    }
+    const int msb = 63 - static_cast<int>(qCountLeadingZeroBits(static_cast<quint64>(duration)));
+    const int subBucket = static_cast<int>(duration >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1);
+    return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + subBucket;
+}
+
+qint64 QSlotProfiler::Histogram::getBucketLowerBound(int index) {
+    Q_ASSERT(index >= 0 && index < BUCKET_COUNT);
+    if(index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    const int msb = index / SUB_BUCKET_COUNT + SUB_BUCKET_BITS - 1;
+    const qint64 subBucket = index % SUB_BUCKET_COUNT;
+    return (SUB_BUCKET_COUNT + subBucket) << (msb - SUB_BUCKET_BITS);
+}
+
+const QMetaObject* QSlotProfiler::SlotStatistics::getReceiverMetaObject() const {
+    return _metaObject;
+}
+
+int QSlotProfiler::SlotStatistics::getSlotMethodIndex() const {
+    return _methodIndex;
+}
+
+QMetaMethod QSlotProfiler::SlotStatistics::getSlotMetaMethod() const {
+    return _metaObject->method(_methodIndex);
+}
+
+const QSlotProfiler::Histogram& QSlotProfiler::SlotStatistics::getHistogram() const {
+    return _histogram;
+}
+
+qint64 QSlotProfiler::Invocation::getTimestamp() const {
+    return _timestamp;
+}
+
+qint64 QSlotProfiler::Invocation::getDuration() const {
+    return _duration;
+}
+
+const void* QSlotProfiler::Invocation::getReceiverAddress() const {
+    return _receiverAddress;
+}
+
+const QMetaObject* QSlotProfiler::Invocation::getReceiverMetaObject() const {
+    return _receiverMetaObject;
+}
+
+int QSlotProfiler::Invocation::getSlotMethodIndex() const {
+    return _slotMethodIndex;
+}
+
+QMetaMethod QSlotProfiler::Invocation::getSlotMetaMethod() const {
+    return _receiverMetaObject->method(_slotMethodIndex);
+}
+
+const void* QSlotProfiler::Invocation::getSignalerAddress() const {
+    return _signalerAddress;
+}
+
+const QMetaObject* QSlotProfiler::Invocation::getSignalerMetaObject() const {
+    return _signalerMetaObject;
+}
+
+int QSlotProfiler::Invocation::getSignalMethodIndex() const {
+    return _signalMethodIndex;
+}
+
+QMetaMethod QSlotProfiler::Invocation::getSignalMetaMethod() const {
+    return _signalerMetaObject->method(_signalMethodIndex);
+}
+
+QSlotProfiler::QSlotProfiler(QObject* parent, int slowestCount)
+    : QSignalSlotMonitor(parent)
+    , _timer()
+    , _frames()
+    , _mutex()
+    , _histograms()
+    , _slowest()
+    , _slowestCount(qMax(slowestCount, 0)) {
+    Q_ASSERT(slowestCount >= 0);
+    _timer.start();
+}
+
+int QSlotProfiler::getSlowestCount() const {
+    QMutexLocker locker(&_mutex);
+    return _slowestCount;
+}
+
+void QSlotProfiler::setSlowestCount(int slowestCount) {
+    Q_ASSERT(slowestCount >= 0);
+    QMutexLocker locker(&_mutex);
+    _slowestCount = qMax(slowestCount, 0);
+    if(_slowest.count() > _slowestCount) {
+        _slowest.resize(_slowestCount);
+    }
+}
+
+QVector<QSlotProfiler::SlotStatistics> QSlotProfiler::getSlotStatistics() const {
+    QVector<SlotStatistics> statistics;
+    {
+        QMutexLocker locker(&_mutex);
+        statistics.reserve(_histograms.count());
+        for(auto iter = _histograms.constBegin(); iter != _histograms.constEnd(); ++iter) {
+            SlotStatistics slotStatistics;
+            slotStatistics._metaObject = iter.key().first;
+            slotStatistics._methodIndex = iter.key().second;
+            slotStatistics._histogram = iter.value();
+            statistics.append(slotStatistics);
+        }
+    }
+    std::sort(statistics.begin(), statistics.end()
+              , [] (const SlotStatistics& a, const SlotStatistics& b) {
+        return a.getHistogram().getTotal() > b.getHistogram().getTotal();
+    });
+    return statistics;
+}
+
+QVector<QSlotProfiler::Invocation> QSlotProfiler::getSlowestInvocations() const {
+    QMutexLocker locker(&_mutex);
+    return _slowest;
+}
+
+void QSlotProfiler::clear() {
+    QMutexLocker locker(&_mutex);
+    _histograms.clear();
+    _slowest.clear();
+}
+
+void QSlotProfiler::slotBegin(const SignalInfo& signalInfo, const SlotInfo& slotInfo) {
+    // The receiver may be deleted by the slot, so everything is taken now.
+    QObject* const receiver = slotInfo.getReceiver();
+    QObject* const signaler = signalInfo.getSignaler();
+    const Frame frame = {
+        getMonitorGeneration()
+        , 0
+        , receiver
+        , receiver->metaObject()
+        , slotInfo.getMethodIndex()
+        , signaler
+        , signaler->metaObject()
+        , signalInfo.getMethodIndex()
+    };
+    QVector<Frame>& frames = getFrames();
+    dropStaleFrames(frames);
+    frames.append(frame);
+    frames.last().start = _timer.nsecsElapsed();
+}
+
+void QSlotProfiler::slotEnd(const SignalInfo& signalInfo, const SlotInfo& slotInfo) {
+    Q_UNUSED(signalInfo);
+    const qint64 end = _timer.nsecsElapsed();
+    QVector<Frame>& frames = getFrames();
+    dropStaleFrames(frames);
+    // The profiler may have been enabled while the slot was running.
+    if(frames.isEmpty() || frames.constLast().receiverAddress != slotInfo.getReceiver()
+            || frames.constLast().slotMethodIndex != slotInfo.getMethodIndex()) {
+        return;
+    }
+    const Frame frame = frames.takeLast();
+    Invocation invocation;
+    invocation._timestamp = frame.start;
+    invocation._duration = end - frame.start;
+    invocation._receiverAddress = frame.receiverAddress;
+    invocation._receiverMetaObject = frame.receiverMetaObject;
+    invocation._slotMethodIndex = frame.slotMethodIndex;
+    invocation._signalerAddress = frame.signalerAddress;
+    invocation._signalerMetaObject = frame.signalerMetaObject;
+    invocation._signalMethodIndex = frame.signalMethodIndex;
+    QMutexLocker locker(&_mutex);
+    _histograms[SlotKey(frame.receiverMetaObject, frame.slotMethodIndex)]
+            .record(invocation._duration);
+    recordSlowest(invocation);
+}
+
+QVector<QSlotProfiler::Frame>& QSlotProfiler::getFrames() {
+    if(! _frames.hasLocalData()) {
+        QVector<Frame> frames;
+        frames.reserve(32);
+        _frames.setLocalData(frames);
+    }
+    return _frames.localData();
+}
+
+void QSlotProfiler::dropStaleFrames(QVector<Frame>& frames) const {
+    const int generation = getMonitorGeneration();
+    while(! frames.isEmpty() && frames.constLast().generation != generation) {
+        frames.removeLast();
+    }
+}
+
+void QSlotProfiler::recordSlowest(const Invocation& invocation) {
+    if(_slowestCount == 0 || (_slowest.count() == _slowestCount
+            && invocation._duration <= _slowest.constLast()._duration)) {
+        return;
+    }
+    const auto position = std::upper_bound(
+                _slowest.begin(), _slowest.end(), invocation
+                , [] (const Invocation& a, const Invocation& b) {
+        return a._duration > b._duration;
+    });
+    _slowest.insert(position, invocation);
+    if(_slowest.count() > _slowestCount) {
+        _slowest.removeLast();
+    }
+}
@@ -0,0 +1,358 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+#ifndef QSLOTPROFILER_H
+#define QSLOTPROFILER_H
+
+#include "QSignalSlotMonitor.h"
+
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QMutex>
+#include <QThreadStorage>
+#include <QElapsedTimer>
+
+class QSlotProfiler : public QSignalSlotMonitor {
+    Q_OBJECT
+
+public:
+
+    /**
+     * @brief Histogram of durations, in nanoseconds, with logarithmic buckets.
+     * @details Each power of two is divided in 2^SUB_BUCKET_BITS buckets, so
+     *          a bucket's width is at most 1/32 of its lower bound, from 1
+     *          nanosecond to the maximum qint64 value.
+     */
+    class Histogram {
+
+    public:
+
+        /** @brief Each power of two is divided in 2^SUB_BUCKET_BITS buckets. */
+        static const int SUB_BUCKET_BITS = 5;
+
+        /** @brief Number of buckets, the durations below 2^SUB_BUCKET_BITS
+         *         and 2^SUB_BUCKET_BITS buckets for each power of two above. */
+        static const int BUCKET_COUNT = (64 - SUB_BUCKET_BITS) << SUB_BUCKET_BITS;
+
+        /**
+         * @brief Constructor.
+         */
+        Histogram();
+
+        /**
+         * @brief Adds a duration to the histogram.
+         * @param duration Duration in nanoseconds. Negative values count as 0.
+         */
+        void record(qint64 duration);
+
+        /**
+         * @brief Returns the number of durations recorded.
+         * @return
+         */
+        quint64 getCount() const;
+
+        /**
+         * @brief Returns the sum of the durations recorded.
+         * @return
+         */
+        qint64 getTotal() const;
+
+        /**
+         * @brief Returns the shortest duration recorded or 0 if none.
+         * @return
+         */
+        qint64 getMin() const;
+
+        /**
+         * @brief Returns the longest duration recorded or 0 if none.
+         * @return
+         */
+        qint64 getMax() const;
+
+        /**
+         * @brief Returns the average duration or 0 if none was recorded.
+         * @return
+         */
+        qint64 getMean() const;
+
+        /**
+         * @brief Returns the middle of the bucket where the given percentile
+         *        falls, bounded by the shortest and longest durations
+         *        recorded, or 0 if nothing was recorded.
+         * @details The error is at most half a bucket, 1/64 (about 1.6%) of
+         *          the duration. Durations below 64 nanoseconds are exact.
+         * @param percentile Percentile, from 0 to 100.
+         * @return
+         */
+        qint64 getPercentile(double percentile) const;
+
+        /**
+         * @brief Returns the number of durations in the bucket with the given
+         *        index.
+         * @param index Bucket index. Must be greater or equal to zero and less
+         *              than BUCKET_COUNT.
+         * @return
+         */
+        quint64 getBucket(int index) const;
+
+        /**
+         * @brief Returns the index of the bucket where the given duration falls.
+         * @param duration Duration in nanoseconds.
+         * @return
+         */
+        static int getBucketIndex(qint64 duration);
+
+        /**
+         * @brief Returns the smallest duration that falls in the bucket with
+         *        the given index.
+         * @param index Bucket index. Must be greater or equal to zero and less
+         *              than BUCKET_COUNT.
+         * @return
+         */
+        static qint64 getBucketLowerBound(int index);
+
+    private:
+
+        quint64 _count;
+        qint64 _total;
+        qint64 _min;
+        qint64 _max;
+        QVector<quint64> _buckets;
+    };
+
+    class SlotStatistics {
+
+        friend class QSlotProfiler;
+        template <typename T> friend class QVector;
+
+    public:
+
+        /**
+         * @brief Returns the receiver's meta object.
+         * @return
+         */
+        const QMetaObject* getReceiverMetaObject() const;
+
+        /**
+         * @brief Returns the slot's method index.
+         * @return
+         */
+        int getSlotMethodIndex() const;
+
+        /**
+         * @brief Returns the slot's meta method.
+         * @return
+         */
+        QMetaMethod getSlotMetaMethod() const;
+
+        /**
+         * @brief Returns the histogram of the slot's execution durations.
+         * @return
+         */
+        const Histogram& getHistogram() const;
+
+    private:
+
+        /**
+         * @brief Default constructor needed by QVector<SlotStatistics>.
+         */
+        SlotStatistics() = default;
+
+        const QMetaObject* _metaObject;
+        int _methodIndex;
+        Histogram _histogram;
+    };
+
+    class Invocation {
+
+        friend class QSlotProfiler;
+        template <typename T> friend class QVector;
+
+    public:
+
+        /**
+         * @brief Returns the time the slot was called, in nanoseconds since
+         *        the profiler was constructed.
+         * @return
+         */
+        qint64 getTimestamp() const;
+
+        /**
+         * @brief Returns the slot's execution duration in nanoseconds.
+         * @return
+         */
+        qint64 getDuration() const;
+
+        /**
+         * @brief Returns the memory address of the receiver object.
+         * @warning Do not use this pointer to access the object because there is
+         *          no way of knowing if the object is still valid.
+         * @return
+         */
+        const void* getReceiverAddress() const;
+
+        /**
+         * @brief Returns the receiver's meta object.
+         * @return
+         */
+        const QMetaObject* getReceiverMetaObject() const;
+
+        /**
+         * @brief Returns the slot's method index.
+         * @return
+         */
+        int getSlotMethodIndex() const;
+
+        /**
+         * @brief Returns the slot's meta method.
+         * @return
+         */
+        QMetaMethod getSlotMetaMethod() const;
+
+        /**
+         * @brief Returns the memory address of the signaler object.
+         * @warning Do not use this pointer to access the object because there is
+         *          no way of knowing if the object is still valid.
+         * @return
+         */
+        const void* getSignalerAddress() const;
+
+        /**
+         * @brief Returns the signaler's meta object.
+         * @return
+         */
+        const QMetaObject* getSignalerMetaObject() const;
+
+        /**
+         * @brief Returns the signal's method index.
+         * @return
+         */
+        int getSignalMethodIndex() const;
+
+        /**
+         * @brief Returns the signal's meta method.
+         * @return
+         */
+        QMetaMethod getSignalMetaMethod() const;
+
+    private:
+
+        /**
+         * @brief Default constructor needed by QVector<Invocation>.
+         */
+        Invocation() = default;
+
+        qint64 _timestamp;
+        qint64 _duration;
+        const void* _receiverAddress;
+        const QMetaObject* _receiverMetaObject;
+        int _slotMethodIndex;
+        const void* _signalerAddress;
+        const QMetaObject* _signalerMetaObject;
+        int _signalMethodIndex;
+    };
+
+    /**
+     * @brief Constructor.
+     * @param parent
+     * @param slowestCount Number of slowest invocations to keep.
+     * @note The profiler must be enabled with enableMonitor() to start
+     *       profiling.
+     */
+    explicit QSlotProfiler(QObject* parent = nullptr, int slowestCount = 10);
+
+    /**
+     * @brief Returns the number of slowest invocations kept.
+     * @return
+     */
+    int getSlowestCount() const;
+
+    /**
+     * @brief Sets the number of slowest invocations kept.
+     * @param slowestCount Must be greater or equal to zero.
+     */
+    void setSlowestCount(int slowestCount);
+
+    /**
+     * @brief Returns a snapshot of the statistics of each slot called,
+     *        ordered by total execution time, longest first.
+     * @return
+     */
+    QVector<SlotStatistics> getSlotStatistics() const;
+
+    /**
+     * @brief Returns a snapshot of the slowest invocations, slowest first.
+     * @return
+     */
+    QVector<Invocation> getSlowestInvocations() const;
+
+    /**
+     * @brief Clears the statistics and the slowest invocations.
+     */
+    void clear();
+
+private:
+
+    /**
+     * @brief A slot being executed.
+     */
+    struct Frame {
+        int generation;
+        qint64 start;
+        const void* receiverAddress;
+        const QMetaObject* receiverMetaObject;
+        int slotMethodIndex;
+        const void* signalerAddress;
+        const QMetaObject* signalerMetaObject;
+        int signalMethodIndex;
+    };
+
+    typedef QPair<const QMetaObject*, int> SlotKey;
+
+    virtual void slotBegin(const SignalInfo& signalInfo, const SlotInfo& slotInfo) override;
+    virtual void slotEnd(const SignalInfo& signalInfo, const SlotInfo& slotInfo) override;
+
+    /**
+     * @brief Returns the calling thread's stack of slots being executed.
+     */
+    QVector<Frame>& getFrames();
+
+    /**
+     * @brief Drops the frames left open by a previous enabling of the profiler
+     *        from the top of the calling thread's stack.
+     */
+    void dropStaleFrames(QVector<Frame>& frames) const;
+
+    /**
+     * @brief Adds the given invocation to the slowest invocations if it is
+     *        slow enough.
+     * @note Must be called with _mutex locked.
+     */
+    void recordSlowest(const Invocation& invocation);
+
+    QElapsedTimer _timer;
+    QThreadStorage<QVector<Frame>> _frames;
+    mutable QMutex _mutex;
+    QHash<SlotKey, Histogram> _histograms;
+    QVector<Invocation> _slowest;
+    int _slowestCount;
+
+};
+
+#endif // QSLOTPROFILER_H
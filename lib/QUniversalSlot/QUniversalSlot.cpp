@@ -18,14 +18,135 @@
 *******************************************************************************/
 #include "QUniversalSlot.h"
 
+#include <QBitArray>
+#include <QHash>
+#include <QSet>
+
+/**
+ * @brief Immutable set of filter rules of a QUniversalSlot.
+ * @details Rules are replaced as a whole when changed. Each thread keeps its
+ *          own copy of the rules and of the tables compiled from them, so
+ *          filtering a signal does not lock.
+ */
+class QUniversalSlotFilters {
+
+public:
+
+    typedef QUniversalSlot::FilterRule FilterRule;
+
+    /**
+     * @brief Per QMetaObject result of the rules that do not depend on the
+     *        signaler instance, indexed by method index.
+     */
+    struct Table {
+        QBitArray included;
+        QBitArray excluded;
+    };
+
+    struct Rule {
+        bool include;
+        FilterRule rule;
+        QByteArray value;
+    };
+
+    QUniversalSlotFilters()
+        : _rules()
+        , _hasIncludeRules(false)
+        , _includedObjectNames()
+        , _excludedObjectNames() {
+    }
+
+    QUniversalSlotFilters* withRule(bool include, FilterRule rule
+                                    , const QString& value) const {
+        QUniversalSlotFilters* const filters = new QUniversalSlotFilters(*this);
+        filters->_hasIncludeRules |= include;
+        if(rule == FilterRule::ObjectName) {
+            (include ? filters->_includedObjectNames
+                     : filters->_excludedObjectNames).insert(value);
+        } else {
+            filters->_rules.append(Rule{include, rule, value.toLatin1()});
+        }
+        return filters;
+    }
+
+    Table compile(const QMetaObject* metaObject) const {
+        const int methodCount = metaObject->methodCount();
+        Table table{QBitArray(methodCount), QBitArray(methodCount)};
+        for(const Rule& rule : _rules) {
+            QBitArray& bits = rule.include ? table.included : table.excluded;
+            if(rule.rule == FilterRule::SignalName) {
+                const QByteArray signature = QMetaObject::normalizedSignature(rule.value);
+                for(int methodIndex = 0; methodIndex < methodCount; ++methodIndex) {
+                    const QMetaMethod metaMethod = metaObject->method(methodIndex);
+                    if(metaMethod.methodType() == QMetaMethod::Signal
+                            && (metaMethod.name() == rule.value
+                                || metaMethod.methodSignature() == signature)) {
+                        bits.setBit(methodIndex);
+                    }
+                }
+            } else if(matchesClass(metaObject, rule)) {
+                bits.fill(true);
+            }
+        }
+        return table;
+    }
+
+    bool isAccepted(const QObject* signaler, int methodIndex, const Table& table) const {
+        if(table.excluded.testBit(methodIndex)) {
+            return false;
+        }
+        bool included = ! _hasIncludeRules || table.included.testBit(methodIndex);
+        if(! _includedObjectNames.isEmpty() || ! _excludedObjectNames.isEmpty()) {
+            const QString objectName = signaler->objectName();
+            if(_excludedObjectNames.contains(objectName)) {
+                return false;
+            }
+            included = included || _includedObjectNames.contains(objectName);
+        }
+        return included;
+    }
+
+private:
+
+    static bool matchesClass(const QMetaObject* metaObject, const Rule& rule) {
+        do {
+            if(rule.value == metaObject->className()) {
+                return true;
+            }
+            metaObject = metaObject->superClass();
+        } while(metaObject && rule.rule == FilterRule::Inherits);
+        return false;
+    }
+
+    QVector<Rule> _rules;
+    bool _hasIncludeRules;
+    QSet<QString> _includedObjectNames;
+    QSet<QString> _excludedObjectNames;
+
+};
+
+/**
+ * @brief Incremented every time the filters of any QUniversalSlot change or a
+ *        QUniversalSlot with filters is destroyed, to invalidate the per thread
+ *        copies of the filters.
+ */
+static QAtomicInt filtersGeneration;
+
 QUniversalSlot::QUniversalSlot(QObject* parent)
-    : QSignalSlotMonitor(parent) {
+    : QSignalSlotMonitor(parent)
+    , _filtersMutex()
+    , _filters()
+    , _hasFilters(0) {
 }
 
 QUniversalSlot::~QUniversalSlot() {
     if(isConnectedToEverything()) {
         disconnectEverything();
     }
+    if(_hasFilters.loadAcquire()) {
+        // Another slot can be created at the same address.
+        filtersGeneration.ref();
+    }
 }
 
 QMetaObject::Connection QUniversalSlot::connect(const QObject* signaler
@@ -73,6 +194,57 @@ void QUniversalSlot::disconnectEverything() {
     disableMonitor();
 }
 
+void QUniversalSlot::includeSignals(FilterRule rule, const QString& value) {
+    addFilter(true, rule, value);
+}
+
+void QUniversalSlot::excludeSignals(FilterRule rule, const QString& value) {
+    addFilter(false, rule, value);
+}
+
+void QUniversalSlot::clearFilters() {
+    QMutexLocker locker(&_filtersMutex);
+    _filters.reset();
+    _hasFilters.storeRelease(0);
+    filtersGeneration.ref();
+}
+
+bool QUniversalSlot::isSignalAccepted(const QObject* signaler, int methodIndex) const {
+    Q_ASSERT(signaler);
+    if(! _hasFilters.loadAcquire()) {
+        return true;
+    }
+    struct ThreadFilters {
+        QSharedPointer<const QUniversalSlotFilters> filters;
+        QHash<const QMetaObject*, QUniversalSlotFilters::Table> tables;
+    };
+    thread_local QHash<const QUniversalSlot*, ThreadFilters> cache;
+    thread_local int cacheGeneration = -1;
+    const int generation = filtersGeneration.loadAcquire();
+    if(cacheGeneration != generation) {
+        cache.clear();
+        cacheGeneration = generation;
+    }
+    auto iter = cache.find(this);
+    if(iter == cache.end()) {
+        ThreadFilters threadFilters;
+        {
+            QMutexLocker locker(&_filtersMutex);
+            threadFilters.filters = _filters;
+        }
+        iter = cache.insert(this, threadFilters);
+    }
+    if(! iter->filters) {
+        return true;
+    }
+    const QMetaObject* const metaObject = signaler->metaObject();
+    auto tableIter = iter->tables.constFind(metaObject);
+    if(tableIter == iter->tables.constEnd()) {
+        tableIter = iter->tables.insert(metaObject, iter->filters->compile(metaObject));
+    }
+    return iter->filters->isAccepted(signaler, methodIndex, tableIter.value());
+}
+
 QMetaObject::Connection QUniversalSlot::connect(const QObject* signaler
                                                 , int methodIndex) {
     Q_ASSERT(signaler);
@@ -84,12 +256,30 @@ QMetaObject::Connection QUniversalSlot::connect(const QObject* signaler
 }
 
 void QUniversalSlot::xslot(const void* const* parametersPointers) {
-    const SignalInfo signalInfo(sender(), -1, senderSignalIndex(), parametersPointers);
+    QObject* const signaler = sender();
+    const int methodIndex = senderSignalIndex();
+    if(! isSignalAccepted(signaler, methodIndex)) {
+        return;
+    }
+    const SignalInfo signalInfo(signaler, -1, methodIndex, parametersPointers);
     universal(signalInfo.getSignaler(), signalInfo.getMetaMethod()
               , signalInfo.getParameters());
 }
 
 void QUniversalSlot::signalBegin(const SignalInfo& signalInfo) {
+    if(! isSignalAccepted(signalInfo.getSignaler(), signalInfo.getMethodIndex())) {
+        return;
+    }
     universal(signalInfo.getSignaler(), signalInfo.getMetaMethod()
               , signalInfo.getParameters());
 }
+
+void QUniversalSlot::addFilter(bool include, FilterRule rule, const QString& value) {
+    QMutexLocker locker(&_filtersMutex);
+    const QUniversalSlotFilters emptyFilters;
+    const QUniversalSlotFilters& filters = _filters ? *_filters : emptyFilters;
+    _filters.reset(filters.withRule(include, rule, value));
+    _hasFilters.storeRelease(1);
+    filtersGeneration.ref();
+}
+
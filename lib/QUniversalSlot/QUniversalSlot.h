@@ -25,6 +25,11 @@
 #include <QVector>
 #include <QMetaObject>
 #include <QMetaMethod>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QSharedPointer>
+
+class QUniversalSlotFilters;
 
 class QUniversalSlot : public QSignalSlotMonitor {
     Q_OBJECT
@@ -106,6 +111,54 @@ public:
      */
     void disconnectEverything();
 
+    /**
+     * @brief What a signal filter rule is matched against.
+     */
+    enum class FilterRule {
+        ClassName,  ///< The signaler's class name.
+        Inherits,   ///< The name of the signaler's class or any of its super classes.
+        ObjectName, ///< The signaler's object name.
+        SignalName  ///< The signal's name (e.g. "valueChanged") or signature (e.g. "valueChanged(int)").
+    };
+
+    /**
+     * @brief Adds a filter rule that includes the matching signals.
+     * @param rule What the value is matched against.
+     * @param value The value to match.
+     * @note Without include rules all signals are included. With include rules
+     *       only the signals that match at least one of them are included.
+     * @note Filters are evaluated before the signal's parameters are copied
+     *       and universal() is not called for the signals filtered out.
+     *       Except for ObjectName rules, the filters are compiled into a bit
+     *       set per QMetaObject so a filtered out signal only costs a lookup.
+     * @note Filters can be changed from any thread, but signals already being
+     *       dispatched in other threads can still see the previous filters.
+     */
+    void includeSignals(FilterRule rule, const QString& value);
+
+    /**
+     * @brief Adds a filter rule that excludes the matching signals.
+     * @param rule What the value is matched against.
+     * @param value The value to match.
+     * @note Exclude rules take precedence over include rules.
+     * @see includeSignals()
+     */
+    void excludeSignals(FilterRule rule, const QString& value);
+
+    /**
+     * @brief Removes all filter rules, so all signals are accepted.
+     */
+    void clearFilters();
+
+    /**
+     * @brief Returns true if the filters accept the signal with the given
+     *        method index from the given signaler and false otherwise.
+     * @param signaler Pointer to the signaler object. Must be non null.
+     * @param methodIndex The signal's method index.
+     * @return
+     */
+    bool isSignalAccepted(const QObject* signaler, int methodIndex) const;
+
 private slots:
 
     /**
@@ -148,6 +201,15 @@ private:
      * @param signalInfo Signal's information.
      */
     virtual void signalBegin(const SignalInfo& signalInfo) override;
+
+    /**
+     * @brief Adds a filter rule and publishes the new filters.
+     */
+    void addFilter(bool include, FilterRule rule, const QString& value);
+
+    mutable QMutex _filtersMutex;
+    QSharedPointer<const QUniversalSlotFilters> _filters;
+    QAtomicInt _hasFilters;
 };
 
 #define QUNIVERSALSLOT_GUARD(TEST, RETURN, WARN) \
@@ -0,0 +1,765 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QValueSerializer.h"
+
+#include <QMutex>
+#include <QMultiHash>
+#include <QPair>
+#include <QDataStream>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+#include <QUuid>
+#include <QDate>
+#include <QTime>
+#include <QDateTime>
+#include <QTimeZone>
+#include <QPoint>
+#include <QSize>
+#include <QRect>
+#include <QLine>
+
+#include <atomic>
+#include <limits>
+
+/* The tag's lowest bit flags a payload written with QDataStream. */
+static const quint64 streamedTagFlag = 1;
+static const QDataStream::Version streamVersion = QDataStream::Qt_5_6;
+
+/**
+ * @brief Flat table of atomic slots, indexed by type id, with the most recently
+ *        enabled function of each type.
+ * @details Builtin types have a slot in a fixed array. User types have a slot
+ *          in chunks that are allocated on demand and never freed, so the
+ *          table can grow without moving the slots under the readers.
+ *          Tables must have static storage so they are zero initialized before
+ *          any serializer is registered.
+ */
+template<typename FUNC>
+class QValueSerializerTable {
+
+public:
+
+    typedef std::atomic<FUNC> Slot;
+
+    inline FUNC find(int typeId) {
+        const Slot* const slot = getSlot(typeId);
+        return slot ? slot->load(std::memory_order_acquire) : nullptr;
+    }
+
+    void publish(int typeId, FUNC func) {
+        Slot* const slot = getSlot(typeId, true);
+        if(slot) {
+            slot->store(func, std::memory_order_release);
+        } else {
+            qWarning("QValueSerializer: type id %d is too large for the"
+                     " serializers table.", typeId);
+        }
+    }
+
+private:
+
+    static const int builtinSlotCount = QMetaType::User;
+    static const int userChunkSize = 256;
+    static const int userChunkCount = 256;
+
+    Slot* getSlot(int typeId, bool createChunk = false) {
+        if(typeId < 0) {
+            return nullptr;
+        }
+        if(typeId < builtinSlotCount) {
+            return &_builtinSlots[typeId];
+        }
+        const int index = typeId - builtinSlotCount;
+        const int chunkIndex = index / userChunkSize;
+        if(chunkIndex >= userChunkCount) {
+            return nullptr;
+        }
+        Slot* chunk = _userChunks[chunkIndex].load(std::memory_order_acquire);
+        if(! chunk && createChunk) {
+            Slot* const newChunk = new Slot[userChunkSize]();
+            if(_userChunks[chunkIndex].compare_exchange_strong(chunk, newChunk)) {
+                chunk = newChunk;
+            } else {
+                delete[] newChunk;
+            }
+        }
+        return chunk ? &chunk[index % userChunkSize] : nullptr;
+    }
+
+    Slot _builtinSlots[builtinSlotCount];
+    std::atomic<Slot*> _userChunks[userChunkCount];
+
+};
+
+/**
+ * @brief Registry of the value serializers.
+ * @details The registry itself is only accessed by enable() and disable(),
+ *          holding a mutex that, like the tables, needs no dynamic
+ *          initialization. serialize() and deserialize() read the functions
+ *          from the flat tables without locks or hash lookups.
+ */
+class QValueSerializerData {
+
+public:
+
+    typedef QValueSerializer::SerializerFunc SerializerFunc;
+    typedef QValueSerializer::DeserializerFunc DeserializerFunc;
+    typedef QPair<SerializerFunc, DeserializerFunc> Funcs;
+    typedef QMultiHash<QMetaType::Type, Funcs> Serializers;
+
+    static void enableSerializer(QMetaType::Type typeId, const Funcs& funcs) {
+        QMutexLocker locker(&_mutex);
+        Serializers& serializers = getSerializers();
+        if(! serializers.contains(typeId, funcs)) {
+            serializers.insertMulti(typeId, funcs);
+            updateSlots(typeId);
+        }
+    }
+
+    static void disableSerializer(QMetaType::Type typeId, const Funcs& funcs) {
+        QMutexLocker locker(&_mutex);
+        if(getSerializers().remove(typeId, funcs) > 0) {
+            updateSlots(typeId);
+        }
+    }
+
+    static inline SerializerFunc findSerializer(int typeId) {
+        return _serializerFuncs.find(typeId);
+    }
+
+    static inline DeserializerFunc findDeserializer(int typeId) {
+        return _deserializerFuncs.find(typeId);
+    }
+
+private:
+
+    /**
+     * @brief Returns the registry, constructed on first use so serializers
+     *        can be registered by static objects of any translation unit.
+     */
+    static Serializers& getSerializers() {
+        static Serializers serializers;
+        return serializers;
+    }
+
+    /**
+     * @brief Publishes the most recently enabled serializer of the given type.
+     */
+    static void updateSlots(QMetaType::Type typeId) {
+        const Funcs funcs = getSerializers().value(typeId, Funcs(nullptr, nullptr));
+        _serializerFuncs.publish(typeId, funcs.first);
+        _deserializerFuncs.publish(typeId, funcs.second);
+    }
+
+    static QValueSerializerTable<SerializerFunc> _serializerFuncs;
+    static QValueSerializerTable<DeserializerFunc> _deserializerFuncs;
+    static QBasicMutex _mutex;
+
+};
+
+QValueSerializerTable<QValueSerializerData::SerializerFunc> QValueSerializerData::_serializerFuncs;
+QValueSerializerTable<QValueSerializerData::DeserializerFunc> QValueSerializerData::_deserializerFuncs;
+QBasicMutex QValueSerializerData::_mutex;
+
+static bool isPointerType(int typeId) {
+    return typeId == QMetaType::VoidStar
+            || typeId == QMetaType::QObjectStar
+            || (QMetaType::typeFlags(typeId) & QMetaType::PointerToQObject);
+}
+
+/**
+ * @brief Appends the tag and the length of a record to the given buffer,
+ *        reserving a single byte for the length.
+ * @return The offset of the length byte.
+ */
+static inline int beginRecord(quint64 tag, QByteArray& buffer) {
+    QValueSerializer::writeVarint(tag, buffer);
+    buffer.append('\0');
+    return buffer.size() - 1;
+}
+
+/**
+ * @brief Writes the length of a record's payload, that ends at the end of the
+ *        given buffer, moving the payload if the length needs more than the
+ *        reserved byte.
+ */
+static inline void endRecord(int lengthOffset, QByteArray& buffer) {
+    const int payloadOffset = lengthOffset + 1;
+    const int length = buffer.size() - payloadOffset;
+    if(length < 0x80) {
+        buffer[lengthOffset] = static_cast<char>(length);
+        return;
+    }
+    char varint[10];
+    int varintSize = 0;
+    for(quint64 value = static_cast<quint64>(length); value != 0; value >>= 7) {
+        varint[varintSize++] = static_cast<char>((value & 0x7F) | (value >= 0x80 ? 0x80 : 0));
+    }
+    buffer.resize(buffer.size() + varintSize - 1);
+    char* const data = buffer.data();
+    std::memmove(data + lengthOffset + varintSize, data + payloadOffset, length);
+    std::memcpy(data + lengthOffset, varint, varintSize);
+}
+
+QValueSerializer::QValueSerializer(QMetaType::Type typeId
+                                   , SerializerFunc serializerFunc
+                                   , DeserializerFunc deserializerFunc
+                                   , bool enableAtConstruction)
+    : _typeId(typeId)
+    , _serializerFunc(serializerFunc)
+    , _deserializerFunc(deserializerFunc) {
+    Q_ASSERT(_serializerFunc);
+    Q_ASSERT(_deserializerFunc);
+    if(enableAtConstruction) {
+        enable();
+    }
+}
+
+QValueSerializer::~QValueSerializer() {
+    disable();
+}
+
+QMetaType::Type QValueSerializer::getTypeId() const {
+    return _typeId;
+}
+
+QValueSerializer::SerializerFunc QValueSerializer::getSerializerFunc() const {
+    return _serializerFunc;
+}
+
+QValueSerializer::DeserializerFunc QValueSerializer::getDeserializerFunc() const {
+    return _deserializerFunc;
+}
+
+void QValueSerializer::enable() {
+    QValueSerializerData::enableSerializer(
+                _typeId, QValueSerializerData::Funcs(_serializerFunc, _deserializerFunc));
+}
+
+void QValueSerializer::disable() {
+    QValueSerializerData::disableSerializer(
+                _typeId, QValueSerializerData::Funcs(_serializerFunc, _deserializerFunc));
+}
+
+void QValueSerializer::serialize(int typeId, const void* value, QByteArray& buffer) {
+    if(typeId == QMetaType::QVariant) {
+        serialize(*static_cast<const QVariant*>(value), buffer);
+        return;
+    }
+    const quint64 tag = static_cast<quint64>(qMax(typeId, 0)) << 1;
+    const SerializerFunc serializerFunc = QValueSerializerData::findSerializer(typeId);
+    if(serializerFunc) {
+        const int lengthOffset = beginRecord(tag, buffer);
+        serializerFunc(value, buffer);
+        endRecord(lengthOffset, buffer);
+    } else if(isPointerType(typeId)) {
+        const quint64 address = static_cast<quint64>(
+                    reinterpret_cast<quintptr>(*static_cast<void* const*>(value)));
+        const int lengthOffset = beginRecord(tag, buffer);
+        buffer.append(reinterpret_cast<const char*>(&address), sizeof(address));
+        endRecord(lengthOffset, buffer);
+    } else {
+        const int recordOffset = buffer.size();
+        bool saved = false;
+        if(typeId != QMetaType::UnknownType) {
+            const int lengthOffset = beginRecord(tag | streamedTagFlag, buffer);
+            QDataStream stream(&buffer, QIODevice::WriteOnly | QIODevice::Append);
+            stream.setVersion(streamVersion);
+            saved = QMetaType::save(stream, typeId, value)
+                    && stream.status() == QDataStream::Ok;
+            if(saved) {
+                endRecord(lengthOffset, buffer);
+            }
+        }
+        if(! saved) {
+            buffer.truncate(recordOffset);
+            beginRecord(QMetaType::UnknownType, buffer);
+        }
+    }
+}
+
+void QValueSerializer::serialize(const QVariant& var, QByteArray& buffer) {
+    serialize(var.userType(), var.constData(), buffer);
+}
+
+bool QValueSerializer::deserialize(const char*& data, const char* end, QVariant& value) {
+    const char* begin = data;
+    quint64 tag = 0;
+    quint64 length = 0;
+    if(! readVarint(begin, end, tag) || ! readVarint(begin, end, length)
+            || length > static_cast<quint64>(end - begin)) {
+        return false;
+    }
+    data = begin + length;
+    value = QVariant();
+    const int size = static_cast<int>(length);
+    const quint64 typeTag = tag >> 1;
+    if(typeTag == static_cast<quint64>(QMetaType::UnknownType)
+            || typeTag > static_cast<quint64>(std::numeric_limits<int>::max())
+            || ! QMetaType::isRegistered(static_cast<int>(typeTag))) {
+        return true;
+    }
+    const int typeId = static_cast<int>(typeTag);
+    if(tag & streamedTagFlag) {
+        const QByteArray payload = QByteArray::fromRawData(begin, size);
+        QDataStream stream(payload);
+        stream.setVersion(streamVersion);
+        QVariant result(typeId, nullptr);
+        if(QMetaType::load(stream, typeId, result.data())
+                && stream.status() == QDataStream::Ok) {
+            value = result;
+        }
+    } else if(isPointerType(typeId)) {
+        quint64 address = 0;
+        if(size == sizeof(address)) {
+            std::memcpy(&address, begin, sizeof(address));
+            const void* const pointer = reinterpret_cast<const void*>(static_cast<quintptr>(address));
+            value = QVariant(typeId, &pointer);
+        }
+    } else {
+        const DeserializerFunc deserializerFunc = QValueSerializerData::findDeserializer(typeId);
+        if(deserializerFunc) {
+            QVariant result(typeId, nullptr);
+            if(deserializerFunc(begin, size, result.data())) {
+                value = result;
+            }
+        }
+    }
+    return true;
+}
+
+void QValueSerializer::writeVarint(quint64 value, QByteArray& buffer) {
+    char varint[10];
+    int varintSize = 0;
+    do {
+        varint[varintSize++] = static_cast<char>((value & 0x7F) | (value >= 0x80 ? 0x80 : 0));
+        value >>= 7;
+    } while(value != 0);
+    buffer.append(varint, varintSize);
+}
+
+void QValueSerializer::writeSignedVarint(qint64 value, QByteArray& buffer) {
+    writeVarint((static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63), buffer);
+}
+
+bool QValueSerializer::readVarint(const char*& data, const char* end, quint64& value) {
+    quint64 result = 0;
+    for(int shift = 0; shift < 64 && data + shift / 7 < end; shift += 7) {
+        const uchar byte = static_cast<uchar>(data[shift / 7]);
+        result |= static_cast<quint64>(byte & 0x7F) << shift;
+        if((byte & 0x80) == 0) {
+            data += shift / 7 + 1;
+            value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool QValueSerializer::readSignedVarint(const char*& data, const char* end, qint64& value) {
+    quint64 zigzag = 0;
+    if(! readVarint(data, end, zigzag)) {
+        return false;
+    }
+    value = static_cast<qint64>(zigzag >> 1) ^ -static_cast<qint64>(zigzag & 1);
+    return true;
+}
+
+/**
+ * @brief Reads the signed varints of a payload into the given integers.
+ * @return Returns false if the payload does not have exactly that many varints.
+ */
+template<typename TYPE, int COUNT>
+static bool readSignedVarints(const char* data, int size, TYPE (&values)[COUNT]) {
+    const char* const end = data + size;
+    for(TYPE& value : values) {
+        qint64 number = 0;
+        if(! QValueSerializer::readSignedVarint(data, end, number)) {
+            return false;
+        }
+        value = static_cast<TYPE>(number);
+    }
+    return data == end;
+}
+
+template<typename TYPE>
+static void serializeSigned(const void* value, QByteArray& buffer) {
+    QValueSerializer::writeSignedVarint(*static_cast<const TYPE*>(value), buffer);
+}
+
+template<typename TYPE>
+static bool deserializeSigned(const char* data, int size, void* value) {
+    TYPE values[1];
+    if(! readSignedVarints(data, size, values)) {
+        return false;
+    }
+    *static_cast<TYPE*>(value) = values[0];
+    return true;
+}
+
+template<typename TYPE>
+static void serializeUnsigned(const void* value, QByteArray& buffer) {
+    QValueSerializer::writeVarint(*static_cast<const TYPE*>(value), buffer);
+}
+
+template<typename TYPE>
+static bool deserializeUnsigned(const char* data, int size, void* value) {
+    const char* const end = data + size;
+    quint64 number = 0;
+    if(! QValueSerializer::readVarint(data, end, number) || data != end) {
+        return false;
+    }
+    *static_cast<TYPE*>(value) = static_cast<TYPE>(number);
+    return true;
+}
+
+static void appendString(const QString& string, QByteArray& buffer) {
+    buffer.append(reinterpret_cast<const char*>(string.constData())
+                  , string.size() * static_cast<int>(sizeof(QChar)));
+}
+
+static bool readString(const char* data, int size, QString& string) {
+    if(size % static_cast<int>(sizeof(QChar)) != 0) {
+        return false;
+    }
+    string.resize(size / static_cast<int>(sizeof(QChar)));
+    std::memcpy(string.data(), data, size);
+    return true;
+}
+
+#define IMPLEMENT_SIGNED_SERIALIZER(TYPE) \
+    static QValueSerializer TYPE##SerializerFuncsRegister \
+    (static_cast<QMetaType::Type>(qMetaTypeId<TYPE>()) \
+    , &serializeSigned<TYPE>, &deserializeSigned<TYPE>)
+
+#define IMPLEMENT_UNSIGNED_SERIALIZER(TYPE) \
+    static QValueSerializer TYPE##SerializerFuncsRegister \
+    (static_cast<QMetaType::Type>(qMetaTypeId<TYPE>()) \
+    , &serializeUnsigned<TYPE>, &deserializeUnsigned<TYPE>)
+
+IMPLEMENT_SIGNED_SERIALIZER(short);
+IMPLEMENT_SIGNED_SERIALIZER(int);
+IMPLEMENT_SIGNED_SERIALIZER(long);
+IMPLEMENT_SIGNED_SERIALIZER(qlonglong);
+
+IMPLEMENT_UNSIGNED_SERIALIZER(ushort);
+IMPLEMENT_UNSIGNED_SERIALIZER(uint);
+IMPLEMENT_UNSIGNED_SERIALIZER(ulong);
+IMPLEMENT_UNSIGNED_SERIALIZER(qulonglong);
+
+typedef signed char schar;
+IMPLEMENT_TRIVIAL_VALUE_SERIALIZER(bool);
+IMPLEMENT_TRIVIAL_VALUE_SERIALIZER(char);
+IMPLEMENT_TRIVIAL_VALUE_SERIALIZER(uchar);
+IMPLEMENT_TRIVIAL_VALUE_SERIALIZER(schar);
+IMPLEMENT_TRIVIAL_VALUE_SERIALIZER(QChar);
+IMPLEMENT_TRIVIAL_VALUE_SERIALIZER(float);
+IMPLEMENT_TRIVIAL_VALUE_SERIALIZER(double);
+IMPLEMENT_TRIVIAL_VALUE_SERIALIZER(QPointF);
+IMPLEMENT_TRIVIAL_VALUE_SERIALIZER(QSizeF);
+IMPLEMENT_TRIVIAL_VALUE_SERIALIZER(QRectF);
+IMPLEMENT_TRIVIAL_VALUE_SERIALIZER(QLineF);
+
+DECLARE_VALUE_SERIALIZER_FUNC(QString) {
+    appendString(*static_cast<const QString*>(value), buffer);
+}
+
+DECLARE_VALUE_DESERIALIZER_FUNC(QString) {
+    return readString(data, size, *static_cast<QString*>(value));
+}
+
+REGISTER_VALUE_SERIALIZER_FUNCS(QString);
+
+DECLARE_VALUE_SERIALIZER_FUNC(QByteArray) {
+    buffer.append(*static_cast<const QByteArray*>(value));
+}
+
+DECLARE_VALUE_DESERIALIZER_FUNC(QByteArray) {
+    *static_cast<QByteArray*>(value) = QByteArray(data, size);
+    return true;
+}
+
+REGISTER_VALUE_SERIALIZER_FUNCS(QByteArray);
+
+DECLARE_VALUE_SERIALIZER_FUNC(QStringList) {
+    for(const QString& string : *static_cast<const QStringList*>(value)) {
+        QValueSerializer::writeVarint(static_cast<quint64>(string.size()), buffer);
+        appendString(string, buffer);
+    }
+}
+
+DECLARE_VALUE_DESERIALIZER_FUNC(QStringList) {
+    QStringList& list = *static_cast<QStringList*>(value);
+    const char* const end = data + size;
+    while(data < end) {
+        quint64 length = 0;
+        if(! QValueSerializer::readVarint(data, end, length)
+                || length > static_cast<quint64>(end - data) / sizeof(QChar)) {
+            return false;
+        }
+        QString string;
+        const int byteCount = static_cast<int>(length * sizeof(QChar));
+        readString(data, byteCount, string);
+        list.append(string);
+        data += byteCount;
+    }
+    return true;
+}
+
+REGISTER_VALUE_SERIALIZER_FUNCS(QStringList);
+
+DECLARE_VALUE_SERIALIZER_FUNC(QVariantList) {
+    for(const QVariant& item : *static_cast<const QVariantList*>(value)) {
+        QValueSerializer::serialize(item, buffer);
+    }
+}
+
+DECLARE_VALUE_DESERIALIZER_FUNC(QVariantList) {
+    QVariantList& list = *static_cast<QVariantList*>(value);
+    const char* const end = data + size;
+    while(data < end) {
+        QVariant item;
+        if(! QValueSerializer::deserialize(data, end, item)) {
+            return false;
+        }
+        list.append(item);
+    }
+    return true;
+}
+
+REGISTER_VALUE_SERIALIZER_FUNCS(QVariantList);
+
+DECLARE_VALUE_SERIALIZER_FUNC(QVariantMap) {
+    const QVariantMap& map = *static_cast<const QVariantMap*>(value);
+    for(auto iter = map.constBegin(); iter != map.constEnd(); ++iter) {
+        QValueSerializer::writeVarint(static_cast<quint64>(iter.key().size()), buffer);
+        appendString(iter.key(), buffer);
+        QValueSerializer::serialize(iter.value(), buffer);
+    }
+}
+
+DECLARE_VALUE_DESERIALIZER_FUNC(QVariantMap) {
+    QVariantMap& map = *static_cast<QVariantMap*>(value);
+    const char* const end = data + size;
+    while(data < end) {
+        quint64 length = 0;
+        if(! QValueSerializer::readVarint(data, end, length)
+                || length > static_cast<quint64>(end - data) / sizeof(QChar)) {
+            return false;
+        }
+        QString key;
+        const int byteCount = static_cast<int>(length * sizeof(QChar));
+        readString(data, byteCount, key);
+        data += byteCount;
+        QVariant item;
+        if(! QValueSerializer::deserialize(data, end, item)) {
+            return false;
+        }
+        map.insert(key, item);
+    }
+    return true;
+}
+
+REGISTER_VALUE_SERIALIZER_FUNCS(QVariantMap);
+
+DECLARE_VALUE_SERIALIZER_FUNC(QPoint) {
+    const QPoint& point = *static_cast<const QPoint*>(value);
+    QValueSerializer::writeSignedVarint(point.x(), buffer);
+    QValueSerializer::writeSignedVarint(point.y(), buffer);
+}
+
+DECLARE_VALUE_DESERIALIZER_FUNC(QPoint) {
+    int values[2];
+    if(! readSignedVarints(data, size, values)) {
+        return false;
+    }
+    *static_cast<QPoint*>(value) = QPoint(values[0], values[1]);
+    return true;
+}
+
+REGISTER_VALUE_SERIALIZER_FUNCS(QPoint);
+
+DECLARE_VALUE_SERIALIZER_FUNC(QSize) {
+    const QSize& size = *static_cast<const QSize*>(value);
+    QValueSerializer::writeSignedVarint(size.width(), buffer);
+    QValueSerializer::writeSignedVarint(size.height(), buffer);
+}
+
+DECLARE_VALUE_DESERIALIZER_FUNC(QSize) {
+    int values[2];
+    if(! readSignedVarints(data, size, values)) {
+        return false;
+    }
+    *static_cast<QSize*>(value) = QSize(values[0], values[1]);
+    return true;
+}
+
+REGISTER_VALUE_SERIALIZER_FUNCS(QSize);
+
+DECLARE_VALUE_SERIALIZER_FUNC(QRect) {
+    const QRect& rect = *static_cast<const QRect*>(value);
+    QValueSerializer::writeSignedVarint(rect.x(), buffer);
+    QValueSerializer::writeSignedVarint(rect.y(), buffer);
+    QValueSerializer::writeSignedVarint(rect.width(), buffer);
+    QValueSerializer::writeSignedVarint(rect.height(), buffer);
+}
+
+DECLARE_VALUE_DESERIALIZER_FUNC(QRect) {
+    int values[4];
+    if(! readSignedVarints(data, size, values)) {
+        return false;
+    }
+    *static_cast<QRect*>(value) = QRect(values[0], values[1], values[2], values[3]);
+    return true;
+}
+
+REGISTER_VALUE_SERIALIZER_FUNCS(QRect);
+
+DECLARE_VALUE_SERIALIZER_FUNC(QLine) {
+    const QLine& line = *static_cast<const QLine*>(value);
+    QValueSerializer::writeSignedVarint(line.x1(), buffer);
+    QValueSerializer::writeSignedVarint(line.y1(), buffer);
+    QValueSerializer::writeSignedVarint(line.x2(), buffer);
+    QValueSerializer::writeSignedVarint(line.y2(), buffer);
+}
+
+DECLARE_VALUE_DESERIALIZER_FUNC(QLine) {
+    int values[4];
+    if(! readSignedVarints(data, size, values)) {
+        return false;
+    }
+    *static_cast<QLine*>(value) = QLine(values[0], values[1], values[2], values[3]);
+    return true;
+}
+
+REGISTER_VALUE_SERIALIZER_FUNCS(QLine);
+
+DECLARE_VALUE_SERIALIZER_FUNC(QDate) {
+    QValueSerializer::writeSignedVarint(static_cast<const QDate*>(value)->toJulianDay(), buffer);
+}
+
+DECLARE_VALUE_DESERIALIZER_FUNC(QDate) {
+    qint64 values[1];
+    if(! readSignedVarints(data, size, values)) {
+        return false;
+    }
+    *static_cast<QDate*>(value) = QDate::fromJulianDay(values[0]);
+    return true;
+}
+
+REGISTER_VALUE_SERIALIZER_FUNCS(QDate);
+
+DECLARE_VALUE_SERIALIZER_FUNC(QTime) {
+    const QTime& time = *static_cast<const QTime*>(value);
+    // Zero is an invalid time.
+    QValueSerializer::writeVarint(time.isValid() ? time.msecsSinceStartOfDay() + 1 : 0, buffer);
+}
+
+DECLARE_VALUE_DESERIALIZER_FUNC(QTime) {
+    const char* const end = data + size;
+    quint64 msecs = 0;
+    if(! QValueSerializer::readVarint(data, end, msecs) || data != end) {
+        return false;
+    }
+    *static_cast<QTime*>(value) = msecs == 0
+            ? QTime() : QTime::fromMSecsSinceStartOfDay(static_cast<int>(msecs - 1));
+    return true;
+}
+
+REGISTER_VALUE_SERIALIZER_FUNCS(QTime);
+
+/* An invalid QDateTime is written as an empty payload. Otherwise the payload is
+ * the msecs since epoch, the time spec and, depending on the time spec, the
+ * offset from UTC or the time zone id. */
+DECLARE_VALUE_SERIALIZER_FUNC(QDateTime) {
+    const QDateTime& dateTime = *static_cast<const QDateTime*>(value);
+    if(! dateTime.isValid()) {
+        return;
+    }
+    QValueSerializer::writeSignedVarint(dateTime.toMSecsSinceEpoch(), buffer);
+    const Qt::TimeSpec timeSpec = dateTime.timeSpec();
+    buffer.append(static_cast<char>(timeSpec));
+    if(timeSpec == Qt::OffsetFromUTC) {
+        QValueSerializer::writeSignedVarint(dateTime.offsetFromUtc(), buffer);
+    } else if(timeSpec == Qt::TimeZone) {
+        buffer.append(dateTime.timeZone().id());
+    }
+}
+
+DECLARE_VALUE_DESERIALIZER_FUNC(QDateTime) {
+    QDateTime& dateTime = *static_cast<QDateTime*>(value);
+    if(size == 0) {
+        dateTime = QDateTime();
+        return true;
+    }
+    const char* const end = data + size;
+    qint64 msecs = 0;
+    if(! QValueSerializer::readSignedVarint(data, end, msecs) || data == end) {
+        return false;
+    }
+    const Qt::TimeSpec timeSpec = static_cast<Qt::TimeSpec>(*data++);
+    switch(timeSpec) {
+    case Qt::LocalTime:
+    case Qt::UTC:
+        dateTime = QDateTime::fromMSecsSinceEpoch(msecs, timeSpec);
+        return data == end;
+    case Qt::OffsetFromUTC: {
+        qint64 offset = 0;
+        if(! QValueSerializer::readSignedVarint(data, end, offset) || data != end) {
+            return false;
+        }
+        dateTime = QDateTime::fromMSecsSinceEpoch(msecs, timeSpec, static_cast<int>(offset));
+        return true;
+    }
+    case Qt::TimeZone:
+        dateTime = QDateTime::fromMSecsSinceEpoch(
+                    msecs, QTimeZone(QByteArray(data, static_cast<int>(end - data))));
+        return true;
+    }
+    return false;
+}
+
+REGISTER_VALUE_SERIALIZER_FUNCS(QDateTime);
+
+DECLARE_VALUE_SERIALIZER_FUNC(QUrl) {
+    buffer.append(static_cast<const QUrl*>(value)->toEncoded());
+}
+
+DECLARE_VALUE_DESERIALIZER_FUNC(QUrl) {
+    *static_cast<QUrl*>(value) = QUrl::fromEncoded(QByteArray(data, size));
+    return true;
+}
+
+REGISTER_VALUE_SERIALIZER_FUNCS(QUrl);
+
+DECLARE_VALUE_SERIALIZER_FUNC(QUuid) {
+    buffer.append(static_cast<const QUuid*>(value)->toRfc4122());
+}
+
+DECLARE_VALUE_DESERIALIZER_FUNC(QUuid) {
+    if(size != 16) {
+        return false;
+    }
+    *static_cast<QUuid*>(value) = QUuid::fromRfc4122(QByteArray::fromRawData(data, size));
+    return true;
+}
+
+REGISTER_VALUE_SERIALIZER_FUNCS(QUuid);
@@ -0,0 +1,208 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#ifndef QVALUESERIALIZER_H
+#define QVALUESERIALIZER_H
+
+#include <QByteArray>
+#include <QVariant>
+#include <QMetaType>
+
+#include <cstring>
+
+/**
+ * @brief Compact binary serialization of values, registered per type.
+ * @details Each value is written as a record: a varint tag with the type id,
+ *          a varint with the payload's length and the payload. The payload is
+ *          written by the serializer registered for the type, without
+ *          intermediate strings. Types without a serializer are written with
+ *          their QDataStream operators, if any, and flagged in the tag.
+ *          Values of types without both are written as empty records that
+ *          deserialize to invalid QVariants. Pointers are written by value.
+ * @note The ids of user types are only valid in the process that registered
+ *       them, so serialized user types must be mapped by type name when read
+ *       by other processes.
+ */
+class QValueSerializer {
+
+public:
+
+    /**
+     * @brief Serializer functions must have this signature.
+     *        They must append the payload of the given value to the buffer.
+     */
+    typedef void (*SerializerFunc)(const void* value, QByteArray& buffer);
+
+    /**
+     * @brief Deserializer functions must have this signature.
+     *        They must read the payload from the given data into the given
+     *        default constructed value and return false if the payload is not
+     *        valid.
+     */
+    typedef bool (*DeserializerFunc)(const char* data, int size, void* value);
+
+    /**
+     * @brief Constructor.
+     * @param typeId Id of the type to be serialized.
+     * @param serializerFunc Pointer to the function that serializes the value.
+     * @param deserializerFunc Pointer to the function that deserializes the value.
+     * @param enableAtConstruction If true, the serializer will be enabled at
+     *                             construction.
+     *                             If false, the enable() method needs to be
+     *                             called explicitly to enable the serializer.
+     * @note Custom types must be declared with Q_DECLARE_METATYPE(TYPE).
+     * @note Multiple serializers for the same type can be constructed but
+     *       only the most recently enabled serializer will be used.
+     */
+    QValueSerializer(QMetaType::Type typeId, SerializerFunc serializerFunc
+                     , DeserializerFunc deserializerFunc
+                     , bool enableAtConstruction = true);
+
+    /**
+      * @brief Destructor.
+      */
+    ~QValueSerializer();
+
+    /**
+     * @brief Returns the type id.
+     * @return
+     */
+    QMetaType::Type getTypeId() const;
+
+    /**
+     * @brief Returns the serializer function pointer.
+     * @return
+     */
+    SerializerFunc getSerializerFunc() const;
+
+    /**
+     * @brief Returns the deserializer function pointer.
+     * @return
+     */
+    DeserializerFunc getDeserializerFunc() const;
+
+    /**
+     * @brief Enables the serializer.
+     */
+    void enable();
+
+    /**
+     * @brief Disables the serializer.
+     */
+    void disable();
+
+    /**
+     * @brief Serializes the given value and appends the record to the given
+     *        buffer.
+     * @param typeId The value's type id. QVariants are serialized as the value
+     *               they hold.
+     * @param value Pointer to the value.
+     * @param buffer Buffer where the record will be appended.
+     * @note This function never locks. The serializers are read from a table
+     *       that enable() and disable() update atomically.
+     */
+    static void serialize(int typeId, const void* value, QByteArray& buffer);
+
+    /**
+     * @brief Serializes the value held by the given QVariant and appends the
+     *        record to the given buffer.
+     * @param var
+     * @param buffer
+     */
+    static void serialize(const QVariant& var, QByteArray& buffer);
+
+    /**
+     * @brief Reads a record written by serialize().
+     * @param data Pointer to the record. On success, it is advanced to the end
+     *             of the record.
+     * @param end Pointer to the end of the data.
+     * @param value Receives the value, or an invalid QVariant if the type is
+     *              unknown, has no deserializer or the payload is not valid.
+     * @return Returns false if the data ends before the end of the record.
+     */
+    static bool deserialize(const char*& data, const char* end, QVariant& value);
+
+    /**
+     * @brief Appends the given value as an unsigned LEB128 varint.
+     * @param value
+     * @param buffer
+     */
+    static void writeVarint(quint64 value, QByteArray& buffer);
+
+    /**
+     * @brief Appends the given value as a zigzag encoded varint.
+     * @param value
+     * @param buffer
+     */
+    static void writeSignedVarint(qint64 value, QByteArray& buffer);
+
+    /**
+     * @brief Reads an unsigned LEB128 varint.
+     * @param data Pointer to the varint. On success, it is advanced to the end
+     *             of the varint.
+     * @param end Pointer to the end of the data.
+     * @param value Receives the value.
+     * @return Returns false if the data ends before the end of the varint or
+     *         the varint is too long.
+     */
+    static bool readVarint(const char*& data, const char* end, quint64& value);
+
+    /**
+     * @brief Reads a zigzag encoded varint.
+     * @see readVarint()
+     */
+    static bool readSignedVarint(const char*& data, const char* end, qint64& value);
+
+private:
+
+    QMetaType::Type _typeId;
+    SerializerFunc _serializerFunc;
+    DeserializerFunc _deserializerFunc;
+
+};
+
+#define DECLARE_VALUE_SERIALIZER_FUNC(TYPE) \
+    static void TYPE##SerializerFunc(const void* value, QByteArray& buffer)
+
+#define DECLARE_VALUE_DESERIALIZER_FUNC(TYPE) \
+    static bool TYPE##DeserializerFunc(const char* data, int size, void* value)
+
+#define REGISTER_VALUE_SERIALIZER_FUNCS(TYPE) \
+    static QValueSerializer TYPE##SerializerFuncsRegister \
+    (static_cast<QMetaType::Type>(qMetaTypeId<TYPE>()) \
+    , &TYPE##SerializerFunc, &TYPE##DeserializerFunc)
+
+/**
+ * @brief Implements and registers a serializer that copies the value's bytes.
+ *        Only for trivially copyable types without pointers.
+ */
+#define IMPLEMENT_TRIVIAL_VALUE_SERIALIZER(TYPE) \
+    DECLARE_VALUE_SERIALIZER_FUNC(TYPE) { \
+    buffer.append(static_cast<const char*>(value), sizeof(TYPE)); \
+    } \
+    DECLARE_VALUE_DESERIALIZER_FUNC(TYPE) { \
+    if(size != static_cast<int>(sizeof(TYPE))) { \
+    return false; \
+    } \
+    std::memcpy(value, data, sizeof(TYPE)); \
+    return true; \
+    } \
+    REGISTER_VALUE_SERIALIZER_FUNCS(TYPE)
+
+#endif // QVALUESERIALIZER_H
@@ -20,6 +20,7 @@
 
 #include <QMutex>
 #include <QMultiHash>
+#include <QVector>
 #include <QString>
 #include <QUrl>
 #include <QUuid>
@@ -31,21 +32,125 @@
 #include <QRect>
 #include <QLine>
 
-static const QLatin1Char singleQuote       = QLatin1Char('\'');
-static const QLatin1Char doubleQuote       = QLatin1Char('"');
-static const QLatin1Char openParenthesis   = QLatin1Char('(');
-static const QLatin1Char closeParenthesis  = QLatin1Char(')');
-static const QLatin1Char openCurlyBracket  = QLatin1Char('{');
-static const QLatin1Char closeCurlyBracket = QLatin1Char('}');
-static const QLatin1Char asterisk          = QLatin1Char('*');
-static const QLatin1Char comma             = QLatin1Char(',');
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
 
+static const char singleQuote       = '\'';
+static const char doubleQuote       = '"';
+static const char openParenthesis   = '(';
+static const char closeParenthesis  = ')';
+static const char openCurlyBracket  = '{';
+static const char closeCurlyBracket = '}';
+static const char comma             = ',';
+
+/*
+ * The stringifiers append to QString buffers, in UTF-16, and to QByteArray
+ * buffers, in UTF-8, through these overloads.
+ */
+
+static inline void appendAscii(QString& buffer, char c) {
+    buffer.append(QLatin1Char(c));
+}
+
+static inline void appendAscii(QByteArray& buffer, char c) {
+    buffer.append(c);
+}
+
+static inline void appendAscii(QString& buffer, const char* chars, int length) {
+    buffer.append(QLatin1String(chars, length));
+}
+
+static inline void appendAscii(QByteArray& buffer, const char* chars, int length) {
+    buffer.append(chars, length);
+}
+
+template<int SIZE>
+static inline void appendAscii(QString& buffer, const char (&literal)[SIZE]) {
+    buffer.append(QLatin1String(literal, SIZE - 1));
+}
+
+template<int SIZE>
+static inline void appendAscii(QByteArray& buffer, const char (&literal)[SIZE]) {
+    buffer.append(literal, SIZE - 1);
+}
+
+static inline void appendString(QString& buffer, const QString& string) {
+    buffer.append(string);
+}
+
+static inline void appendString(QByteArray& buffer, const QString& string) {
+    QValueStringifier::appendUtf8(string, buffer);
+}
+
+/**
+ * @brief Registry of the value stringifiers.
+ * @details The registry itself is only accessed by enable() and disable(),
+ *          which lock a mutex if thread safe operations are enabled.
+ *          For stringify(), the most recently enabled stringifier of each type
+ *          is published in a flat table of atomic slots, indexed by type id,
+ *          that is read without locks or hash lookups.
+ *          Builtin types have a slot in a fixed array. User types have a slot
+ *          in chunks that are allocated on demand and never freed, so the
+ *          table can grow without moving the slots under the readers.
+ *          The slots point to interned stringifiers, that are also never
+ *          freed, so a reader never sees a stringifier being destroyed.
+ */
 class QValueStringifierData {
 
 public:
 
-    typedef QValueStringifier::StringifierFunc StringifierFunc;
-    typedef QMultiHash<QMetaType::Type, StringifierFunc> Stringifiers;
+    /**
+     * @brief The functions of a stringifier.
+     */
+    typedef QValueStringifier::Functions Stringifier;
+
+    static inline void stringify(const Stringifier& stringifier, int /*typeId*/
+                                 , const QVariant& var, QString& buffer) {
+        if(stringifier.stringifierFunc) {
+            stringifier.stringifierFunc(var, buffer);
+        } else {
+            stringifier.trampolineFunc(stringifier.typedFunc, var.constData(), buffer);
+        }
+    }
+
+    static inline void stringify(const Stringifier& stringifier, int typeId
+                                 , const void* value, QString& buffer) {
+        if(stringifier.stringifierFunc) {
+            stringifier.stringifierFunc(QVariant(typeId, value), buffer);
+        } else {
+            stringifier.trampolineFunc(stringifier.typedFunc, value, buffer);
+        }
+    }
+
+    /**
+     * @brief Stringifies the value with the UTF-8 stringifier or, if there is
+     *        none, into this thread's QString, that is then encoded into the
+     *        buffer.
+     */
+    template<typename VALUE>
+    static inline void stringify(const Stringifier& stringifier, int typeId
+                                 , const VALUE& value, QByteArray& buffer) {
+        if(stringifier.utf8TrampolineFunc) {
+            stringifier.utf8TrampolineFunc(stringifier.utf8TypedFunc
+                                           , constData(value), buffer);
+            return;
+        }
+        // A stringifier that stringifies into a QByteArray itself gets an
+        // empty QString, instead of the one in use.
+        static thread_local QString threadString;
+        QString string;
+        string.swap(threadString);
+        stringify(stringifier, typeId, value, string);
+        QValueStringifier::appendUtf8(string, buffer);
+        string.truncate(0);
+        threadString.swap(string);
+    }
+
+    typedef QMultiHash<QMetaType::Type, const Stringifier*> Stringifiers;
+    typedef std::atomic<const Stringifier*> Slot;
 
     QValueStringifierData()
         : _useMutex(_threadSafeAccess) {
@@ -60,20 +165,38 @@ public:
         }
     }
 
-    inline Stringifiers& getStringifiers() {
-        return _stringifiers;
-    }
-
     inline void enableStringifier(QMetaType::Type typeId
-                                  , StringifierFunc stringifierFunc) {
-        if(! _stringifiers.contains(typeId, stringifierFunc)) {
-            _stringifiers.insertMulti(typeId, stringifierFunc);
+                                  , const Stringifier& stringifier) {
+        const Stringifier* const interned = intern(stringifier);
+        if(! _stringifiers.contains(typeId, interned)) {
+            _stringifiers.insertMulti(typeId, interned);
+            updateSlot(typeId);
         }
     }
 
     inline void disableStringifier(QMetaType::Type typeId
-                                   , StringifierFunc stringifierFunc) {
-        _stringifiers.remove(typeId, stringifierFunc);
+                                   , const Stringifier& stringifier) {
+        // A stringifier that was never enabled is not interned.
+        const Stringifier* const interned = find(stringifier);
+        if(interned && _stringifiers.remove(typeId, interned) > 0) {
+            updateSlot(typeId);
+        }
+    }
+
+    /**
+     * @brief Returns the most recently enabled stringifier for the given type
+     *        or the stringifier for QMetaType::UnknownType if there is none.
+     * @note This function does not lock.
+     */
+    static inline const Stringifier* findStringifier(int typeId) {
+        const Slot* const slot = getSlot(typeId);
+        const Stringifier* stringifier
+                = slot ? slot->load(std::memory_order_acquire) : nullptr;
+        if(! stringifier) {
+            stringifier = _builtinSlots[QMetaType::UnknownType]
+                    .load(std::memory_order_acquire);
+        }
+        return stringifier;
     }
 
     static inline void enableThreadSafeAccess() {
@@ -86,15 +209,104 @@ public:
 
 private:
 
+    static inline const void* constData(const QVariant& var) {
+        return var.constData();
+    }
+
+    static inline const void* constData(const void* value) {
+        return value;
+    }
+
+    static const int builtinSlotCount = QMetaType::User;
+    static const int userChunkSize = 256;
+    static const int userChunkCount = 256;
+
+    /**
+     * @brief Returns the slot for the given type or nullptr if it does not
+     *        exist and createChunk is false.
+     */
+    static Slot* getSlot(int typeId, bool createChunk = false) {
+        if(typeId < 0) {
+            return nullptr;
+        }
+        if(typeId < builtinSlotCount) {
+            return &_builtinSlots[typeId];
+        }
+        const int index = typeId - builtinSlotCount;
+        const int chunkIndex = index / userChunkSize;
+        if(chunkIndex >= userChunkCount) {
+            return nullptr;
+        }
+        Slot* chunk = _userChunks[chunkIndex].load(std::memory_order_acquire);
+        if(! chunk && createChunk) {
+            Slot* const newChunk = new Slot[userChunkSize]();
+            if(_userChunks[chunkIndex].compare_exchange_strong(chunk, newChunk)) {
+                chunk = newChunk;
+            } else {
+                delete[] newChunk;
+            }
+        }
+        return chunk ? &chunk[index % userChunkSize] : nullptr;
+    }
+
+    /**
+     * @brief Returns the interned copy of the given stringifier or nullptr if
+     *        it was never interned.
+     */
+    static const Stringifier* find(const Stringifier& stringifier) {
+        for(const Stringifier* const interned : _interned) {
+            if(interned->stringifierFunc == stringifier.stringifierFunc
+                    && interned->trampolineFunc == stringifier.trampolineFunc
+                    && interned->typedFunc == stringifier.typedFunc
+                    && interned->utf8TrampolineFunc == stringifier.utf8TrampolineFunc
+                    && interned->utf8TypedFunc == stringifier.utf8TypedFunc) {
+                return interned;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Returns the interned copy of the given stringifier.
+     */
+    static const Stringifier* intern(const Stringifier& stringifier) {
+        const Stringifier* const interned = find(stringifier);
+        if(interned) {
+            return interned;
+        }
+        _interned.append(new Stringifier(stringifier));
+        return _interned.last();
+    }
+
+    /**
+     * @brief Publishes the most recently enabled stringifier of the given type.
+     */
+    static void updateSlot(QMetaType::Type typeId) {
+        Slot* const slot = getSlot(typeId, true);
+        if(slot) {
+            slot->store(_stringifiers.value(typeId, nullptr)
+                        , std::memory_order_release);
+        } else {
+            qWarning("QValueStringifier: type id %d is too large for the"
+                     " stringifiers table.", static_cast<int>(typeId));
+        }
+    }
+
     const bool _useMutex;
 
     static Stringifiers _stringifiers;
+    static QVector<const Stringifier*> _interned;
+    static Slot _builtinSlots[builtinSlotCount];
+    static std::atomic<Slot*> _userChunks[userChunkCount];
     static QMutex _mutex;
     static bool _threadSafeAccess;
 
 };
 
 QValueStringifierData::Stringifiers QValueStringifierData::_stringifiers;
+QVector<const QValueStringifierData::Stringifier*> QValueStringifierData::_interned;
+QValueStringifierData::Slot QValueStringifierData::_builtinSlots[QValueStringifierData::builtinSlotCount];
+std::atomic<QValueStringifierData::Slot*> QValueStringifierData::_userChunks[QValueStringifierData::userChunkCount];
 QMutex QValueStringifierData::_mutex;
 bool QValueStringifierData::_threadSafeAccess = false;
 
@@ -102,8 +314,19 @@ QValueStringifier::QValueStringifier(QMetaType::Type typeId
                                      , StringifierFunc stringifierFunc
                                      , bool enableAtConstruction)
     : _typeId(typeId)
-    , _stringifierFunc(stringifierFunc) {
-    Q_ASSERT(_stringifierFunc);
+    , _functions{stringifierFunc, nullptr, nullptr, nullptr, nullptr} {
+    Q_ASSERT(_functions.stringifierFunc);
+    if(enableAtConstruction) {
+        enable();
+    }
+}
+
+QValueStringifier::QValueStringifier(QMetaType::Type typeId
+                                     , const Functions& functions
+                                     , bool enableAtConstruction)
+    : _typeId(typeId)
+    , _functions(functions) {
+    Q_ASSERT(_functions.trampolineFunc && _functions.typedFunc);
     if(enableAtConstruction) {
         enable();
     }
@@ -118,15 +341,25 @@ QMetaType::Type QValueStringifier::getTypeId() const {
 }
 
 QValueStringifier::StringifierFunc QValueStringifier::getStringifierFunc() const {
-    return _stringifierFunc;
+    return _functions.stringifierFunc;
 }
 
 void QValueStringifier::enable() {
-    QValueStringifierData().enableStringifier(_typeId, _stringifierFunc);
+    enableStringifier(_typeId, _functions);
 }
 
 void QValueStringifier::disable() {
-    QValueStringifierData().disableStringifier(_typeId, _stringifierFunc);
+    disableStringifier(_typeId, _functions);
+}
+
+void QValueStringifier::enableStringifier(QMetaType::Type typeId
+                                          , const Functions& functions) {
+    QValueStringifierData().enableStringifier(typeId, functions);
+}
+
+void QValueStringifier::disableStringifier(QMetaType::Type typeId
+                                           , const Functions& functions) {
+    QValueStringifierData().disableStringifier(typeId, functions);
 }
 
 void QValueStringifier::enableThreadSafe() {
@@ -137,25 +370,87 @@ void QValueStringifier::disableThreadSafe() {
     QValueStringifierData::disableThreadSafeAccess();
 }
 
-void QValueStringifier::stringify(const QVariant& var, QString& buffer
+template<typename VALUE, typename BUFFER>
+static inline void stringifyValue(int typeId, const VALUE& value, BUFFER& buffer
                                   , bool withType) {
-    QValueStringifierData data;
-    const auto& stringifiers = data.getStringifiers();
-    auto iter = stringifiers.find(static_cast<QMetaType::Type>(var.userType()));
-    if(iter == stringifiers.constEnd()) {
-        iter = stringifiers.find(QMetaType::UnknownType);
-    }
+    const QValueStringifierData::Stringifier* const stringifier
+            = QValueStringifierData::findStringifier(typeId);
+    Q_ASSERT(stringifier);
     if(withType) {
-        buffer.append(QLatin1String(var.typeName()));
-        buffer.append(openParenthesis);
+        const char* const typeName = QMetaType::typeName(typeId);
+        if(typeName) {
+            appendAscii(buffer, typeName, static_cast<int>(qstrlen(typeName)));
+        }
+        appendAscii(buffer, openParenthesis);
     }
-    iter.value()(var, buffer);
+    QValueStringifierData::stringify(*stringifier, typeId, value, buffer);
     if(withType) {
-        buffer.append(closeParenthesis);
+        appendAscii(buffer, closeParenthesis);
     }
 }
 
-static void stringifyChar(const QChar& c, QString& buffer) {
+void QValueStringifier::stringify(const QVariant& var, QString& buffer
+                                  , bool withType) {
+    stringifyValue(var.userType(), var, buffer, withType);
+}
+
+void QValueStringifier::stringify(int typeId, const void* value, QString& buffer
+                                  , bool withType) {
+    stringifyValue(typeId, value, buffer, withType);
+}
+
+void QValueStringifier::stringify(const QVariant& var, QByteArray& buffer
+                                  , bool withType) {
+    stringifyValue(var.userType(), var, buffer, withType);
+}
+
+void QValueStringifier::stringify(int typeId, const void* value, QByteArray& buffer
+                                  , bool withType) {
+    stringifyValue(typeId, value, buffer, withType);
+}
+
+void QValueStringifier::appendUtf8(const QString& string, QByteArray& buffer) {
+    const int length = string.size();
+    if(length == 0) {
+        return;
+    }
+    // Each UTF-16 code unit needs at most 3 bytes. The buffer is resized
+    // once, with the growth of resize(), and shrunk to the bytes written.
+    const int initialSize = buffer.size();
+    buffer.resize(initialSize + length * 3);
+    uchar* out = reinterpret_cast<uchar*>(buffer.data()) + initialSize;
+    const ushort* const units = string.utf16();
+    for(int I = 0; I < length; ++I) {
+        const ushort unit = units[I];
+        if(unit < 0x80) {
+            *out++ = static_cast<uchar>(unit);
+        } else if(unit < 0x800) {
+            *out++ = static_cast<uchar>(0xc0 | (unit >> 6));
+            *out++ = static_cast<uchar>(0x80 | (unit & 0x3f));
+        } else if(QChar::isHighSurrogate(unit) && I + 1 < length
+                  && QChar::isLowSurrogate(units[I + 1])) {
+            const uint ucs4 = QChar::surrogateToUcs4(unit, units[++I]);
+            *out++ = static_cast<uchar>(0xf0 | (ucs4 >> 18));
+            *out++ = static_cast<uchar>(0x80 | ((ucs4 >> 12) & 0x3f));
+            *out++ = static_cast<uchar>(0x80 | ((ucs4 >> 6) & 0x3f));
+            *out++ = static_cast<uchar>(0x80 | (ucs4 & 0x3f));
+        } else {
+            // Unpaired surrogates are replaced by U+FFFD.
+            const ushort codePoint = QChar::isSurrogate(unit)
+                    ? static_cast<ushort>(QChar::ReplacementCharacter) : unit;
+            *out++ = static_cast<uchar>(0xe0 | (codePoint >> 12));
+            *out++ = static_cast<uchar>(0x80 | ((codePoint >> 6) & 0x3f));
+            *out++ = static_cast<uchar>(0x80 | (codePoint & 0x3f));
+        }
+    }
+    buffer.resize(static_cast<int>(out - reinterpret_cast<uchar*>(buffer.data())));
+}
+
+/**
+ * @brief Returns the escaped representation of the given character or nullptr
+ *        if the character is not in the escape table.
+ */
+static inline const char* escapeChar(ushort unicode) {
     static const char* const escapeTable[] = {
         "\\x00", "\\x01", "\\x02", "\\x03", "\\x04", "\\x05", "\\x06", "\\a"  ,
         "\\b"  , "\\t"  , "\\n"  , "\\v"  , "\\f"  , "\\r"  , "\\x0e", "\\x0f",
@@ -170,95 +465,284 @@ static void stringifyChar(const QChar& c, QString& buffer) {
         "P"    , "Q"    , "R"    , "S"    , "T"    , "U"    , "V"    , "W"    ,
         "X"    , "Y"    , "Z"    , "["    , "\\\\"
     };
-    const ushort unicode = c.unicode();
-    if(unicode < sizeof(escapeTable) / sizeof(escapeTable[0])) {
-        buffer.append(QLatin1String(escapeTable[unicode]));
+    return unicode < sizeof(escapeTable) / sizeof(escapeTable[0])
+            ? escapeTable[unicode] : nullptr;
+}
+
+/**
+ * @brief Appends the UTF-8 encoding of the given code point.
+ */
+static void appendUtf8(QByteArray& buffer, uint codePoint) {
+    if(codePoint < 0x80) {
+        buffer.append(static_cast<char>(codePoint));
+        return;
+    }
+    if(QChar::isSurrogate(codePoint)) {
+        // Unpaired surrogates are replaced by U+FFFD.
+        codePoint = QChar::ReplacementCharacter;
+    }
+    char chars[4];
+    int length;
+    if(codePoint < 0x800) {
+        chars[0] = static_cast<char>(0xc0 | (codePoint >> 6));
+        length = 2;
+    } else if(codePoint < 0x10000) {
+        chars[0] = static_cast<char>(0xe0 | (codePoint >> 12));
+        chars[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+        length = 3;
+    } else {
+        chars[0] = static_cast<char>(0xf0 | (codePoint >> 18));
+        chars[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f));
+        chars[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+        length = 4;
+    }
+    chars[length - 1] = static_cast<char>(0x80 | (codePoint & 0x3f));
+    buffer.append(chars, length);
+}
+
+static inline void appendChar(QString& buffer, const QChar& c) {
+    buffer.append(c);
+}
+
+static inline void appendChar(QByteArray& buffer, const QChar& c) {
+    appendUtf8(buffer, c.unicode());
+}
+
+template<typename BUFFER>
+static void stringifyChar(const QChar& c, BUFFER& buffer) {
+    const char* const escaped = escapeChar(c.unicode());
+    if(escaped) {
+        appendAscii(buffer, escaped, static_cast<int>(qstrlen(escaped)));
     } else {
-        buffer.append(c);
+        appendChar(buffer, c);
     }
 }
 
-static void stringifyChar(char c, QString& buffer) {
+template<typename BUFFER>
+static void stringifyChar(char c, BUFFER& buffer) {
     stringifyChar(QChar::fromLatin1(c), buffer);
 }
 
-static void stringifyPointer(const void* pointer, QString& buffer) {
+/*
+ * The numbers are formatted into a small array on the stack and appended to
+ * the buffer, so no temporary QString is allocated.
+ */
+
+static const char hexaDigits[] = "0123456789abcdef";
+
+static const char digitPairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+template<typename BUFFER>
+static void stringifyPointer(const void* pointer, BUFFER& buffer) {
     if(pointer) {
-        buffer.append(QLatin1Literal("0x"));
-        buffer.append(QString::number(reinterpret_cast<const quintptr>(pointer))
-                      .rightJustified(sizeof(void*) * 2, QLatin1Char('0')));
+        // "0x" and all the hexadecimal digits of the address, zero padded.
+        char chars[2 + sizeof(void*) * 2];
+        chars[0] = '0';
+        chars[1] = 'x';
+        quintptr address = reinterpret_cast<quintptr>(pointer);
+        for(int I = sizeof(chars) - 1; I >= 2; --I) {
+            chars[I] = hexaDigits[address & 0xf];
+            address >>= 4;
+        }
+        appendAscii(buffer, chars, sizeof(chars));
     } else {
-        buffer.append(QLatin1Literal("nullptr"));
+        appendAscii(buffer, "nullptr");
     }
 }
 
 template<typename TYPE>
-static void stringifyNumber(TYPE num, QString& buffer) {
-    buffer.append(QString::number(num));
+static inline bool isNegative(TYPE num, std::true_type /*isSigned*/) {
+    return num < 0;
 }
 
 template<typename TYPE>
-static void stringifyString(TYPE string, QString& buffer) {
-    buffer.append(doubleQuote);
+static inline bool isNegative(TYPE /*num*/, std::false_type /*isSigned*/) {
+    return false;
+}
+
+template<typename TYPE, typename BUFFER>
+static void stringifyNumber(TYPE num, BUFFER& buffer) {
+    static_assert(std::is_integral<TYPE>::value, "TYPE must be an integer type.");
+    typedef typename std::make_unsigned<TYPE>::type UnsignedType;
+    const bool negative = isNegative(num, std::is_signed<TYPE>());
+    UnsignedType magnitude = negative
+            ? static_cast<UnsignedType>(UnsignedType(0) - static_cast<UnsignedType>(num))
+            : static_cast<UnsignedType>(num);
+    // The digits are written backwards, two at a time, from the end.
+    char chars[24];
+    char* const end = chars + sizeof(chars);
+    char* begin = end;
+    while(magnitude >= 100) {
+        const int index = static_cast<int>(magnitude % 100) * 2;
+        magnitude /= 100;
+        *--begin = digitPairs[index + 1];
+        *--begin = digitPairs[index];
+    }
+    if(magnitude >= 10) {
+        const int index = static_cast<int>(magnitude) * 2;
+        *--begin = digitPairs[index + 1];
+        *--begin = digitPairs[index];
+    } else {
+        *--begin = static_cast<char>('0' + magnitude);
+    }
+    if(negative) {
+        *--begin = '-';
+    }
+    appendAscii(buffer, begin, static_cast<int>(end - begin));
+}
+
+static inline float readBack(const char* chars, float) {
+    return std::strtof(chars, nullptr);
+}
+
+static inline double readBack(const char* chars, double) {
+    return std::strtod(chars, nullptr);
+}
+
+/**
+ * @brief Appends the shortest representation of the number, in the %g format,
+ *        that reads back as the same number.
+ * @details Any number reads back with maxDigits significant digits, and a
+ *          number that reads back with minDigits or less significant digits
+ *          is printed with its shortest representation by %.minDigitsg,
+ *          so few numbers need more than one attempt.
+ */
+template<typename TYPE, typename BUFFER>
+static void stringifyFloatingPoint(TYPE num, int minDigits, int maxDigits
+                                   , BUFFER& buffer) {
+    if(num != num) {
+        appendAscii(buffer, "nan");
+        return;
+    }
+    if(num == std::numeric_limits<TYPE>::infinity()) {
+        appendAscii(buffer, "inf");
+        return;
+    }
+    if(num == -std::numeric_limits<TYPE>::infinity()) {
+        appendAscii(buffer, "-inf");
+        return;
+    }
+    char chars[32];
+    int length = 0;
+    for(int digits = minDigits; digits <= maxDigits; ++digits) {
+        length = std::snprintf(chars, sizeof(chars), "%.*g", digits
+                               , static_cast<double>(num));
+        if(readBack(chars, num) == num) {
+            break;
+        }
+    }
+    // The decimal point is the locale's, that may not be a '.' or may have
+    // more than one byte.
+    int out = 0;
+    for(int in = 0; in < length; ++in) {
+        const char c = chars[in];
+        if((c >= '0' && c <= '9') || c == '-' || c == '+' || c == 'e') {
+            chars[out++] = c;
+        } else if(out == 0 || chars[out - 1] != '.') {
+            chars[out++] = '.';
+        }
+    }
+    appendAscii(buffer, chars, out);
+}
+
+template<typename BUFFER>
+static void stringifyNumber(float num, BUFFER& buffer) {
+    stringifyFloatingPoint(num, std::numeric_limits<float>::digits10
+                           , std::numeric_limits<float>::max_digits10, buffer);
+}
+
+template<typename BUFFER>
+static void stringifyNumber(double num, BUFFER& buffer) {
+    stringifyFloatingPoint(num, std::numeric_limits<double>::digits10
+                           , std::numeric_limits<double>::max_digits10, buffer);
+}
+
+template<typename TYPE, typename BUFFER>
+static void stringifyString(const TYPE& string, BUFFER& buffer) {
+    appendAscii(buffer, doubleQuote);
     for(const auto c : string) {
         stringifyChar(c, buffer);
     }
-    buffer.append(doubleQuote);
+    appendAscii(buffer, doubleQuote);
+}
+
+/**
+ * @brief Stringifies a QString into a UTF-8 buffer, encoding the surrogate
+ *        pairs as one code point.
+ */
+static void stringifyString(const QString& string, QByteArray& buffer) {
+    appendAscii(buffer, doubleQuote);
+    const QChar* const chars = string.constData();
+    const int length = string.size();
+    for(int I = 0; I < length; ++I) {
+        const ushort unicode = chars[I].unicode();
+        if(QChar::isHighSurrogate(unicode) && I + 1 < length
+                && QChar::isLowSurrogate(chars[I + 1].unicode())) {
+            appendUtf8(buffer, QChar::surrogateToUcs4(unicode, chars[++I].unicode()));
+        } else {
+            stringifyChar(chars[I], buffer);
+        }
+    }
+    appendAscii(buffer, doubleQuote);
 }
 
-template<typename TYPE>
-static void stringifyNumberPair(TYPE n1, TYPE n2, QString& buffer) {
-    buffer.append(openCurlyBracket);
+template<typename TYPE, typename BUFFER>
+static void stringifyNumberPair(TYPE n1, TYPE n2, BUFFER& buffer) {
+    appendAscii(buffer, openCurlyBracket);
     stringifyNumber(n1, buffer);
-    buffer.append(comma);
+    appendAscii(buffer, comma);
     stringifyNumber(n2, buffer);
-    buffer.append(closeCurlyBracket);
+    appendAscii(buffer, closeCurlyBracket);
 }
 
-template<typename TYPE>
-static void stringifyNumberQuad(TYPE n1, TYPE n2, TYPE n3, TYPE n4, QString& buffer) {
-    buffer.append(openCurlyBracket);
+template<typename TYPE, typename BUFFER>
+static void stringifyNumberQuad(TYPE n1, TYPE n2, TYPE n3, TYPE n4, BUFFER& buffer) {
+    appendAscii(buffer, openCurlyBracket);
     stringifyNumber(n1, buffer);
-    buffer.append(comma);
+    appendAscii(buffer, comma);
     stringifyNumber(n2, buffer);
-    buffer.append(comma);
+    appendAscii(buffer, comma);
     stringifyNumber(n3, buffer);
-    buffer.append(comma);
+    appendAscii(buffer, comma);
     stringifyNumber(n4, buffer);
-    buffer.append(closeCurlyBracket);
+    appendAscii(buffer, closeCurlyBracket);
 }
 
-#define ASSERT_TYPE(TYPE) \
-    Q_ASSERT(var.userType() == qMetaTypeId<TYPE>())
-
 #define IMPLEMENT_NUMBER_STRINGIFIER(TYPE) \
-    IMPLEMENT_VALUE_STRINGIFIER(TYPE) { \
-    ASSERT_TYPE(TYPE); \
-    stringifyNumber(var.value<TYPE>(), buffer); \
+    IMPLEMENT_UTF8_VALUE_STRINGIFIER(TYPE) { \
+    stringifyNumber(value, buffer); \
     }
 
 #define IMPLEMENT_CHAR_STRINGIFIER(TYPE) \
-    IMPLEMENT_VALUE_STRINGIFIER(TYPE) { \
-    ASSERT_TYPE(TYPE); \
-    buffer.append(singleQuote); \
-    stringifyChar(var.value<TYPE>(), buffer); \
-    buffer.append(singleQuote); \
+    IMPLEMENT_UTF8_VALUE_STRINGIFIER(TYPE) { \
+    appendAscii(buffer, singleQuote); \
+    stringifyChar(value, buffer); \
+    appendAscii(buffer, singleQuote); \
     }
 
 #define IMPLEMENT_LIST_STRINGIFIER(TYPE, CODE) \
-    IMPLEMENT_VALUE_STRINGIFIER(TYPE) { \
-    ASSERT_TYPE(TYPE); \
-    buffer.append(openCurlyBracket); \
+    IMPLEMENT_UTF8_VALUE_STRINGIFIER(TYPE) { \
+    appendAscii(buffer, openCurlyBracket); \
     bool first = true; \
-    for(const auto& item : var.value<TYPE>()) { \
+    for(const auto& item : value) { \
     if(first) { \
     first = false; \
     } else { \
-    buffer.append(QLatin1Literal(", ")); \
+    appendAscii(buffer, ", "); \
     } \
     CODE; \
     } \
-    buffer.append(closeCurlyBracket); \
+    appendAscii(buffer, closeCurlyBracket); \
     }
 
 IMPLEMENT_NUMBER_STRINGIFIER(short)
@@ -290,112 +774,88 @@ DECLARE_VALUE_STRINGIFIER_FUNC(unknown) {
 static QValueStringifier unknownStringifierFuncRegister
     (QMetaType::UnknownType, &unknownStringifierFunc);
 
-IMPLEMENT_VALUE_STRINGIFIER(bool) {
-    ASSERT_TYPE(bool);
-    buffer.append(var.value<bool>()
-                  ? QLatin1Literal("true")
-                  : QLatin1Literal("false"));
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(bool) {
+    if(value) {
+        appendAscii(buffer, "true");
+    } else {
+        appendAscii(buffer, "false");
+    }
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QString) {
-    ASSERT_TYPE(QString);
-    stringifyString(var.value<QString>(), buffer);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QString) {
+    stringifyString(value, buffer);
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QByteArray) {
-    ASSERT_TYPE(QByteArray);
-    stringifyString(var.value<QByteArray>(), buffer);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QByteArray) {
+    stringifyString(value, buffer);
 }
 
 typedef QObject* qobjectstar;
-IMPLEMENT_VALUE_STRINGIFIER(qobjectstar) {
-    ASSERT_TYPE(QObject*);
-    stringifyPointer(var.value<QObject*>(), buffer);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(qobjectstar) {
+    stringifyPointer(value, buffer);
 }
 
 typedef void* voidstar;
-IMPLEMENT_VALUE_STRINGIFIER(voidstar) {
-    ASSERT_TYPE(void*);
-    stringifyPointer(var.value<void*>(), buffer);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(voidstar) {
+    stringifyPointer(value, buffer);
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QUuid) {
-    ASSERT_TYPE(QUuid);
-    buffer.append(var.value<QUuid>().toString());
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QUuid) {
+    appendString(buffer, value.toString());
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QDate) {
-    ASSERT_TYPE(QDate);
-    buffer.append(openCurlyBracket);
-    buffer.append(var.value<QDate>().toString(QStringLiteral("yyyy-MM-dd")));
-    buffer.append(closeCurlyBracket);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QDate) {
+    appendAscii(buffer, openCurlyBracket);
+    appendString(buffer, value.toString(QStringLiteral("yyyy-MM-dd")));
+    appendAscii(buffer, closeCurlyBracket);
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QTime) {
-    ASSERT_TYPE(QTime);
-    buffer.append(openCurlyBracket);
-    buffer.append(var.value<QTime>().toString(QStringLiteral("HH:mm:ss")));
-    buffer.append(closeCurlyBracket);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QTime) {
+    appendAscii(buffer, openCurlyBracket);
+    appendString(buffer, value.toString(QStringLiteral("HH:mm:ss")));
+    appendAscii(buffer, closeCurlyBracket);
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QDateTime) {
-    ASSERT_TYPE(QDateTime);
-    buffer.append(openCurlyBracket);
-    buffer.append(var.value<QDateTime>().toString(QStringLiteral("yyyy-MM-dd HH:mm:ss")));
-    buffer.append(closeCurlyBracket);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QDateTime) {
+    appendAscii(buffer, openCurlyBracket);
+    appendString(buffer, value.toString(QStringLiteral("yyyy-MM-dd HH:mm:ss")));
+    appendAscii(buffer, closeCurlyBracket);
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QUrl) {
-    ASSERT_TYPE(QUrl);
-    buffer.append(openCurlyBracket);
-    buffer.append(var.value<QUrl>().toString());
-    buffer.append(closeCurlyBracket);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QUrl) {
+    appendAscii(buffer, openCurlyBracket);
+    appendString(buffer, value.toString());
+    appendAscii(buffer, closeCurlyBracket);
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QPoint) {
-    ASSERT_TYPE(QPoint);
-    const QPoint point = var.value<QPoint>();
-    stringifyNumberPair(point.x(), point.y(), buffer);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QPoint) {
+    stringifyNumberPair(value.x(), value.y(), buffer);
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QPointF) {
-    ASSERT_TYPE(QPointF);
-    const QPointF point = var.value<QPointF>();
-    stringifyNumberPair(point.x(), point.y(), buffer);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QPointF) {
+    stringifyNumberPair(value.x(), value.y(), buffer);
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QSize) {
-    ASSERT_TYPE(QSize);
-    const QSize size = var.value<QSize>();
-    stringifyNumberPair(size.width(), size.height(), buffer);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QSize) {
+    stringifyNumberPair(value.width(), value.height(), buffer);
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QSizeF) {
-    ASSERT_TYPE(QSizeF);
-    const QSizeF size = var.value<QSizeF>();
-    stringifyNumberPair(size.width(), size.height(), buffer);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QSizeF) {
+    stringifyNumberPair(value.width(), value.height(), buffer);
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QRect) {
-    ASSERT_TYPE(QRect);
-    const QRect rect = var.value<QRect>();
-    stringifyNumberQuad(rect.x(), rect.y(), rect.width(), rect.height(), buffer);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QRect) {
+    stringifyNumberQuad(value.x(), value.y(), value.width(), value.height(), buffer);
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QRectF) {
-    ASSERT_TYPE(QRectF);
-    const QRectF rect = var.value<QRectF>();
-    stringifyNumberQuad(rect.x(), rect.y(), rect.width(), rect.height(), buffer);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QRectF) {
+    stringifyNumberQuad(value.x(), value.y(), value.width(), value.height(), buffer);
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QLine) {
-    ASSERT_TYPE(QLine);
-    const QLine line = var.value<QLine>();
-    stringifyNumberQuad(line.x1(), line.y1(), line.x2(), line.y2(), buffer);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QLine) {
+    stringifyNumberQuad(value.x1(), value.y1(), value.x2(), value.y2(), buffer);
 }
 
-IMPLEMENT_VALUE_STRINGIFIER(QLineF) {
-    ASSERT_TYPE(QLineF);
-    const QLineF line = var.value<QLineF>();
-    stringifyNumberQuad(line.x1(), line.y1(), line.x2(), line.y2(), buffer);
+IMPLEMENT_UTF8_VALUE_STRINGIFIER(QLineF) {
+    stringifyNumberQuad(value.x1(), value.y1(), value.x2(), value.y2(), buffer);
 }
@@ -20,11 +20,14 @@
 #define QVALUESTRINGIFIER_H
 
 #include <QString>
+#include <QByteArray>
 #include <QVariant>
 #include <QMetaType>
 
 class QValueStringifier {
 
+    friend class QValueStringifierData;
+
 public:
 
     /**
@@ -32,6 +35,24 @@ public:
      */
     typedef void (*StringifierFunc)(const QVariant& var, QString& buffer);
 
+    /**
+     * @brief Typed stringifier functions of values of type T must have this
+     *        signature.
+     * @note Typed stringifiers receive a reference to the value in place,
+     *       without it being copied out of a QVariant.
+     */
+    template <typename T>
+    using TypedStringifierFunc = void (*)(const T& value, QString& buffer);
+
+    /**
+     * @brief Typed UTF-8 stringifier functions of values of type T must have
+     *        this signature.
+     * @note A UTF-8 stringifier appends the same string as the typed
+     *       stringifier it is registered with, encoded in UTF-8.
+     */
+    template <typename T>
+    using TypedUtf8StringifierFunc = void (*)(const T& value, QByteArray& buffer);
+
     /**
      * @brief Constructor.
      * @param typeId Id of the type to be stringified.
@@ -48,6 +69,46 @@ public:
     QValueStringifier(QMetaType::Type typeId, StringifierFunc stringifierFunc
                       , bool enableAtConstruction = true);
 
+    /**
+     * @brief Constructor of a typed stringifier.
+     * @param stringifierFunc Pointer to the function that actually stringifies
+     *                        the values of type T.
+     * @param enableAtConstruction If true, the stringifier will be enabled at
+     *                             construction.
+     *                             If false, the enable() method needs to be
+     *                             called explicitly to enable the stringifier.
+     * @note The type id is qMetaTypeId<T>(), so custom types must be declared
+     *       with Q_DECLARE_METATYPE(TYPE).
+     */
+    template <typename T>
+    explicit QValueStringifier(TypedStringifierFunc<T> stringifierFunc
+                               , bool enableAtConstruction = true)
+        : QValueStringifier(static_cast<QMetaType::Type>(qMetaTypeId<T>())
+                            , typedFunctions<T>(stringifierFunc, nullptr)
+                            , enableAtConstruction) {
+    }
+
+    /**
+     * @brief Constructor of a typed stringifier with a UTF-8 stringifier,
+     *        used to stringify the values into QByteArray buffers.
+     * @param stringifierFunc Pointer to the function that actually stringifies
+     *                        the values of type T.
+     * @param utf8StringifierFunc Pointer to the function that stringifies the
+     *                            values of type T in UTF-8.
+     * @param enableAtConstruction If true, the stringifier will be enabled at
+     *                             construction.
+     *                             If false, the enable() method needs to be
+     *                             called explicitly to enable the stringifier.
+     */
+    template <typename T>
+    QValueStringifier(TypedStringifierFunc<T> stringifierFunc
+                      , TypedUtf8StringifierFunc<T> utf8StringifierFunc
+                      , bool enableAtConstruction = true)
+        : QValueStringifier(static_cast<QMetaType::Type>(qMetaTypeId<T>())
+                            , typedFunctions<T>(stringifierFunc, utf8StringifierFunc)
+                            , enableAtConstruction) {
+    }
+
     /**
       * @brief Destructor.
       */
@@ -61,7 +122,7 @@ public:
 
     /**
      * @brief Returns the stringifier function pointer.
-     * @return
+     * @return The function pointer or nullptr if it is a typed stringifier.
      */
     StringifierFunc getStringifierFunc() const;
 
@@ -82,6 +143,8 @@ public:
      *       enable() or disable() with multiple threads running.
      *       If all stringifiers are constructed and enabled/disabled before
      *       any threads are used then there is no need to call this function.
+     * @note stringify() never locks, it reads the stringifiers from a table
+     *       that enable() and disable() update atomically.
      */
     static void enableThreadSafe();
 
@@ -104,10 +167,161 @@ public:
     static void stringify(const QVariant& var, QString& buffer
                           , bool withType = false);
 
+    /**
+     * @brief Stringify the value of the given type at the given address and
+     *        append it to the given buffer.
+     * @param typeId Id of the value's type.
+     * @param value Pointer to the value.
+     * @param buffer Buffer where the stringified value will be appended.
+     * @param withType If true, the stringified value will be prefixed by the
+     *                 type and wrapped in parenthesis, like TYPE(STRVALUE).
+     * @note Typed stringifiers are called with the value in place. The value
+     *       is only copied into a QVariant for stringifiers with a
+     *       StringifierFunc.
+     */
+    static void stringify(int typeId, const void* value, QString& buffer
+                          , bool withType = false);
+
+    /**
+     * @brief Stringify the given object and append it, encoded in UTF-8, to
+     *        the given buffer.
+     * @note Stringifiers with a UTF-8 stringifier append to the buffer
+     *       directly. The others stringify the value into a reused QString
+     *       that is then encoded into the buffer.
+     */
+    static void stringify(const QVariant& var, QByteArray& buffer
+                          , bool withType = false);
+
+    /**
+     * @brief Stringify the value of the given type at the given address and
+     *        append it, encoded in UTF-8, to the given buffer.
+     */
+    static void stringify(int typeId, const void* value, QByteArray& buffer
+                          , bool withType = false);
+
+    /**
+     * @brief Appends the given string, encoded in UTF-8, to the given buffer,
+     *        without a temporary QByteArray.
+     * @param string
+     * @param buffer
+     */
+    static void appendUtf8(const QString& string, QByteArray& buffer);
+
+    /**
+     * @brief Registers and enables a typed stringifier for the type T, that
+     *        stays enabled until unregisterType() is called.
+     * @param stringifierFunc Pointer to the function that actually stringifies
+     *                        the values of type T.
+     * @note The type id is qMetaTypeId<T>(), so custom types must be declared
+     *       with Q_DECLARE_METATYPE(TYPE).
+     */
+    template <typename T>
+    static void registerType(TypedStringifierFunc<T> stringifierFunc) {
+        enableStringifier(static_cast<QMetaType::Type>(qMetaTypeId<T>())
+                          , typedFunctions<T>(stringifierFunc, nullptr));
+    }
+
+    /**
+     * @brief Registers and enables a typed stringifier with a UTF-8
+     *        stringifier for the type T.
+     */
+    template <typename T>
+    static void registerType(TypedStringifierFunc<T> stringifierFunc
+                             , TypedUtf8StringifierFunc<T> utf8StringifierFunc) {
+        enableStringifier(static_cast<QMetaType::Type>(qMetaTypeId<T>())
+                          , typedFunctions<T>(stringifierFunc, utf8StringifierFunc));
+    }
+
+    /**
+     * @brief Disables a typed stringifier registered by registerType().
+     * @param stringifierFunc The function pointer given to registerType().
+     */
+    template <typename T>
+    static void unregisterType(TypedStringifierFunc<T> stringifierFunc) {
+        disableStringifier(static_cast<QMetaType::Type>(qMetaTypeId<T>())
+                           , typedFunctions<T>(stringifierFunc, nullptr));
+    }
+
+    /**
+     * @brief Disables a typed stringifier registered by registerType() with
+     *        a UTF-8 stringifier.
+     */
+    template <typename T>
+    static void unregisterType(TypedStringifierFunc<T> stringifierFunc
+                               , TypedUtf8StringifierFunc<T> utf8StringifierFunc) {
+        disableStringifier(static_cast<QMetaType::Type>(qMetaTypeId<T>())
+                           , typedFunctions<T>(stringifierFunc, utf8StringifierFunc));
+    }
+
 private:
 
+    /**
+     * @brief Generic function pointer type, used to store the typed
+     *        stringifier functions.
+     */
+    typedef void (*GenericFunc)();
+
+    /**
+     * @brief Calls the typed stringifier function with the value.
+     */
+    typedef void (*TrampolineFunc)(GenericFunc typedFunc, const void* value
+                                   , QString& buffer);
+
+    /**
+     * @brief Calls the typed UTF-8 stringifier function with the value.
+     */
+    typedef void (*Utf8TrampolineFunc)(GenericFunc utf8TypedFunc, const void* value
+                                       , QByteArray& buffer);
+
+    /**
+     * @brief The functions of a stringifier. Either stringifierFunc or
+     *        trampolineFunc and typedFunc are set. The UTF-8 functions are
+     *        optional.
+     */
+    struct Functions {
+        StringifierFunc stringifierFunc;
+        TrampolineFunc trampolineFunc;
+        GenericFunc typedFunc;
+        Utf8TrampolineFunc utf8TrampolineFunc;
+        GenericFunc utf8TypedFunc;
+    };
+
+    template <typename T>
+    static void typedTrampoline(GenericFunc typedFunc, const void* value
+                                , QString& buffer) {
+        reinterpret_cast<TypedStringifierFunc<T>>(typedFunc)(
+                    *static_cast<const T*>(value), buffer);
+    }
+
+    template <typename T>
+    static void typedUtf8Trampoline(GenericFunc utf8TypedFunc, const void* value
+                                    , QByteArray& buffer) {
+        reinterpret_cast<TypedUtf8StringifierFunc<T>>(utf8TypedFunc)(
+                    *static_cast<const T*>(value), buffer);
+    }
+
+    template <typename T>
+    static Functions typedFunctions(TypedStringifierFunc<T> stringifierFunc
+                                    , TypedUtf8StringifierFunc<T> utf8StringifierFunc) {
+        const Functions functions = {
+            nullptr,
+            &typedTrampoline<T>,
+            reinterpret_cast<GenericFunc>(stringifierFunc),
+            utf8StringifierFunc ? &typedUtf8Trampoline<T> : nullptr,
+            reinterpret_cast<GenericFunc>(utf8StringifierFunc)
+        };
+        return functions;
+    }
+
+    QValueStringifier(QMetaType::Type typeId, const Functions& functions
+                      , bool enableAtConstruction);
+
+    static void enableStringifier(QMetaType::Type typeId, const Functions& functions);
+
+    static void disableStringifier(QMetaType::Type typeId, const Functions& functions);
+
     QMetaType::Type _typeId;
-    StringifierFunc _stringifierFunc;
+    Functions _functions;
 
 };
 
@@ -123,4 +337,33 @@ private:
     REGISTER_VALUE_STRINGIFIER_FUNC(TYPE); \
     DECLARE_VALUE_STRINGIFIER_FUNC(TYPE)
 
+#define DECLARE_TYPED_VALUE_STRINGIFIER_FUNC(TYPE) \
+    static void TYPE##StringifierFunc(const TYPE& value, QString& buffer)
+
+#define REGISTER_TYPED_VALUE_STRINGIFIER_FUNC(TYPE) \
+    static QValueStringifier TYPE##StringifierFuncRegister(&TYPE##StringifierFunc)
+
+#define IMPLEMENT_TYPED_VALUE_STRINGIFIER(TYPE) \
+    DECLARE_TYPED_VALUE_STRINGIFIER_FUNC(TYPE); \
+    REGISTER_TYPED_VALUE_STRINGIFIER_FUNC(TYPE); \
+    DECLARE_TYPED_VALUE_STRINGIFIER_FUNC(TYPE)
+
+/*
+ * Declares a template stringifier function, TYPE##StringifierFunc<BUFFER>,
+ * that must append to a QString and to a QByteArray, in UTF-8, and registers
+ * both instantiations.
+ */
+#define DECLARE_UTF8_VALUE_STRINGIFIER_FUNC(TYPE) \
+    template <typename BUFFER> \
+    static void TYPE##StringifierFunc(const TYPE& value, BUFFER& buffer)
+
+#define REGISTER_UTF8_VALUE_STRINGIFIER_FUNC(TYPE) \
+    static QValueStringifier TYPE##StringifierFuncRegister \
+    (&TYPE##StringifierFunc<QString>, &TYPE##StringifierFunc<QByteArray>)
+
+#define IMPLEMENT_UTF8_VALUE_STRINGIFIER(TYPE) \
+    DECLARE_UTF8_VALUE_STRINGIFIER_FUNC(TYPE); \
+    REGISTER_UTF8_VALUE_STRINGIFIER_FUNC(TYPE); \
+    DECLARE_UTF8_VALUE_STRINGIFIER_FUNC(TYPE)
+
 #endif // QVALUESTRINGIFIER_H
@@ -18,7 +18,14 @@ INCLUDEPATH += \
     QMethodStringifier \
     QUniversalSlot \
     QSignalLogger \
-    QSignalDumper
+    QSignalDumper \
+    QSlotProfiler \
+    QSignalCascadeTracer \
+    QSignalTraceExporter \
+    QSignalCounter \
+    QValueSerializer \
+    QSignalCaptureReader \
+    QSignalQueueMonitor
 
 HEADERS += \
     QUniversalSlot/QUniversalSlot.h \
@@ -28,7 +35,14 @@ HEADERS += \
     QSignalDumper/QSignalDumper.h \
     QAddressWiper/QAddressWiper.h \
     QValueStringifier/QValueStringifier.h \
-    QObjectStringifier/QObjectStringifier.h
+    QObjectStringifier/QObjectStringifier.h \
+    QSlotProfiler/QSlotProfiler.h \
+    QSignalCascadeTracer/QSignalCascadeTracer.h \
+    QSignalTraceExporter/QSignalTraceExporter.h \
+    QSignalCounter/QSignalCounter.h \
+    QValueSerializer/QValueSerializer.h \
+    QSignalCaptureReader/QSignalCaptureReader.h \
+    QSignalQueueMonitor/QSignalQueueMonitor.h
 
 SOURCES += \
     QSignalSlotMonitor/QSignalSlotMonitor.cpp \
@@ -37,7 +51,14 @@ SOURCES += \
     QSignalLogger/QSignalLogger.cpp \
     QSignalDumper/QSignalDumper.cpp \
     QValueStringifier/QValueStringifier.cpp \
-    QObjectStringifier/QObjectStringifier.cpp
+    QObjectStringifier/QObjectStringifier.cpp \
+    QSlotProfiler/QSlotProfiler.cpp \
+    QSignalCascadeTracer/QSignalCascadeTracer.cpp \
+    QSignalTraceExporter/QSignalTraceExporter.cpp \
+    QSignalCounter/QSignalCounter.cpp \
+    QValueSerializer/QValueSerializer.cpp \
+    QSignalCaptureReader/QSignalCaptureReader.cpp \
+    QSignalQueueMonitor/QSignalQueueMonitor.cpp
 
 # Wrap the moc to post process the moc_*.cpp files and change the call to xslot()
 # to pass it a pointer to all the signal's parameters pointers.
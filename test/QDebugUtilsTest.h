@@ -50,15 +50,22 @@ private slots:
 
     void testQValueStringifier();
     void testQValueStringifier_data();
+    void testQValueStringifier_RegisterType();
+    void testQValueStringifier_EnableDisable();
 
     void testQObjectStringifier();
     void testQObjectStringifier_data();
+    void testQObjectStringifier_Memoization();
 
     void testQMethodStringifier();
     void testQMethodStringifier_data();
 
     void testQSignalSlotMonitor();
     void testQSignalSlotMonitor_Lambda();
+    void testQSignalSlotMonitor_Threads();
+    void testQSignalSlotMonitor_ThreadStacks();
+    void testQSignalSlotMonitor_MetaObjectReuse();
+    void testQSignalSlotMonitor_Sampling();
     void testQSignalSlotMonitor_SignalNoMonitorBenchmark();
     void testQSignalSlotMonitor_SignalWithMonitorBenchmark();
     void testQSignalSlotMonitor_SignalSlotNoMonitorBenchmark();
@@ -68,13 +75,41 @@ private slots:
     void testQUniversalSlot();
     void testQUniversalSlot_Benchmark();
     void testQUniversalSlot_EverythingBenchmark();
+    void testQUniversalSlot_Filters();
     void testQUniversalSlot_data();
 
     void testQSignalLogger();
     void testQSignalLogger_data();
+    void testQSignalLogger_RingBuffer();
+    void testQSignalLogger_RingBuffer_data();
+    void testQSignalLogger_CaptureFile();
+    void testQSignalLogger_CaptureFile_data();
+    void testQSignalLogger_Query();
+    void testQSignalLogger_Query_data();
 
     void testQSignalDumper();
     void testQSignalDumper_data();
+    void testQSignalDumper_Async();
+    void testQSignalDumper_Async_data();
+    void testQSignalDumper_AsyncDeletedObject();
+
+    void testQSlotProfiler();
+    void testQSlotProfiler_Histogram();
+    void testQSlotProfiler_ReEnable();
+
+    void testQSignalCascadeTracer();
+    void testQSignalCascadeTracer_ReEnable();
+
+    void testQSignalTraceExporter();
+
+    void testQSignalCounter();
+
+    void testQValueSerializer();
+    void testQValueSerializer_data();
+    void testQValueSerializer_Records();
+
+    void testQSignalCaptureReader();
+    void testQSignalQueueMonitor();
 
 private:
 
@@ -34,6 +34,7 @@ void QTestSignalSlotMonitor::signalBegin(const SignalInfo& signalInfo) {
                               QMetaMethod(),
                               signalInfo.getParametersPointers(),
                               signalInfo.getParameters(),
+                              signalInfo.getParametersView().toVariants(),
                           });
 }
 
@@ -48,6 +49,7 @@ void QTestSignalSlotMonitor::signalEnd(const SignalInfo& signalInfo) {
                               QMetaMethod(),
                               signalInfo.getParametersPointers(),
                               signalInfo.getParameters(),
+                              signalInfo.getParametersView().toVariants(),
                           });
 }
 
@@ -63,6 +65,7 @@ void QTestSignalSlotMonitor::slotBegin(const SignalInfo& signalInfo
                               slotInfo.getMetaMethod(),
                               signalInfo.getParametersPointers(),
                               signalInfo.getParameters(),
+                              signalInfo.getParametersView().toVariants(),
                           });
 }
 
@@ -78,6 +81,7 @@ void QTestSignalSlotMonitor::slotEnd(const SignalInfo& signalInfo
                               slotInfo.getMetaMethod(),
                               signalInfo.getParametersPointers(),
                               signalInfo.getParameters(),
+                              signalInfo.getParametersView().toVariants(),
                           });
 }
 
@@ -44,6 +44,7 @@ public:
         QMetaMethod slotMetaMethod;
         const void* const* parametersPointers;
         QVector<QVariant> parameters;
+        QVector<QVariant> viewParameters;
 
         bool operator ==(const CallRecord& other) const;
     };
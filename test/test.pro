@@ -20,7 +20,14 @@ INCLUDEPATH += \
     ../lib/QMethodStringifier \
     ../lib/QSignalDumper \
     ../lib/QSignalLogger \
-    ../lib/QAddressWiper
+    ../lib/QAddressWiper \
+    ../lib/QSlotProfiler \
+    ../lib/QSignalCascadeTracer \
+    ../lib/QSignalTraceExporter \
+    ../lib/QSignalCounter \
+    ../lib/QValueSerializer \
+    ../lib/QSignalCaptureReader \
+    ../lib/QSignalQueueMonitor
 
 HEADERS += \
     QDebugUtilsTest.h \
@@ -44,7 +51,14 @@ SOURCES += \
     testQSignalSlotMonitor.cpp \
     QTestUniversalSlot.cpp \
     testQValueStringifier.cpp \
-    testQObjectStringifier.cpp
+    testQObjectStringifier.cpp \
+    testQSlotProfiler.cpp \
+    testQSignalCascadeTracer.cpp \
+    testQSignalTraceExporter.cpp \
+    testQSignalCounter.cpp \
+    testQValueSerializer.cpp \
+    testQSignalCaptureReader.cpp \
+    testQSignalQueueMonitor.cpp
 
 DEFINES += SRCDIR=\\\"$$PWD/\\\"
 
@@ -63,6 +63,14 @@ void QDebugUtilsTest::testQAddressWiper_data() {
     QTest::newRow("7")
             << QStringLiteral("123 0xf0e1d2c3 abc 0x01234567 xyz")
             << QStringLiteral("123 0xffffffff abc 0xffffffff xyz");
+
+    QTest::newRow("8")
+            << QStringLiteral("0x012345670x01234567")
+            << QStringLiteral("0xffffffff0x01234567");
+
+    QTest::newRow("9")
+            << QStringLiteral("0x01234567 0x0123456 0x01234567 0x0A234567 0x01234567")
+            << QStringLiteral("0xffffffff 0x0123456 0xffffffff 0x0A234567 0xffffffff");
 }
 #elif QT_POINTER_SIZE == 8
 void QDebugUtilsTest::testQAddressWiper_data() {
@@ -108,6 +116,16 @@ void QDebugUtilsTest::testQAddressWiper_data() {
     QTest::newRow("123 0xff0e1d2c3b4a59687 abc 0x0123456789abcdef xyz")
             << QStringLiteral("123 0xff0e1d2c3b4a59687 abc 0x0123456789abcdef xyz")
             << QStringLiteral("123 0xffffffffffffffff7 abc 0xffffffffffffffff xyz");
+
+    QTest::newRow("0x0123456789abcdef0x0123456789abcdef")
+            << QStringLiteral("0x0123456789abcdef0x0123456789abcdef")
+            << QStringLiteral("0xffffffffffffffff0x0123456789abcdef");
+
+    QTest::newRow("long with invalid look-alikes")
+            << QStringLiteral("0x0123456789abcdef 0x0123456789abcde 0x0123456789abcdef"
+                              " 0x0123456789ABCDEF 0x0123456789abcdef")
+            << QStringLiteral("0xffffffffffffffff 0x0123456789abcde 0xffffffffffffffff"
+                              " 0x0123456789ABCDEF 0xffffffffffffffff");
 }
 #else
 #error "Must define QDebugUtilsTest::testQAddressWiper_data() for target architecture."
@@ -58,6 +58,19 @@ void QDebugUtilsTest::testQMethodStringifier() {
     QCOMPARE(QStringAddressWiper::copywipe(
                  methodStringifier.stringify(object, metaMethod, parameters))
              , expectedResultWithParameters);
+
+    QString buffer(QStringLiteral("prefix:"));
+    QVERIFY(methodStringifier.stringify(object, object->objectName()
+                                        , object->metaObject(), metaMethod
+                                        , parameters, buffer));
+    QCOMPARE(QStringAddressWiper::copywipe(buffer)
+             , QStringLiteral("prefix:") + expectedResultWithParameters);
+
+    QByteArray utf8Buffer(QByteArrayLiteral("prefix:"));
+    QVERIFY(methodStringifier.stringify(object, object->objectName()
+                                        , object->metaObject(), metaMethod
+                                        , parameters, utf8Buffer));
+    QCOMPARE(QString::fromUtf8(utf8Buffer), buffer);
 }
 
 void QDebugUtilsTest::testQMethodStringifier_data() {
@@ -25,6 +25,8 @@
 #include "QTestSignalerD.h"
 
 #include <QScopedPointer>
+#include <QThread>
+#include <QSemaphore>
 
 #if QT_POINTER_SIZE == 4
 #define POINTER_MARK "0xffffffff"
@@ -154,3 +156,69 @@ void QDebugUtilsTest::testQObjectStringifier_data() {
             << QStringLiteral("<QTestSignalerD>")
             << QStringLiteral("QObject*(<QTestSignalerD>)");
 }
+
+void QDebugUtilsTest::testQObjectStringifier_Memoization() {
+    static const int steps = 3;
+
+    // Stringifies the object once per step, in its own thread, so its cache
+    // is filled before the main thread changes the stringifiers.
+    class QStringifierThread : public QThread {
+    public:
+        QStringifierThread(const QObject* object) : _object(object) {}
+        // Lets the thread finish if a comparison failed before the last step.
+        ~QStringifierThread() { stepStarted.release(steps); wait(); }
+        QSemaphore stepStarted;
+        QSemaphore stepDone;
+        QStringList stringified;
+        virtual void run() override {
+            for(int I = 0; I < steps; ++I) {
+                stepStarted.acquire();
+                QString buffer;
+                QObjectStringifier::stringify(_object, buffer);
+                stringified.append(buffer);
+                stepDone.release();
+            }
+        }
+    private:
+        const QObject* _object;
+    };
+
+    QTestSignalerD testSignalerD;
+    auto stringified = [&] () {
+        QString buffer;
+        QObjectStringifier::stringify(&testSignalerD, buffer);
+        return buffer;
+    };
+
+    QStringifierThread thread(&testSignalerD);
+    thread.start();
+    auto threadStep = [&] () {
+        thread.stepStarted.release();
+        thread.stepDone.acquire();
+    };
+
+    // The base class stringifier is used for the derived class, and again
+    // from the cache.
+    QObjectStringifier testSignalerStringifier(&QTestSignaler::staticMetaObject
+                                               , &QTestSignalerStringifierFunc);
+    QCOMPARE(stringified(), QStringLiteral("<QTestSignaler>"));
+    QCOMPARE(stringified(), QStringLiteral("<QTestSignaler>"));
+    threadStep();
+
+    // A more specific stringifier invalidates the cached entries.
+    QObjectStringifier testSignalerDStringifier(&QTestSignalerD::staticMetaObject
+                                                , &QTestSignalerDStringifierFunc);
+    QCOMPARE(stringified(), QStringLiteral("<QTestSignalerD>"));
+    threadStep();
+
+    // And so does disabling it.
+    testSignalerDStringifier.disable();
+    QCOMPARE(stringified(), QStringLiteral("<QTestSignaler>"));
+    threadStep();
+
+    QVERIFY(thread.wait());
+    QCOMPARE(thread.stringified, QStringList()
+             << QStringLiteral("<QTestSignaler>")
+             << QStringLiteral("<QTestSignalerD>")
+             << QStringLiteral("<QTestSignaler>"));
+}
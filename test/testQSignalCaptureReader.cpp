@@ -0,0 +1,116 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QDebugUtilsTest.h"
+#include "QSignalCaptureReader.h"
+#include "QSignalLogger.h"
+#include "QTestSignaler.h"
+
+#include <QTemporaryDir>
+#include <QFile>
+
+#include <cstring>
+
+void QDebugUtilsTest::testQSignalCaptureReader() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString filePath = dir.filePath(QStringLiteral("capture.qsc"));
+    QCOMPARE(QSignalCaptureReader::segmentFilePath(filePath, 0), filePath);
+    QCOMPARE(QSignalCaptureReader::segmentFilePath(filePath, 2), filePath + QStringLiteral(".2"));
+
+    // Missing capture.
+    QSignalCaptureReader::Event event;
+    {
+        QSignalCaptureReader reader(filePath);
+        QCOMPARE(reader.getFilePath(), filePath);
+        QVERIFY(! reader.readNext(event));
+        QCOMPARE(reader.getStartTime(), -1LL);
+    }
+
+    // Invalid capture.
+    {
+        QFile file(filePath);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray(256, 'x'));
+        file.close();
+        QSignalCaptureReader reader(filePath);
+        QVERIFY(! reader.readNext(event));
+    }
+
+    // Capture some signals.
+    QTestSignaler signaler;
+    signaler.setObjectName(QStringLiteral("signaler"));
+    {
+        QSignalLogger logger;
+        QVERIFY(logger.setCaptureFile(filePath));
+        logger.connectSignaler(&signaler);
+        emit signaler.signal_0A();
+        emit signaler.signal_1A(1);
+        emit signaler.signal_1A(2);
+        QCOMPARE(logger.getCapturedCount(), 3LL);
+    }
+    QVERIFY(! QFile::exists(QSignalCaptureReader::segmentFilePath(filePath, 1)));
+
+    // Read the capture twice.
+    QSignalCaptureReader reader(filePath);
+    for(int I = 0 ; I < 2 ; ++I) {
+        QVERIFY(reader.readNext(event));
+        QCOMPARE(event.getSignalSignature(), QStringLiteral("signal_0A()"));
+        QCOMPARE(event.getSignalerClassName(), QStringLiteral("QTestSignaler"));
+        QCOMPARE(event.getSignalerObjectName(), QStringLiteral("signaler"));
+        QVERIFY(event.getSerializedParameters().isEmpty());
+        QVERIFY(event.getParameters().isEmpty());
+        for(int J = 1 ; J <= 2 ; ++J) {
+            QVERIFY(reader.readNext(event));
+            QCOMPARE(event.getSignalSignature(), QStringLiteral("signal_1A(int)"));
+            QCOMPARE(event.getParameters(), QVector<QVariant>() << QVariant::fromValue<int>(J));
+        }
+        QVERIFY(! reader.readNext(event));
+        QCOMPARE(reader.getSegmentIndex(), 1);
+        reader.rewind();
+        QCOMPARE(reader.getSegmentIndex(), 0);
+    }
+
+    // Records after a corrupted record are not read.
+    {
+        QFile file(filePath);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QByteArray data = file.readAll();
+        QSignalCaptureReader::FileHeader header;
+        std::memcpy(&header, data.constData(), sizeof(header));
+        // Find the second event record and corrupt its size.
+        QSignalCaptureReader::RecordHeader record;
+        qint64 offset = header.headerSize;
+        for(int eventCount = 0 ; ; offset += record.size) {
+            std::memcpy(&record, data.constData() + offset, sizeof(record));
+            if(record.kind == QSignalCaptureReader::EventKind && ++eventCount == 2) {
+                break;
+            }
+        }
+        record.size = 3;
+        std::memcpy(data.data() + offset, &record, sizeof(record));
+        QVERIFY(file.seek(0));
+        QCOMPARE(file.write(data), static_cast<qint64>(data.size()));
+        file.close();
+    }
+    reader.rewind();
+    QVERIFY(reader.readNext(event));
+    QCOMPARE(event.getSignalSignature(), QStringLiteral("signal_0A()"));
+    QVERIFY(! reader.readNext(event));
+}
@@ -0,0 +1,160 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QDebugUtilsTest.h"
+#include "QSignalCascadeTracer.h"
+#include "QTestSignaler.h"
+
+typedef QSignalCascadeTracer::Method Method;
+typedef QSignalCascadeTracer::Node Node;
+
+static void checkDurations(const Node& node) {
+    qint64 childrenDuration = 0;
+    int emissionCount = node.getMethod().getType() == Method::Type::Signal ? 1 : 0;
+    for(const Node& child : node.getChildren()) {
+        checkDurations(child);
+        QVERIFY(child.getTimestamp() >= node.getTimestamp());
+        childrenDuration += child.getInclusiveDuration();
+        emissionCount += child.getEmissionCount();
+    }
+    QVERIFY(node.getExclusiveDuration() >= 0);
+    QCOMPARE(node.getInclusiveDuration(), node.getExclusiveDuration() + childrenDuration);
+    QCOMPARE(node.getEmissionCount(), emissionCount);
+}
+
+static bool isMethod(const Method& method, Method::Type type, const char* signature) {
+    return method.getType() == type
+            && method.getMetaMethod().methodSignature() == QByteArray(signature);
+}
+
+void QDebugUtilsTest::testQSignalCascadeTracer() {
+    QTestSignaler signaler;
+    connect(&signaler, &QTestSignaler::signal_0A, &signaler, &QTestSignaler::slot_0A);
+    connect(&signaler, &QTestSignaler::signal_1A, &signaler, &QTestSignaler::slotEmit_0A);
+
+    QSignalCascadeTracer tracer(nullptr, 1);
+    QCOMPARE(tracer.getCascadeCount(), 1);
+    tracer.enableMonitor();
+    emit signaler.signal_0A();
+    // slotEmit_0A() emits signal_0A() so slot_0A() is called inside it.
+    emit signaler.signal_1A(1);
+    emit signaler.signal_0A();
+    tracer.disableMonitor();
+
+    QCOMPARE(tracer.getTracedCount(), 3ULL);
+
+    const QVector<Node> cascades = tracer.getLargestCascades();
+    QCOMPARE(cascades.count(), 1);
+    const Node& root = cascades.at(0);
+    checkDurations(root);
+    QCOMPARE(root.getEmissionCount(), 2);
+    QCOMPARE(root.getAddress(), static_cast<const void*>(&signaler));
+    QCOMPARE(root.getMethod().getMetaObject(), signaler.metaObject());
+    QVERIFY(isMethod(root.getMethod(), Method::Type::Signal, SIG_SIGNAL_1A));
+    QCOMPARE(root.getChildren().count(), 1);
+    const Node& slotEmit = root.getChildren().at(0);
+    QVERIFY(isMethod(slotEmit.getMethod(), Method::Type::Slot, SIG_SLOT_EMIT_0A));
+    QCOMPARE(slotEmit.getChildren().count(), 1);
+    const Node& signal0A = slotEmit.getChildren().at(0);
+    QVERIFY(isMethod(signal0A.getMethod(), Method::Type::Signal, SIG_SIGNAL_0A));
+    QCOMPARE(signal0A.getChildren().count(), 1);
+    const Node& slot0A = signal0A.getChildren().at(0);
+    QVERIFY(isMethod(slot0A.getMethod(), Method::Type::Slot, SIG_SLOT_0A));
+    QVERIFY(slot0A.getChildren().isEmpty());
+
+    const QVector<QSignalCascadeTracer::MethodStatistics> methods = tracer.getMethodStatistics();
+    QCOMPARE(methods.count(), 4);
+    for(int I = 1; I < methods.count(); ++I) {
+        QVERIFY(methods.at(I - 1).getInclusiveDuration() >= methods.at(I).getInclusiveDuration());
+    }
+    for(const QSignalCascadeTracer::MethodStatistics& statistics : methods) {
+        QVERIFY(statistics.getInclusiveDuration() >= statistics.getExclusiveDuration());
+        const Method& method = statistics.getMethod();
+        if(isMethod(method, Method::Type::Signal, SIG_SIGNAL_1A)
+                || isMethod(method, Method::Type::Slot, SIG_SLOT_EMIT_0A)) {
+            QCOMPARE(statistics.getCount(), 1ULL);
+        } else {
+            QVERIFY(isMethod(method, Method::Type::Signal, SIG_SIGNAL_0A)
+                    || isMethod(method, Method::Type::Slot, SIG_SLOT_0A));
+            QCOMPARE(statistics.getCount(), 3ULL);
+        }
+    }
+
+    const QVector<QSignalCascadeTracer::CallStatistics> calls = tracer.getCallStatistics();
+    QCOMPARE(calls.count(), 3);
+    for(const QSignalCascadeTracer::CallStatistics& statistics : calls) {
+        if(isMethod(statistics.getCaller(), Method::Type::Signal, SIG_SIGNAL_1A)) {
+            QVERIFY(isMethod(statistics.getCallee(), Method::Type::Slot, SIG_SLOT_EMIT_0A));
+            QCOMPARE(statistics.getCount(), 1ULL);
+        } else if(isMethod(statistics.getCaller(), Method::Type::Slot, SIG_SLOT_EMIT_0A)) {
+            QVERIFY(isMethod(statistics.getCallee(), Method::Type::Signal, SIG_SIGNAL_0A));
+            QCOMPARE(statistics.getCount(), 1ULL);
+        } else {
+            QVERIFY(isMethod(statistics.getCaller(), Method::Type::Signal, SIG_SIGNAL_0A));
+            QVERIFY(isMethod(statistics.getCallee(), Method::Type::Slot, SIG_SLOT_0A));
+            QCOMPARE(statistics.getCount(), 3ULL);
+        }
+    }
+
+    tracer.setCascadeCount(0);
+    QVERIFY(tracer.getLargestCascades().isEmpty());
+
+    tracer.clear();
+    QCOMPARE(tracer.getTracedCount(), 0ULL);
+    QVERIFY(tracer.getMethodStatistics().isEmpty());
+    QVERIFY(tracer.getCallStatistics().isEmpty());
+}
+
+void QDebugUtilsTest::testQSignalCascadeTracer_ReEnable() {
+    QTestSignaler outer;
+    QTestSignaler inner;
+    QSignalCascadeTracer tracer;
+    connect(&outer, &QTestSignaler::signal_1A, &outer, &QTestSignaler::slotEmit_0A);
+    connect(&outer, &QTestSignaler::signal_0A, &inner, &QTestSignaler::slotEmit_0A);
+    // Disabled inside inner's signal_0A() and enabled again inside outer's,
+    // so the cascade ends with frames left open by the previous enabling.
+    const QMetaObject::Connection disabling = connect(
+                &inner, &QTestSignaler::signal_0A, [&tracer] () {
+        tracer.disableMonitor();
+    });
+    const QMetaObject::Connection enabling = connect(
+                &outer, &QTestSignaler::signal_0A, [&tracer] () {
+        tracer.enableMonitor();
+    });
+
+    tracer.enableMonitor();
+    emit outer.signal_1A(1);
+    QVERIFY(tracer.isMonitorEnabled());
+    QCOMPARE(tracer.getTracedCount(), 0ULL);
+
+    disconnect(disabling);
+    disconnect(enabling);
+    connect(&inner, &QTestSignaler::signal_0A, &inner, &QTestSignaler::slot_0A);
+    emit outer.signal_1A(1);
+    tracer.disableMonitor();
+
+    QCOMPARE(tracer.getTracedCount(), 1ULL);
+    const QVector<Node> cascades = tracer.getLargestCascades();
+    QCOMPARE(cascades.count(), 1);
+    const Node& root = cascades.at(0);
+    checkDurations(root);
+    QCOMPARE(root.getEmissionCount(), 3);
+    QCOMPARE(root.getAddress(), static_cast<const void*>(&outer));
+    QVERIFY(isMethod(root.getMethod(), Method::Type::Signal, SIG_SIGNAL_1A));
+}
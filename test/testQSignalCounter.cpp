@@ -0,0 +1,108 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QDebugUtilsTest.h"
+#include "QSignalCounter.h"
+#include "QTestSignaler.h"
+
+#include <QThread>
+
+void QDebugUtilsTest::testQSignalCounter() {
+    static const int threadEmitCount = 3;
+
+    // Emits signal_0A from its own signaler, connected to its own slot.
+    class QEmitterThread : public QThread {
+    public:
+        virtual void run() override {
+            QTestSignaler signaler;
+            connect(&signaler, &QTestSignaler::signal_0A, &signaler, &QTestSignaler::slot_0A);
+            for(int I = 0; I < threadEmitCount; ++I) {
+                emit signaler.signal_0A();
+            }
+        }
+    };
+
+    QTestSignaler signaler;
+    connect(&signaler, &QTestSignaler::signal_0A, &signaler, &QTestSignaler::slot_0A);
+    connect(&signaler, &QTestSignaler::signal_0A, &signaler, &QTestSignaler::slot_0A);
+    connect(&signaler, &QTestSignaler::signal_1A, &signaler, &QTestSignaler::slotEmit_0A);
+
+    QSignalCounter counter;
+    QVERIFY(counter.getCounts().isEmpty());
+    counter.enableMonitor();
+    for(int I = 0; I < 5; ++I) {
+        emit signaler.signal_0A();
+    }
+    // slotEmit_0A() emits signal_0A().
+    emit signaler.signal_1A(1);
+    emit signaler.signal_1A(2);
+    QEmitterThread thread;
+    thread.start();
+    thread.wait();
+    counter.disableMonitor();
+    emit signaler.signal_0A();
+
+    const QVector<QSignalCounter::Count> counts = counter.getCounts();
+    QCOMPARE(counts.count(), 2);
+
+    const QSignalCounter::Count& signal0A = counts.at(0);
+    QCOMPARE(signal0A.getMetaObject(), &QTestSignaler::staticMetaObject);
+    QCOMPARE(signal0A.getMethodIndex(), QTestSignaler::staticMetaObject.indexOfSignal(SIG_SIGNAL_0A));
+    QCOMPARE(signal0A.getMetaMethod().methodSignature(), QByteArray(SIG_SIGNAL_0A));
+    QCOMPARE(signal0A.getEmissionCount(), quint64(7 + threadEmitCount));
+    QCOMPARE(signal0A.getSlotCallCount(), quint64(7 * 2 + threadEmitCount));
+
+    const QSignalCounter::Count& signal1A = counts.at(1);
+    QCOMPARE(signal1A.getMetaObject(), &QTestSignaler::staticMetaObject);
+    QCOMPARE(signal1A.getMetaMethod().methodSignature(), QByteArray(SIG_SIGNAL_1A));
+    QVERIFY(signal1A.getSignalIndex() != signal0A.getSignalIndex());
+    QCOMPARE(signal1A.getEmissionCount(), 2ULL);
+    QCOMPARE(signal1A.getSlotCallCount(), 2ULL);
+
+    counter.clear();
+    QVERIFY(counter.getCounts().isEmpty());
+    counter.enableMonitor();
+    emit signaler.signal_1A(3);
+    counter.disableMonitor();
+    const QVector<QSignalCounter::Count> countsAfterClear = counter.getCounts();
+    QCOMPARE(countsAfterClear.count(), 2);
+    QCOMPARE(countsAfterClear.at(0).getEmissionCount(), 1ULL);
+    QCOMPARE(countsAfterClear.at(1).getEmissionCount(), 1ULL);
+
+    // Two counters used alternately by the same thread keep their own tables.
+    counter.clear();
+    QSignalCounter otherCounter;
+    counter.enableMonitor();
+    otherCounter.enableMonitor();
+    for(int I = 0; I < 3; ++I) {
+        emit signaler.signal_0A();
+        emit signaler.signal_1A(I);
+    }
+    otherCounter.clear();
+    emit signaler.signal_0A();
+    counter.disableMonitor();
+    otherCounter.disableMonitor();
+    const QVector<QSignalCounter::Count> counterCounts = counter.getCounts();
+    QCOMPARE(counterCounts.count(), 2);
+    QCOMPARE(counterCounts.at(0).getEmissionCount(), 7ULL);
+    QCOMPARE(counterCounts.at(1).getEmissionCount(), 3ULL);
+    const QVector<QSignalCounter::Count> otherCounts = otherCounter.getCounts();
+    QCOMPARE(otherCounts.count(), 1);
+    QCOMPARE(otherCounts.at(0).getEmissionCount(), 1ULL);
+}
@@ -19,6 +19,7 @@
 
 #include "QDebugUtilsTest.h"
 #include "QSignalDumper.h"
+#include "QObjectStringifier.h"
 #include "QTestSignaler.h"
 #include "QTestSignalerD.h"
 #include "QAddressWiper.h"
@@ -28,7 +29,7 @@ static QByteArray bufferQD;
 static void qDebugHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg) {
     Q_UNUSED(context);
     switch (type) {
-        case QtDebugMsg: bufferQD.append(msg.toLocal8Bit()).append('\n'); break;
+        case QtDebugMsg: bufferQD.append(msg.toUtf8()).append('\n'); break;
         default: break;
     }
 }
@@ -100,7 +101,7 @@ void QDebugUtilsTest::testQSignalDumper() {
     const auto emitAndCheckBuffers = [&] (const QString& expected) {
         emitSignal();
 
-        bufferEX.append(marker).append(expected.toLocal8Bit()).append('\n');
+        bufferEX.append(marker).append(expected.toUtf8()).append('\n');
 
         QByteArrayAddressWiper::wipe(bufferIO.buffer());
         QByteArrayAddressWiper::wipe(bufferBA);
@@ -172,3 +173,110 @@ void QDebugUtilsTest::testQSignalDumper() {
 void QDebugUtilsTest::testQSignalDumper_data() {
     test_data();
 }
+
+void QDebugUtilsTest::testQSignalDumper_Async() {
+    QFETCH(bool, useDerived);
+    QFETCH(QString, objectName);
+    QFETCH(QByteArray, methodSignature);
+    QFETCH(QVector<QVariant>, parameters);
+    QFETCH(EmitFunctor, emitFunctor);
+
+    static QTestSignaler testSignaler;
+    static QTestSignalerD testSignalerD;
+    QObject* signaler = useDerived ? &testSignalerD : &testSignaler;
+
+    // Only test signals.
+    if(signaler->metaObject()->indexOfSignal(methodSignature) == -1) {
+        return;
+    }
+
+    signaler->setObjectName(objectName);
+
+    // The synchronous dumper output is the expected output.
+    QByteArray bufferEX;
+    QSignalDumper syncDumper;
+    syncDumper.disable(QSignalDumper::Flag::TargetQDebug);
+    syncDumper.enable(QSignalDumper::Flag::Parameters);
+    syncDumper.enable(QSignalDumper::Flag::TargetQByteArray);
+    syncDumper.setTargetQByteArray(&bufferEX);
+    syncDumper.connectSignaler(signaler);
+
+    QBuffer bufferIO;
+    QByteArray bufferBA;
+    bufferIO.open(QIODevice::WriteOnly);
+    QSignalDumper asyncDumper;
+    QCOMPARE(asyncDumper.getAsyncQueueCapacity(), 1024);
+    QCOMPARE(asyncDumper.getQueueFullPolicy(), QSignalDumper::QueueFullPolicy::Block);
+    asyncDumper.setAsyncQueueCapacity(4);
+    QCOMPARE(asyncDumper.getAsyncQueueCapacity(), 4);
+    asyncDumper.disable(QSignalDumper::Flag::TargetQDebug);
+    asyncDumper.enable(QSignalDumper::Flag::Parameters);
+    asyncDumper.enable(QSignalDumper::Flag::TargetQByteArray);
+    asyncDumper.enable(QSignalDumper::Flag::TargetQIODevice);
+    asyncDumper.setTargetQByteArray(&bufferBA);
+    asyncDumper.setTargetQIODevice(&bufferIO);
+    asyncDumper.enable(QSignalDumper::Flag::Async);
+    QVERIFY(asyncDumper.isEnabled(QSignalDumper::Flag::Async));
+    asyncDumper.connectSignaler(signaler);
+
+    for(int I = 0; I < 64; ++I) {
+        emitFunctor(signaler, parameters);
+    }
+    asyncDumper.flush();
+
+    QCOMPARE(asyncDumper.getDroppedCount(), 0);
+    QCOMPARE(bufferBA, bufferEX);
+    QCOMPARE(bufferIO.buffer(), bufferEX);
+
+    // Back to synchronous mode.
+    asyncDumper.disable(QSignalDumper::Flag::Async);
+    emitFunctor(signaler, parameters);
+    QCOMPARE(bufferBA, bufferEX);
+}
+
+void QDebugUtilsTest::testQSignalDumper_AsyncDeletedObject() {
+    // A stringifier that reads the object, so a deleted object is not only
+    // stringified as its address.
+    QObjectStringifier nameStringifier(&QTestSignaler::staticMetaObject
+                                       , [] (const QObject* object, QString& buffer) {
+        buffer.append(object->objectName());
+    });
+
+    QTestSignaler signaler;
+    QTestSignaler* const object = new QTestSignaler();
+    object->setObjectName(QStringLiteral("Deleted Object"));
+
+    // The synchronous dumper output is the expected output.
+    QByteArray bufferEX;
+    QSignalDumper syncDumper;
+    syncDumper.disable(QSignalDumper::Flag::TargetQDebug);
+    syncDumper.enable(QSignalDumper::Flag::Parameters);
+    syncDumper.enable(QSignalDumper::Flag::TargetQByteArray);
+    syncDumper.setTargetQByteArray(&bufferEX);
+    syncDumper.connectSignaler(&signaler);
+    syncDumper.connectSignaler(object);
+
+    QByteArray bufferBA;
+    QSignalDumper asyncDumper;
+    asyncDumper.disable(QSignalDumper::Flag::TargetQDebug);
+    asyncDumper.enable(QSignalDumper::Flag::Parameters);
+    asyncDumper.enable(QSignalDumper::Flag::TargetQByteArray);
+    asyncDumper.setTargetQByteArray(&bufferBA);
+    asyncDumper.enable(QSignalDumper::Flag::Async);
+    asyncDumper.connectSignaler(&signaler);
+    asyncDumper.connectSignaler(object);
+
+    // Both signals have the object as a parameter and the object is deleted
+    // before the writer thread writes them.
+    emit signaler.signal_1C(object);
+    delete object;
+    asyncDumper.flush();
+
+    QVERIFY(bufferEX.contains("Deleted Object"));
+    QVERIFY(bufferEX.contains("destroyed"));
+    QCOMPARE(bufferBA, bufferEX);
+}
+
+void QDebugUtilsTest::testQSignalDumper_Async_data() {
+    test_data();
+}
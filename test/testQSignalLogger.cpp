@@ -21,6 +21,10 @@
 #include "QSignalLogger.h"
 #include "QTestSignaler.h"
 #include "QTestSignalerD.h"
+#include "QSignalCaptureReader.h"
+
+#include <QTemporaryDir>
+#include <QFile>
 
 void QDebugUtilsTest::testQSignalLogger() {
     QFETCH(bool, useDerived);
@@ -42,6 +46,19 @@ void QDebugUtilsTest::testQSignalLogger() {
     const QMetaMethod metaMethod = signaler->metaObject()->method(methodIndex);
     signaler->setObjectName(objectName);
 
+    // Entries only keep the timestamp, the id of the interned signaler, object
+    // name and signal, and the parameters.
+    struct BaselineEntry {
+        qint64 timestamp;
+        QPointer<QObject> signaler;
+        QString signalerObjectName;
+        const void* signalerAddress;
+        const QMetaObject* metaObject;
+        QMetaMethod metaMethod;
+        QVector<QVariant> parameters;
+    };
+    QVERIFY(2 * sizeof(QSignalLogger::Entry) <= sizeof(BaselineEntry));
+
     // Prepare logger.
     QSignalLogger logger;
     logger.connectSignaler(signaler);
@@ -72,13 +89,285 @@ void QDebugUtilsTest::testQSignalLogger() {
             QCOMPARE(parameterName, expectedParameterName);
             QCOMPARE(lastEntry.getParameterByName(parameterName), parameters.at(J));
         }
+
+        // Object names and meta methods are interned.
+        const QSignalLogger::Entry& firstEntry = logger.getLog().constFirst();
+        QVERIFY(&lastEntry.getSignalerObjectName() == &firstEntry.getSignalerObjectName());
+        QVERIFY(&lastEntry.getSignalMetaMethod() == &firstEntry.getSignalMetaMethod());
     }
 
-    // Test log clear.
+    // Renaming the signaler does not change the previous entries.
+    signaler->setObjectName(QStringLiteral("renamed"));
+    emitFunctor(signaler, parameters);
+    QCOMPARE(logger.getLog().constLast().getSignalerObjectName(), QStringLiteral("renamed"));
+    QCOMPARE(logger.getLog().constFirst().getSignalerObjectName(), objectName);
+    QCOMPARE(logger.getLog().constLast().getSignalMetaMethod(), metaMethod);
+
+    // Test log clear. Copied entries keep their names.
+    const QVector<QSignalLogger::Entry> log = logger.getLog();
     logger.clear();
     QVERIFY(logger.getLog().isEmpty());
+    QCOMPARE(log.constFirst().getSignalerObjectName(), objectName);
+    QCOMPARE(log.constLast().getSignalerObjectName(), QStringLiteral("renamed"));
+    QCOMPARE(log.constLast().getSignalMetaMethod(), metaMethod);
+
+    // Copied entries outlive the logger.
+    QVector<QSignalLogger::Entry> scopedLog;
+    {
+        QSignalLogger scopedLogger;
+        scopedLogger.connectSignaler(signaler);
+        emitFunctor(signaler, parameters);
+        scopedLog = scopedLogger.getLog();
+    }
+    QCOMPARE(scopedLog.count(), 1);
+    QCOMPARE(scopedLog.constFirst().getSignalerObjectName(), QStringLiteral("renamed"));
+    QCOMPARE(scopedLog.constFirst().getSignalerMetaObject(), signaler->metaObject());
+    QCOMPARE(scopedLog.constFirst().getSignalMetaMethod(), metaMethod);
 }
 
 void QDebugUtilsTest::testQSignalLogger_data() {
     test_data();
 }
+
+void QDebugUtilsTest::testQSignalLogger_RingBuffer() {
+    QFETCH(bool, useDerived);
+    QFETCH(QByteArray, methodSignature);
+    QFETCH(QVector<QVariant>, parameters);
+    QFETCH(EmitFunctor, emitFunctor);
+
+    static QTestSignaler testSignaler;
+    static QTestSignalerD testSignalerD;
+    QObject* const signaler = useDerived ? &testSignalerD : &testSignaler;
+    const int methodIndex = signaler->metaObject()->indexOfSignal(methodSignature);
+
+    // Only test signals.
+    if(methodIndex == -1) {
+        return;
+    }
+
+    // Prepare logger.
+    QSignalLogger logger;
+    QCOMPARE(logger.getRingBufferCapacity(), 0);
+    logger.setRingBufferCapacity(4096);
+    QCOMPARE(logger.getRingBufferCapacity(), 4096);
+    logger.connectSignaler(signaler);
+
+    // Emit until the oldest records are overwritten.
+    for(int I = 1 ; I <= 1024 ; ++I) {
+        emitFunctor(signaler, parameters);
+        QVERIFY(logger.getLog().isEmpty());
+        QVERIFY(logger.getRecordCount() > 0);
+        QVERIFY(logger.getRecordCount() <= I);
+    }
+    QVERIFY(logger.getRecordCount() < 1024);
+
+    // Check the records.
+    qint64 lastTimestamp = -1;
+    const QVector<QSignalLogger::Record> records = logger.getRecords();
+    QCOMPARE(records.count(), logger.getRecordCount());
+    for(const QSignalLogger::Record& record : records) {
+        QVERIFY(record.getTimestamp() >= lastTimestamp);
+        lastTimestamp = record.getTimestamp();
+        QCOMPARE(record.getSignalerAddress(), signaler);
+        QCOMPARE(record.getSignalerMetaObject(), signaler->metaObject());
+        QCOMPARE(record.getSignalMethodIndex(), methodIndex);
+        QCOMPARE(record.getSignalMetaMethod(), signaler->metaObject()->method(methodIndex));
+        const QVector<QVariant> recordParameters = record.getParameters();
+        QCOMPARE(recordParameters.count(), parameters.count());
+        for(int J = 0 ; J < parameters.count() ; ++J) {
+            // Values of types without stream operators are not recorded.
+            if(recordParameters.at(J).isValid()) {
+                QCOMPARE(recordParameters.at(J), parameters.at(J));
+            }
+        }
+    }
+
+    // Test clear.
+    logger.clear();
+    QCOMPARE(logger.getRecordCount(), 0);
+    QVERIFY(logger.getRecords().isEmpty());
+}
+
+void QDebugUtilsTest::testQSignalLogger_RingBuffer_data() {
+    test_data();
+}
+
+void QDebugUtilsTest::testQSignalLogger_CaptureFile() {
+    QFETCH(bool, useDerived);
+    QFETCH(QString, objectName);
+    QFETCH(QByteArray, methodSignature);
+    QFETCH(QVector<QVariant>, parameters);
+    QFETCH(EmitFunctor, emitFunctor);
+
+    static QTestSignaler testSignaler;
+    static QTestSignalerD testSignalerD;
+    QObject* const signaler = useDerived ? &testSignalerD : &testSignaler;
+    const int methodIndex = signaler->metaObject()->indexOfSignal(methodSignature);
+
+    // Only test signals.
+    if(methodIndex == -1) {
+        return;
+    }
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString filePath = dir.filePath(QStringLiteral("capture.qsc"));
+
+    // Prepare logger with small segments.
+    QSignalLogger logger;
+    QVERIFY(logger.getCaptureFile().isEmpty());
+    QVERIFY(logger.setCaptureFile(filePath, 4096));
+    QCOMPARE(logger.getCaptureFile(), filePath);
+    logger.connectSignaler(signaler);
+
+    // Emit, changing the object name half way.
+    const int emitCount = 256;
+    for(int I = 0 ; I < emitCount ; ++I) {
+        signaler->setObjectName(I < emitCount / 2 ? objectName : QStringLiteral("renamed"));
+        emitFunctor(signaler, parameters);
+        QVERIFY(logger.getLog().isEmpty());
+        QCOMPARE(logger.getRecordCount(), 0);
+    }
+    QCOMPARE(logger.getCapturedCount(), static_cast<qint64>(emitCount));
+    QCOMPARE(logger.getCaptureDroppedCount(), 0LL);
+
+    // A signal whose object name does not fit in a segment is dropped.
+    signaler->setObjectName(QString(8192, QLatin1Char('x')));
+    emitFunctor(signaler, parameters);
+    QCOMPARE(logger.getCapturedCount(), static_cast<qint64>(emitCount));
+    QCOMPARE(logger.getCaptureDroppedCount(), 1LL);
+    logger.closeCaptureFile();
+    QVERIFY(logger.getCaptureFile().isEmpty());
+    QVERIFY(QFile::exists(QSignalCaptureReader::segmentFilePath(filePath, 1)));
+
+    // Read the capture.
+    QSignalCaptureReader reader(filePath);
+    QSignalCaptureReader::Event event;
+    qint64 lastTimestamp = -1;
+    for(int I = 0 ; I < emitCount ; ++I) {
+        QVERIFY(reader.readNext(event));
+        QVERIFY(event.getTimestamp() >= lastTimestamp);
+        lastTimestamp = event.getTimestamp();
+        QCOMPARE(event.getSignalerAddress()
+                 , static_cast<quint64>(reinterpret_cast<quintptr>(signaler)));
+        QCOMPARE(event.getSignalerClassName()
+                 , QString::fromLatin1(signaler->metaObject()->className()));
+        QCOMPARE(event.getSignalerObjectName()
+                 , I < emitCount / 2 ? objectName : QStringLiteral("renamed"));
+        QCOMPARE(event.getSignalSignature(), QString::fromLatin1(methodSignature));
+        QCOMPARE(event.getSignalMethodIndex(), methodIndex);
+        const QVector<QVariant> eventParameters = event.getParameters();
+        QCOMPARE(eventParameters.count(), parameters.count());
+        for(int J = 0 ; J < parameters.count() ; ++J) {
+            // Values of types without stream operators are not recorded.
+            if(eventParameters.at(J).isValid()) {
+                QCOMPARE(eventParameters.at(J), parameters.at(J));
+            }
+        }
+    }
+    QVERIFY(reader.getSegmentIndex() > 0);
+    QVERIFY(! reader.readNext(event));
+    QVERIFY(reader.getStartTime() > 0);
+}
+
+void QDebugUtilsTest::testQSignalLogger_CaptureFile_data() {
+    test_data();
+}
+
+void QDebugUtilsTest::testQSignalLogger_Query() {
+    QFETCH(bool, useIndexes);
+
+    QTestSignaler signalerA;
+    QTestSignaler signalerB;
+    QTestSignalerD signalerD;
+    const QMetaMethod signal0A = QMetaMethod::fromSignal(&QTestSignaler::signal_0A);
+    const QMetaMethod signal1A = QMetaMethod::fromSignal(&QTestSignaler::signal_1A);
+
+    // Prepare logger. The Signal index is only enabled after some entries
+    // were logged.
+    QSignalLogger logger;
+    QVERIFY(! logger.isIndexEnabled(QSignalLogger::Index::Signaler));
+    if(useIndexes) {
+        logger.enableIndex(QSignalLogger::Index::Signaler);
+        logger.enableIndex(QSignalLogger::Index::MetaObject);
+        QVERIFY(logger.isIndexEnabled(QSignalLogger::Index::Signaler));
+        QVERIFY(logger.isIndexEnabled(QSignalLogger::Index::MetaObject));
+        QVERIFY(! logger.isIndexEnabled(QSignalLogger::Index::Signal));
+    }
+    logger.connectSignaler(&signalerA);
+    logger.connectSignaler(&signalerB);
+    logger.connectSignaler(&signalerD);
+
+    emit signalerA.signal_0A();
+    emit signalerA.signal_1A(1);
+    emit signalerB.signal_1A(2);
+    if(useIndexes) {
+        logger.enableIndex(QSignalLogger::Index::Signal);
+        QVERIFY(logger.isIndexEnabled(QSignalLogger::Index::Signal));
+    }
+    while(logger.getElapsedTime() <= logger.getLog().constLast().getTimestamp()) {
+    }
+    const qint64 middle = logger.getElapsedTime();
+    emit signalerD.signal_1A(3);
+    emit signalerD.signal_0A();
+    QCOMPARE(logger.getLog().size(), 5);
+
+    // By signaler.
+    const QSignalLogger::View viewA = logger.getEntriesBySignaler(&signalerA);
+    QCOMPARE(viewA.size(), 2);
+    QVERIFY(&viewA.at(0) == &logger.getLog().at(0));
+    QVERIFY(&viewA.at(1) == &logger.getLog().at(1));
+    int count = 0;
+    for(const QSignalLogger::Entry& entry : viewA) {
+        QCOMPARE(entry.getSignalerAddress(), &signalerA);
+        ++count;
+    }
+    QCOMPARE(count, 2);
+    QCOMPARE(logger.getEntriesBySignaler(&signalerB).size(), 1);
+    QCOMPARE(logger.getEntriesBySignaler(&signalerB).begin()->getParameters().at(0)
+             , QVariant::fromValue<int>(2));
+    QVERIFY(logger.getEntriesBySignaler(&logger).isEmpty());
+
+    // By meta object.
+    QCOMPARE(logger.getEntriesByMetaObject(&QTestSignaler::staticMetaObject).size(), 3);
+    QCOMPARE(logger.getEntriesByMetaObject(&QTestSignalerD::staticMetaObject).size(), 2);
+    QVERIFY(logger.getEntriesByMetaObject(&QObject::staticMetaObject).isEmpty());
+
+    // By signal, including derived classes.
+    const QSignalLogger::View view1A = logger.getEntriesBySignal(signal1A);
+    QCOMPARE(view1A.size(), 3);
+    QCOMPARE(view1A.at(0).getSignalerAddress(), &signalerA);
+    QCOMPARE(view1A.at(1).getSignalerAddress(), &signalerB);
+    QCOMPARE(view1A.at(2).getSignalerAddress(), &signalerD);
+    QCOMPARE(logger.getSignalCount(signal0A), 2);
+    QCOMPARE(logger.getSignalCount(signal1A), 3);
+    QCOMPARE(logger.getSignalCount(QMetaMethod::fromSignal(&QTestSignaler::signal_2A)), 0);
+
+    // By time window.
+    QCOMPARE(logger.getEntriesInTimeWindow(0, middle).size(), 3);
+    const QSignalLogger::View viewLater
+            = logger.getEntriesInTimeWindow(middle, logger.getElapsedTime() + 1);
+    QCOMPARE(viewLater.size(), 2);
+    QVERIFY(&viewLater.at(0) == &logger.getLog().at(3));
+    QVERIFY(logger.getEntriesInTimeWindow(middle, middle - 1).isEmpty());
+    QVERIFY(QSignalLogger::View().isEmpty());
+
+    // Disabling an index does not change the results.
+    logger.disableIndex(QSignalLogger::Index::Signal);
+    QVERIFY(! logger.isIndexEnabled(QSignalLogger::Index::Signal));
+    QCOMPARE(logger.getSignalCount(signal1A), 3);
+
+    // Test clear.
+    logger.clear();
+    QVERIFY(logger.getEntriesBySignaler(&signalerA).isEmpty());
+    QVERIFY(logger.getEntriesByMetaObject(&QTestSignaler::staticMetaObject).isEmpty());
+    QCOMPARE(logger.getSignalCount(signal0A), 0);
+    QVERIFY(logger.getEntriesInTimeWindow(0, logger.getElapsedTime() + 1).isEmpty());
+}
+
+void QDebugUtilsTest::testQSignalLogger_Query_data() {
+    QTest::addColumn<bool>("useIndexes");
+
+    QTest::newRow("scan") << false;
+    QTest::newRow("indexes") << true;
+}
@@ -0,0 +1,95 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+#include "QDebugUtilsTest.h"
+#include "QSignalQueueMonitor.h"
+#include "QTestSignaler.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+void QDebugUtilsTest::testQSignalQueueMonitor() {
+#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
+    const int emitCount = 5;
+
+    // Emits signal_0A from another thread, so it is queued to the receiver.
+    class QEmitterThread : public QThread {
+    public:
+        explicit QEmitterThread(QTestSignaler* signaler)
+            : _signaler(signaler) {
+        }
+        virtual void run() override {
+            emit _signaler->signal_0A();
+        }
+    private:
+        QTestSignaler* const _signaler;
+    };
+
+    QTestSignaler signaler;
+    QTestSignaler receiver;
+    connect(&signaler, &QTestSignaler::signal_0A, &receiver, &QTestSignaler::slot_0A);
+    QEmitterThread thread(&signaler);
+
+    // The history keeps the emissions of both threads.
+    QSignalQueueMonitor monitor(nullptr, 16);
+    QCOMPARE(monitor.getHistorySize(), 16);
+    monitor.enableMonitor();
+
+    // The first queued call of a connection can not be matched.
+    thread.start();
+    thread.wait();
+    QCoreApplication::processEvents();
+    QCOMPARE(monitor.getUnmatchedCount(), 1ULL);
+    QVERIFY(monitor.getQueueStatistics().isEmpty());
+
+    // The emissions of the receiver's thread call the slot directly and are
+    // not counted.
+    for(int I = 0; I < emitCount; ++I) {
+        thread.start();
+        thread.wait();
+        emit signaler.signal_0A();
+    }
+    QVector<QSignalQueueMonitor::QueueStatistics> statistics = monitor.getQueueStatistics();
+    QCOMPARE(statistics.count(), 1);
+    QCOMPARE(statistics.at(0).getBacklog(), emitCount);
+    QCOMPARE(statistics.at(0).getMaxBacklog(), emitCount);
+    QCOMPARE(statistics.at(0).getHistogram().getCount(), 0ULL);
+
+    QCoreApplication::processEvents();
+    statistics = monitor.getQueueStatistics();
+    QCOMPARE(statistics.count(), 1);
+    const QSignalQueueMonitor::QueueStatistics& queueStatistics = statistics.at(0);
+    QCOMPARE(queueStatistics.getSignalerMetaObject(), signaler.metaObject());
+    QCOMPARE(queueStatistics.getSignalMetaMethod().methodSignature(), QByteArray(SIG_SIGNAL_0A));
+    QCOMPARE(queueStatistics.getReceiverThread(), static_cast<const QThread*>(QThread::currentThread()));
+    QCOMPARE(queueStatistics.getBacklog(), 0);
+    QCOMPARE(queueStatistics.getMaxBacklog(), emitCount);
+    QCOMPARE(queueStatistics.getHistogram().getCount(), quint64(emitCount));
+    QCOMPARE(monitor.getUnmatchedCount(), 1ULL);
+    monitor.disableMonitor();
+
+    monitor.clear();
+    statistics = monitor.getQueueStatistics();
+    QCOMPARE(statistics.count(), 1);
+    QCOMPARE(statistics.at(0).getHistogram().getCount(), 0ULL);
+    QCOMPARE(statistics.at(0).getMaxBacklog(), 0);
+    QCOMPARE(monitor.getUnmatchedCount(), 0ULL);
+#else
+    QSKIP("QSignalQueueMonitor only works with Qt 5.4 to 5.13.");
+#endif
+}
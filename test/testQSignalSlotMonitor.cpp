@@ -23,6 +23,9 @@
 #include "QTestSignalerD.h"
 #include "QTestSignalSlotMonitor.h"
 
+#include <QThread>
+#include <QSemaphore>
+
 void QDebugUtilsTest::testQSignalSlotMonitor() {
     QFETCH(bool, useDerived);
     QFETCH(QString, objectName);
@@ -74,6 +77,7 @@ void QDebugUtilsTest::testQSignalSlotMonitor() {
             QCOMPARE(rI.slotMetaMethod, _slotMetaMethod);
             QCOMPARE(rI.parameters.count(), _parameters.count());
             QCOMPARE(rI.parameters, _parameters);
+            QCOMPARE(rI.viewParameters, _parameters);
         }
     };
 
@@ -181,6 +185,308 @@ void QDebugUtilsTest::testQSignalSlotMonitor_Lambda() {
     QCOMPARE(monitor.callRecords.count(), 2);
 }
 
+void QDebugUtilsTest::testQSignalSlotMonitor_Threads() {
+    static const int threadCount = 4;
+    static const int emitCount = 10000;
+    static const int toggleCount = 1000;
+
+    // Counts the callbacks from all threads.
+    class QCountingMonitor : public QSignalSlotMonitor {
+    public:
+        QAtomicInt signalBegins;
+        QAtomicInt signalEnds;
+    private:
+        virtual void signalBegin(const SignalInfo&) override { signalBegins.ref(); }
+        virtual void signalEnd(const SignalInfo&) override { signalEnds.ref(); }
+    };
+
+    // Emits signal_0A from its own signaler.
+    class QEmitterThread : public QThread {
+    public:
+        virtual void run() override {
+            QTestSignaler signaler;
+            for(int I = 0; I < emitCount; ++I) {
+                emit signaler.signal_0A();
+            }
+        }
+    };
+
+    // Enables and disables a monitor while the emitters run.
+    class QTogglerThread : public QThread {
+    public:
+        QTogglerThread(QCountingMonitor& monitor) : _monitor(monitor) {}
+        virtual void run() override {
+            for(int I = 0; I < toggleCount; ++I) {
+                _monitor.enableMonitor();
+                _monitor.disableMonitor();
+            }
+        }
+    private:
+        QCountingMonitor& _monitor;
+    };
+
+    QCountingMonitor monitor;
+    QCountingMonitor toggledMonitor;
+    QEmitterThread emitters[threadCount];
+    QTogglerThread toggler(toggledMonitor);
+
+    monitor.enableMonitor();
+    toggler.start();
+    for(QEmitterThread& emitter : emitters) {
+        emitter.start();
+    }
+    for(QEmitterThread& emitter : emitters) {
+        QVERIFY(emitter.wait());
+    }
+    QVERIFY(toggler.wait());
+    monitor.disableMonitor();
+
+    QVERIFY(! monitor.isMonitorEnabled());
+    QVERIFY(! toggledMonitor.isMonitorEnabled());
+    QCOMPARE(monitor.signalBegins.load(), threadCount * emitCount);
+    QCOMPARE(monitor.signalEnds.load(), threadCount * emitCount);
+    QVERIFY(toggledMonitor.signalBegins.load() <= threadCount * emitCount);
+}
+
+void QDebugUtilsTest::testQSignalSlotMonitor_ThreadStacks() {
+    static const int threadCount = 4;
+    static const int emitCount = 2000;
+
+    // Checks, in each thread, that the callbacks get the innermost signal
+    // emited by that thread and that the signals end in reverse order.
+    class QStackCheckingMonitor : public QSignalSlotMonitor {
+    public:
+        QAtomicInt errors;
+        QAtomicInt maxDepth;
+        QAtomicInt unbalanced;
+        void checkBalanced() {
+            if(! stack().isEmpty()) {
+                unbalanced.ref();
+            }
+        }
+    private:
+        struct Frame {
+            QObject* signaler;
+            int methodIndex;
+            const void* const* parametersPointers;
+        };
+        static QVector<Frame>& stack() {
+            thread_local QVector<Frame> frames;
+            return frames;
+        }
+        void check(const SignalInfo& signalInfo) {
+            const QVector<Frame>& frames = stack();
+            if(frames.isEmpty()
+                    || frames.last().signaler != signalInfo.getSignaler()
+                    || frames.last().methodIndex != signalInfo.getMethodIndex()
+                    || frames.last().parametersPointers != signalInfo.getParametersPointers()) {
+                errors.ref();
+            }
+        }
+        virtual void signalBegin(const SignalInfo& signalInfo) override {
+            QVector<Frame>& frames = stack();
+            frames.append(Frame{signalInfo.getSignaler(), signalInfo.getMethodIndex()
+                                , signalInfo.getParametersPointers()});
+            int depth = maxDepth.load();
+            while(frames.count() > depth && ! maxDepth.testAndSetOrdered(depth, frames.count())) {
+                depth = maxDepth.load();
+            }
+        }
+        virtual void signalEnd(const SignalInfo& signalInfo) override {
+            check(signalInfo);
+            if(! stack().isEmpty()) {
+                stack().removeLast();
+            }
+        }
+        virtual void slotBegin(const SignalInfo& signalInfo, const SlotInfo&) override {
+            check(signalInfo);
+        }
+        virtual void slotEnd(const SignalInfo& signalInfo, const SlotInfo&) override {
+            check(signalInfo);
+        }
+    };
+
+    // Emits signal_1A, whose slot emits the nested signal_0A, and checks the
+    // thread's stack is empty at the end.
+    class QNestedEmitterThread : public QThread {
+    public:
+        QNestedEmitterThread(QStackCheckingMonitor& monitor) : _monitor(monitor) {}
+        virtual void run() override {
+            QTestSignaler signaler;
+            connect(&signaler, &QTestSignaler::signal_1A, &signaler, &QTestSignaler::slotEmit_0A);
+            connect(&signaler, &QTestSignaler::signal_0A, &signaler, &QTestSignaler::slot_0A);
+            for(int I = 0; I < emitCount; ++I) {
+                emit signaler.signal_1A(I);
+            }
+            _monitor.checkBalanced();
+        }
+    private:
+        QStackCheckingMonitor& _monitor;
+    };
+
+    QStackCheckingMonitor monitor;
+    QVector<QNestedEmitterThread*> emitters;
+    for(int I = 0; I < threadCount; ++I) {
+        emitters.append(new QNestedEmitterThread(monitor));
+    }
+
+    monitor.enableMonitor();
+    for(QNestedEmitterThread* emitter : emitters) {
+        emitter->start();
+    }
+    for(QNestedEmitterThread* emitter : emitters) {
+        QVERIFY(emitter->wait());
+    }
+    monitor.disableMonitor();
+    qDeleteAll(emitters);
+
+    QCOMPARE(monitor.errors.load(), 0);
+    QCOMPARE(monitor.unbalanced.load(), 0);
+    QCOMPARE(monitor.maxDepth.load(), 2);
+}
+
+void QDebugUtilsTest::testQSignalSlotMonitor_MetaObjectReuse() {
+    // Translates the indexes through SignalInfo, that is protected.
+    class QIndexesMonitor : public QSignalSlotMonitor {
+    public:
+        static int methodIndexOf(QObject* signaler, int signalIndex) {
+            static const void* const noParameters[] = {nullptr};
+            return SignalInfo(signaler, signalIndex, SignalInfo::INDEX_UNKNOWN
+                              , noParameters).getMethodIndex();
+        }
+        static int signalIndexOf(QObject* signaler, int methodIndex) {
+            static const void* const noParameters[] = {nullptr};
+            return SignalInfo(signaler, SignalInfo::INDEX_UNKNOWN, methodIndex
+                              , noParameters).getSignalIndex();
+        }
+    };
+
+    // A signaler with a meta object that can be replaced at the same address,
+    // like a dynamic meta object that is freed and its memory reused.
+    class QReusedMetaObjectSignaler : public QTestSignalerD {
+    public:
+        QMetaObject reusedMetaObject;
+        virtual const QMetaObject* metaObject() const override {
+            return &reusedMetaObject;
+        }
+    };
+
+    // Looks up the method index of a signal index in its own thread, once
+    // before and once after the main thread replaces the meta object.
+    class QLookupThread : public QThread {
+    public:
+        QLookupThread(QObject* signaler, int signalIndex)
+            : _signaler(signaler), _signalIndex(signalIndex) {}
+        // Lets the thread finish if a comparison failed before the release.
+        ~QLookupThread() { replaced.release(); wait(); }
+        QSemaphore looked;
+        QSemaphore replaced;
+        int methodIndexBefore = -1;
+        int methodIndexAfter = -1;
+        virtual void run() override {
+            methodIndexBefore = QIndexesMonitor::methodIndexOf(_signaler, _signalIndex);
+            looked.release();
+            replaced.acquire();
+            methodIndexAfter = QIndexesMonitor::methodIndexOf(_signaler, _signalIndex);
+        }
+    private:
+        QObject* _signaler;
+        int _signalIndex;
+    };
+
+    // signal_0B is the first signal of QTestSignalerD.
+    const QMetaObject& metaObjectD = QTestSignalerD::staticMetaObject;
+    const int signal0BMethodIndex = metaObjectD.indexOfSignal(SIG_SIGNAL_0B);
+    int signal0BIndex = 0;
+    for(int I = 0; I < signal0BMethodIndex; ++I) {
+        if(metaObjectD.method(I).methodType() == QMetaMethod::Signal) {
+            ++signal0BIndex;
+        }
+    }
+
+    QReusedMetaObjectSignaler signaler;
+    signaler.reusedMetaObject = metaObjectD;
+    QCOMPARE(QIndexesMonitor::methodIndexOf(&signaler, signal0BIndex), signal0BMethodIndex);
+    QCOMPARE(QIndexesMonitor::signalIndexOf(&signaler, signal0BMethodIndex), signal0BIndex);
+    QLookupThread thread(&signaler, signal0BIndex);
+    thread.start();
+    thread.looked.acquire();
+
+    // Without QTestSignaler in the hierarchy, the same signal index is a
+    // later signal of QTestSignalerD.
+    signaler.reusedMetaObject.d.superdata = &QObject::staticMetaObject;
+    const int reusedMethodIndex = signaler.metaObject()->indexOfSignal(SIG_SIGNAL_9B);
+    QVERIFY(reusedMethodIndex != signal0BMethodIndex);
+    QCOMPARE(QIndexesMonitor::methodIndexOf(&signaler, signal0BIndex), reusedMethodIndex);
+    QCOMPARE(QIndexesMonitor::signalIndexOf(&signaler, reusedMethodIndex), signal0BIndex);
+
+    // The other thread cached the previous tables.
+    thread.replaced.release();
+    QVERIFY(thread.wait());
+    QCOMPARE(thread.methodIndexBefore, signal0BMethodIndex);
+    QCOMPARE(thread.methodIndexAfter, reusedMethodIndex);
+
+    // And back to the first meta object.
+    signaler.reusedMetaObject = metaObjectD;
+    QCOMPARE(QIndexesMonitor::methodIndexOf(&signaler, signal0BIndex), signal0BMethodIndex);
+}
+
+void QDebugUtilsTest::testQSignalSlotMonitor_Sampling() {
+    typedef QSignalSlotMonitor::Sampling Sampling;
+    const int emitCount = 100;
+
+    class QCountingMonitor : public QSignalSlotMonitor {
+    public:
+        int signalBegins = 0;
+        int signalEnds = 0;
+        int slotBegins = 0;
+        int slotEnds = 0;
+    private:
+        virtual void signalBegin(const SignalInfo&) override { ++signalBegins; }
+        virtual void signalEnd(const SignalInfo&) override { ++signalEnds; }
+        virtual void slotBegin(const SignalInfo&, const SlotInfo&) override { ++slotBegins; }
+        virtual void slotEnd(const SignalInfo&, const SlotInfo&) override { ++slotEnds; }
+    };
+
+    QTestSignaler signaler;
+    connect(&signaler, &QTestSignaler::signal_0A, &signaler, &QTestSignaler::slot_0A);
+    connect(&signaler, &QTestSignaler::signal_1A, &signaler, &QTestSignaler::slot_0A);
+
+    // Emits both signals emitCount times and checks how many were sampled.
+    auto checkSampled = [&] (Sampling sampling, int rate, int burst, int expected) {
+        // A second monitor that forwards every signal is not affected.
+        QCountingMonitor monitor;
+        QCountingMonitor allMonitor;
+        monitor.setSampling(sampling, rate, burst);
+        QVERIFY(monitor.getSampling() == sampling);
+        QCOMPARE(monitor.getSamplingRate(), rate);
+        QCOMPARE(monitor.getSamplingBurst(), burst);
+        QVERIFY(allMonitor.getSampling() == Sampling::All);
+        monitor.enableMonitor();
+        allMonitor.enableMonitor();
+        for(int I = 0; I < emitCount; ++I) {
+            emit signaler.signal_0A();
+            emit signaler.signal_1A(I);
+        }
+        monitor.disableMonitor();
+        allMonitor.disableMonitor();
+        QCOMPARE(monitor.signalBegins, expected);
+        QCOMPARE(monitor.signalEnds, expected);
+        QCOMPARE(monitor.slotBegins, expected);
+        QCOMPARE(monitor.slotEnds, expected);
+        QCOMPARE(allMonitor.signalBegins, 2 * emitCount);
+        QCOMPARE(allMonitor.signalEnds, 2 * emitCount);
+        QCOMPARE(allMonitor.slotBegins, 2 * emitCount);
+        QCOMPARE(allMonitor.slotEnds, 2 * emitCount);
+    };
+
+    checkSampled(Sampling::All, 1, 1, 2 * emitCount);
+    checkSampled(Sampling::OneInN, 10, 1, 2 * emitCount / 10);
+    // The rates are low enough for the loop to end before any token refill.
+    checkSampled(Sampling::PerSignalRate, 1, 3, 2 * 3);
+    checkSampled(Sampling::TokenBucket, 1, 5, 5);
+}
+
 void QDebugUtilsTest::testQSignalSlotMonitor_SignalNoMonitorBenchmark() {
     QTestSignaler signaler;
 
@@ -0,0 +1,108 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QDebugUtilsTest.h"
+#include "QSignalTraceExporter.h"
+#include "QTestSignaler.h"
+
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+
+void QDebugUtilsTest::testQSignalTraceExporter() {
+    QTestSignaler signaler;
+    signaler.setObjectName(QStringLiteral("quote\"name"));
+    connect(&signaler, &QTestSignaler::signal_1A, &signaler, &QTestSignaler::slotEmit_0A);
+    connect(&signaler, &QTestSignaler::signal_0A, &signaler, &QTestSignaler::slot_0A);
+
+    QByteArray trace;
+    QBuffer buffer(&trace);
+    buffer.open(QIODevice::WriteOnly);
+
+    QSignalTraceExporter exporter(nullptr, &buffer);
+    QCOMPARE(exporter.getTargetQIODevice(), static_cast<QIODevice*>(&buffer));
+    exporter.enableMonitor();
+    // slotEmit_0A() emits signal_0A() so slot_0A() is called inside it.
+    emit signaler.signal_1A(1);
+    exporter.disableMonitor();
+
+    // The events are buffered until the chunk is full.
+    QVERIFY(trace.isEmpty());
+    exporter.flush();
+    QVERIFY(! trace.isEmpty());
+    exporter.close();
+    QCOMPARE(exporter.getTargetQIODevice(), static_cast<QIODevice*>(nullptr));
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(trace, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QVERIFY(document.isArray());
+    const QJsonArray events = document.array();
+    QCOMPARE(events.count(), 9);
+
+    const QJsonObject metadata = events.at(0).toObject();
+    QCOMPARE(metadata.value(QStringLiteral("ph")).toString(), QStringLiteral("M"));
+    QCOMPARE(metadata.value(QStringLiteral("name")).toString(), QStringLiteral("thread_name"));
+    const int tid = metadata.value(QStringLiteral("tid")).toInt();
+
+    const QStringList expected = QStringList()
+            << QStringLiteral("B signal QTestSignaler::" SIG_SIGNAL_1A)
+            << QStringLiteral("B slot QTestSignaler::" SIG_SLOT_EMIT_0A)
+            << QStringLiteral("B signal QTestSignaler::" SIG_SIGNAL_0A)
+            << QStringLiteral("B slot QTestSignaler::" SIG_SLOT_0A)
+            << QStringLiteral("E") << QStringLiteral("E")
+            << QStringLiteral("E") << QStringLiteral("E");
+    double lastTimestamp = 0;
+    for(int I = 1; I < events.count(); ++I) {
+        const QJsonObject event = events.at(I).toObject();
+        QCOMPARE(event.value(QStringLiteral("tid")).toInt(), tid);
+        QCOMPARE(event.value(QStringLiteral("pid")).toVariant().toLongLong(), QCoreApplication::applicationPid());
+        QVERIFY(event.value(QStringLiteral("ts")).toDouble() >= lastTimestamp);
+        lastTimestamp = event.value(QStringLiteral("ts")).toDouble();
+        QString actual = event.value(QStringLiteral("ph")).toString();
+        if(actual == QLatin1String("B")) {
+            actual += QLatin1Char(' ') + event.value(QStringLiteral("cat")).toString()
+                    + QLatin1Char(' ') + event.value(QStringLiteral("name")).toString();
+            const QJsonObject args = event.value(QStringLiteral("args")).toObject();
+            QCOMPARE(args.value(QStringLiteral("objectName")).toString(), signaler.objectName());
+            QVERIFY(args.value(QStringLiteral("object")).toString().startsWith(QLatin1String("0x")));
+        }
+        QCOMPARE(actual, expected.at(I - 1));
+    }
+
+    // With a chunk size of zero each event is written immediately and a new
+    // target starts a new trace.
+    QByteArray trace2;
+    QBuffer buffer2(&trace2);
+    buffer2.open(QIODevice::WriteOnly);
+    exporter.setChunkSize(0);
+    QCOMPARE(exporter.getChunkSize(), 0);
+    exporter.setTargetQIODevice(&buffer2);
+    exporter.enableMonitor();
+    emit signaler.signal_0A();
+    QVERIFY(trace2.startsWith("[\n{\"ph\":\"M\""));
+    exporter.disableMonitor();
+    exporter.close();
+    QVERIFY(trace2.endsWith("\n]\n"));
+    const QJsonDocument document2 = QJsonDocument::fromJson(trace2, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(document2.array().count(), 5);
+}
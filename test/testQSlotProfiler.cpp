@@ -0,0 +1,178 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QDebugUtilsTest.h"
+#include "QSlotProfiler.h"
+#include "QTestSignaler.h"
+
+#include <limits>
+
+void QDebugUtilsTest::testQSlotProfiler_Histogram() {
+    typedef QSlotProfiler::Histogram Histogram;
+
+    for(qint64 duration : {0LL, 1LL, 3LL, 4LL, 7LL, 8LL, 10LL, 1000LL, 123456789LL
+                           , std::numeric_limits<qint64>::max()}) {
+        const int index = Histogram::getBucketIndex(duration);
+        QVERIFY(index >= 0 && index < Histogram::BUCKET_COUNT);
+        QVERIFY(Histogram::getBucketLowerBound(index) <= duration);
+        QVERIFY(index == Histogram::BUCKET_COUNT - 1
+                || duration < Histogram::getBucketLowerBound(index + 1));
+    }
+    QCOMPARE(Histogram::getBucketIndex(std::numeric_limits<qint64>::max())
+             , Histogram::BUCKET_COUNT - 1);
+    QCOMPARE(Histogram::getBucketLowerBound(Histogram::getBucketIndex(63)), 63LL);
+    QCOMPARE(Histogram::getBucketLowerBound(Histogram::getBucketIndex(1000)), 992LL);
+    QCOMPARE(Histogram::getBucketLowerBound(Histogram::getBucketIndex(1007)), 992LL);
+    QCOMPARE(Histogram::getBucketLowerBound(Histogram::getBucketIndex(1008)), 1008LL);
+
+    Histogram histogram;
+    QCOMPARE(histogram.getCount(), 0ULL);
+    QCOMPARE(histogram.getPercentile(50), 0LL);
+    for(qint64 duration = 1; duration <= 100; ++duration) {
+        histogram.record(duration);
+    }
+    QCOMPARE(histogram.getCount(), 100ULL);
+    QCOMPARE(histogram.getTotal(), 5050LL);
+    QCOMPARE(histogram.getMin(), 1LL);
+    QCOMPARE(histogram.getMax(), 100LL);
+    QCOMPARE(histogram.getMean(), 50LL);
+    QCOMPARE(histogram.getPercentile(0), 1LL);
+    QCOMPARE(histogram.getPercentile(50), 50LL);
+    QCOMPARE(histogram.getPercentile(99), 99LL);
+    QCOMPARE(histogram.getPercentile(100), 100LL);
+}
+
+void QDebugUtilsTest::testQSlotProfiler() {
+    const int emitCount = 10;
+
+    QTestSignaler signaler;
+    connect(&signaler, &QTestSignaler::signal_0A, &signaler, &QTestSignaler::slot_0A);
+    connect(&signaler, &QTestSignaler::signal_1A, &signaler, &QTestSignaler::slotEmit_0A);
+
+    QSlotProfiler profiler(nullptr, 3);
+    QCOMPARE(profiler.getSlowestCount(), 3);
+    profiler.enableMonitor();
+    for(int I = 0; I < emitCount; ++I) {
+        emit signaler.signal_0A();
+    }
+    // slotEmit_0A() emits signal_0A() so slot_0A() is called inside it.
+    emit signaler.signal_1A(1);
+    profiler.disableMonitor();
+
+    const QMetaObject* const metaObject = signaler.metaObject();
+    const int slot0AIndex = metaObject->indexOfSlot(SIG_SLOT_0A);
+    const int slotEmit0AIndex = metaObject->indexOfSlot(SIG_SLOT_EMIT_0A);
+
+    const QVector<QSlotProfiler::SlotStatistics> statistics = profiler.getSlotStatistics();
+    QCOMPARE(statistics.count(), 2);
+    for(int I = 1; I < statistics.count(); ++I) {
+        QVERIFY(statistics.at(I - 1).getHistogram().getTotal()
+                >= statistics.at(I).getHistogram().getTotal());
+    }
+    qint64 slot0AMax = -1;
+    qint64 slotEmit0ATotal = -1;
+    for(const QSlotProfiler::SlotStatistics& slotStatistics : statistics) {
+        QCOMPARE(slotStatistics.getReceiverMetaObject(), metaObject);
+        if(slotStatistics.getSlotMethodIndex() == slot0AIndex) {
+            QCOMPARE(slotStatistics.getHistogram().getCount(), quint64(emitCount + 1));
+            slot0AMax = slotStatistics.getHistogram().getMax();
+        } else {
+            QCOMPARE(slotStatistics.getSlotMethodIndex(), slotEmit0AIndex);
+            QCOMPARE(slotStatistics.getSlotMetaMethod().methodSignature()
+                     , QByteArray(SIG_SLOT_EMIT_0A));
+            QCOMPARE(slotStatistics.getHistogram().getCount(), 1ULL);
+            slotEmit0ATotal = slotStatistics.getHistogram().getTotal();
+        }
+    }
+    QVERIFY(slot0AMax >= 0);
+    QVERIFY(slotEmit0ATotal >= 0);
+
+    const QVector<QSlotProfiler::Invocation> slowest = profiler.getSlowestInvocations();
+    QCOMPARE(slowest.count(), 3);
+    for(int I = 1; I < slowest.count(); ++I) {
+        QVERIFY(slowest.at(I - 1).getDuration() >= slowest.at(I).getDuration());
+    }
+    for(const QSlotProfiler::Invocation& invocation : slowest) {
+        QCOMPARE(invocation.getReceiverAddress(), static_cast<const void*>(&signaler));
+        QCOMPARE(invocation.getSignalerAddress(), static_cast<const void*>(&signaler));
+        QVERIFY(invocation.getTimestamp() >= 0);
+        if(invocation.getSlotMethodIndex() == slotEmit0AIndex) {
+            QCOMPARE(invocation.getSignalMetaMethod().methodSignature()
+                     , QByteArray(SIG_SIGNAL_1A));
+        } else {
+            QCOMPARE(invocation.getSlotMethodIndex(), slot0AIndex);
+            QCOMPARE(invocation.getSignalMetaMethod().methodSignature()
+                     , QByteArray(SIG_SIGNAL_0A));
+        }
+    }
+
+    profiler.setSlowestCount(1);
+    QCOMPARE(profiler.getSlowestInvocations().count(), 1);
+
+    profiler.clear();
+    QVERIFY(profiler.getSlotStatistics().isEmpty());
+    QVERIFY(profiler.getSlowestInvocations().isEmpty());
+}
+
+void QDebugUtilsTest::testQSlotProfiler_ReEnable() {
+    QTestSignaler outer;
+    QTestSignaler inner;
+    QSlotProfiler profiler;
+    connect(&outer, &QTestSignaler::signal_1A, &outer, &QTestSignaler::slotEmit_0A);
+    connect(&outer, &QTestSignaler::signal_0A, &inner, &QTestSignaler::slotEmit_0A);
+    // Disabled inside inner's slotEmit_0A() and enabled again inside outer's,
+    // so both slots end with frames left open by the previous enabling.
+    const QMetaObject::Connection disabling = connect(
+                &inner, &QTestSignaler::signal_0A, [&profiler] () {
+        profiler.disableMonitor();
+    });
+    const QMetaObject::Connection enabling = connect(
+                &outer, &QTestSignaler::signal_0A, [&profiler] () {
+        profiler.enableMonitor();
+    });
+
+    profiler.enableMonitor();
+    emit outer.signal_1A(1);
+    QVERIFY(profiler.isMonitorEnabled());
+    QVERIFY(profiler.getSlotStatistics().isEmpty());
+    QVERIFY(profiler.getSlowestInvocations().isEmpty());
+
+    disconnect(disabling);
+    disconnect(enabling);
+    connect(&inner, &QTestSignaler::signal_0A, &inner, &QTestSignaler::slot_0A);
+    emit outer.signal_1A(1);
+    profiler.disableMonitor();
+
+    const QMetaObject* const metaObject = outer.metaObject();
+    const QVector<QSlotProfiler::SlotStatistics> statistics = profiler.getSlotStatistics();
+    QCOMPARE(statistics.count(), 2);
+    for(const QSlotProfiler::SlotStatistics& slotStatistics : statistics) {
+        if(slotStatistics.getSlotMethodIndex() == metaObject->indexOfSlot(SIG_SLOT_0A)) {
+            QCOMPARE(slotStatistics.getHistogram().getCount(), 1ULL);
+        } else {
+            QCOMPARE(slotStatistics.getSlotMethodIndex(), metaObject->indexOfSlot(SIG_SLOT_EMIT_0A));
+            QCOMPARE(slotStatistics.getHistogram().getCount(), 2ULL);
+        }
+    }
+    for(const QSlotProfiler::Invocation& invocation : profiler.getSlowestInvocations()) {
+        if(invocation.getSlotMethodIndex() == metaObject->indexOfSlot(SIG_SLOT_0A)) {
+            QCOMPARE(invocation.getReceiverAddress(), static_cast<const void*>(&inner));
+        }
+    }
+}
@@ -49,6 +49,75 @@ void QDebugUtilsTest::testQUniversalSlot_EverythingBenchmark() {
     }
 }
 
+void QDebugUtilsTest::testQUniversalSlot_Filters() {
+    typedef QUniversalSlot::FilterRule FilterRule;
+
+    QTestSignaler testSignaler;
+    QTestSignalerD testSignalerD;
+    testSignaler.setObjectName(QStringLiteral("A"));
+    testSignalerD.setObjectName(QStringLiteral("D"));
+
+    QStringList received;
+    auto unislotFunc = [&] (QObject* signaler, const QMetaMethod& metaMethod
+            , const QVector<QVariant>&) {
+        if(signaler == &testSignaler || signaler == &testSignalerD) {
+            received.append(signaler->objectName() + QLatin1Char(':')
+                            + QLatin1String(metaMethod.name()));
+        }
+    };
+    QTestUniversalSlot unislot(unislotFunc);
+
+    auto emitSignals = [&] () {
+        received.clear();
+        emit testSignaler.signal_0A();
+        emit testSignaler.signal_1A(1);
+        emit testSignalerD.signal_0A();
+        emit testSignalerD.signal_0B();
+        return received;
+    };
+
+    const QStringList all = QStringList()
+            << QStringLiteral("A:signal_0A") << QStringLiteral("A:signal_1A")
+            << QStringLiteral("D:signal_0A") << QStringLiteral("D:signal_0B");
+
+    unislot.connectEverything();
+    QCOMPARE(emitSignals(), all);
+
+    unislot.includeSignals(FilterRule::ClassName, QStringLiteral("QTestSignalerD"));
+    QCOMPARE(emitSignals(), QStringList()
+             << QStringLiteral("D:signal_0A") << QStringLiteral("D:signal_0B"));
+
+    unislot.clearFilters();
+    QCOMPARE(emitSignals(), all);
+
+    unislot.includeSignals(FilterRule::Inherits, QStringLiteral("QTestSignaler"));
+    QCOMPARE(emitSignals(), all);
+
+    unislot.excludeSignals(FilterRule::SignalName, QStringLiteral("signal_1A(int)"));
+    QCOMPARE(emitSignals(), QStringList()
+             << QStringLiteral("A:signal_0A")
+             << QStringLiteral("D:signal_0A") << QStringLiteral("D:signal_0B"));
+
+    unislot.clearFilters();
+    unislot.excludeSignals(FilterRule::ObjectName, QStringLiteral("D"));
+    QCOMPARE(emitSignals(), QStringList()
+             << QStringLiteral("A:signal_0A") << QStringLiteral("A:signal_1A"));
+
+    unislot.clearFilters();
+    unislot.includeSignals(FilterRule::SignalName, QStringLiteral("signal_0A"));
+    unislot.includeSignals(FilterRule::ObjectName, QStringLiteral("D"));
+    QCOMPARE(emitSignals(), QStringList()
+             << QStringLiteral("A:signal_0A")
+             << QStringLiteral("D:signal_0A") << QStringLiteral("D:signal_0B"));
+
+    // Filters also apply to explicitly connected signals.
+    unislot.disconnectEverything();
+    unislot.connectSignaler(&testSignaler);
+    unislot.clearFilters();
+    unislot.excludeSignals(FilterRule::SignalName, QStringLiteral("signal_0A"));
+    QCOMPARE(emitSignals(), QStringList() << QStringLiteral("A:signal_1A"));
+}
+
 void QDebugUtilsTest::testQUniversalSlot() {
     QFETCH(bool, useDerived);
     QFETCH(QString, objectName);
@@ -0,0 +1,208 @@
+/*******************************************************************************
+** Copyright © 2017 Pedro Miguel Carvalho <PedroMC@pmc.com.pt>
+**
+** This file is part of QtDebugUtils.
+**
+** QtDebugUtils is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** any later version.
+**
+** QtDebugUtils is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with QtDebugUtils.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include "QDebugUtilsTest.h"
+#include "QValueSerializer.h"
+
+#include <QBitArray>
+#include <QUrl>
+#include <QUuid>
+#include <QDate>
+#include <QTime>
+#include <QDateTime>
+#include <QPoint>
+#include <QSize>
+#include <QRect>
+#include <QLine>
+
+#include <limits>
+
+struct SerializerTestTypeA {
+    qint32 value;
+    qint32 other;
+};
+
+Q_DECLARE_METATYPE(SerializerTestTypeA)
+
+IMPLEMENT_TRIVIAL_VALUE_SERIALIZER(SerializerTestTypeA);
+
+struct SerializerTestTypeB {
+    int value;
+};
+
+Q_DECLARE_METATYPE(SerializerTestTypeB)
+
+void QDebugUtilsTest::testQValueSerializer() {
+    QFETCH(QVariant, value);
+
+    const QByteArray prefix("prefix");
+    QByteArray buffer = prefix;
+    QValueSerializer::serialize(value, buffer);
+    QVERIFY(buffer.startsWith(prefix));
+    QVERIFY(buffer.size() > prefix.size());
+
+    const char* data = buffer.constData() + prefix.size();
+    const char* const end = buffer.constData() + buffer.size();
+    QVariant result;
+    QVERIFY(QValueSerializer::deserialize(data, end, result));
+    QVERIFY(data == end);
+    QCOMPARE(result.userType(), value.userType());
+    QCOMPARE(result, value);
+
+    // Truncated records are rejected.
+    data = buffer.constData() + prefix.size();
+    QVERIFY(! QValueSerializer::deserialize(data, end - 1, result));
+}
+
+void QDebugUtilsTest::testQValueSerializer_data() {
+    QTest::addColumn<QVariant>("value");
+
+    QVariantMap map;
+    map.insert(QStringLiteral("a"), 1);
+    map.insert(QStringLiteral("b"), QStringLiteral("B"));
+    QBitArray bits(10);
+    bits.setBit(3);
+
+    QTest::newRow("short") << QVariant::fromValue<short>(-12345);
+    QTest::newRow("int") << QVariant::fromValue<int>(-5);
+    QTest::newRow("int min") << QVariant::fromValue<int>(std::numeric_limits<int>::min());
+    QTest::newRow("long") << QVariant::fromValue<long>(-1234567);
+    QTest::newRow("qlonglong min") << QVariant::fromValue<qlonglong>(std::numeric_limits<qlonglong>::min());
+    QTest::newRow("ushort") << QVariant::fromValue<ushort>(65535);
+    QTest::newRow("uint") << QVariant::fromValue<uint>(300);
+    QTest::newRow("ulong") << QVariant::fromValue<ulong>(1234567);
+    QTest::newRow("qulonglong max") << QVariant::fromValue<qulonglong>(std::numeric_limits<qulonglong>::max());
+    QTest::newRow("bool") << QVariant::fromValue<bool>(true);
+    QTest::newRow("char") << QVariant::fromValue<char>('x');
+    QTest::newRow("uchar") << QVariant::fromValue<uchar>(200);
+    QTest::newRow("QChar") << QVariant::fromValue<QChar>(QChar(0x263A));
+    QTest::newRow("float") << QVariant::fromValue<float>(1.5f);
+    QTest::newRow("double") << QVariant::fromValue<double>(-2.25e100);
+    QTest::newRow("QString") << QVariant::fromValue<QString>(QStringLiteral("abc ç☺"));
+    QTest::newRow("empty QString") << QVariant::fromValue<QString>(QString());
+    QTest::newRow("long QString") << QVariant::fromValue<QString>(QString(1000, QLatin1Char('z')));
+    QTest::newRow("QByteArray") << QVariant::fromValue<QByteArray>(QByteArray("a\0b", 3));
+    QTest::newRow("QStringList") << QVariant::fromValue<QStringList>(
+                                        QStringList() << QStringLiteral("a") << QString()
+                                        << QStringLiteral("xyz"));
+    QTest::newRow("QVariantList") << QVariant::fromValue<QVariantList>(
+                                         QVariantList() << 1 << QStringLiteral("s")
+                                         << QVariant(QVariantList() << 2.5) << QVariant());
+    QTest::newRow("QVariantMap") << QVariant::fromValue<QVariantMap>(map);
+    QTest::newRow("QPoint") << QVariant::fromValue<QPoint>(QPoint(-1, 2));
+    QTest::newRow("QPointF") << QVariant::fromValue<QPointF>(QPointF(-1.5, 2.5));
+    QTest::newRow("QSize") << QVariant::fromValue<QSize>(QSize(3, -4));
+    QTest::newRow("QSizeF") << QVariant::fromValue<QSizeF>(QSizeF(3.5, 4.5));
+    QTest::newRow("QRect") << QVariant::fromValue<QRect>(QRect(1, -2, 30, 40));
+    QTest::newRow("QRectF") << QVariant::fromValue<QRectF>(QRectF(1.5, 2.5, 3.5, 4.5));
+    QTest::newRow("QLine") << QVariant::fromValue<QLine>(QLine(1, 2, -3, 4));
+    QTest::newRow("QLineF") << QVariant::fromValue<QLineF>(QLineF(1.5, 2.5, 3.5, 4.5));
+    QTest::newRow("QDate") << QVariant::fromValue<QDate>(QDate(2017, 10, 30));
+    QTest::newRow("QTime") << QVariant::fromValue<QTime>(QTime(12, 34, 56, 789));
+    QTest::newRow("invalid QTime") << QVariant::fromValue<QTime>(QTime());
+    QTest::newRow("QDateTime UTC") << QVariant::fromValue<QDateTime>(
+                                          QDateTime(QDate(2017, 10, 30), QTime(1, 2, 3), Qt::UTC));
+    QTest::newRow("QDateTime offset") << QVariant::fromValue<QDateTime>(
+                                             QDateTime(QDate(2017, 10, 30), QTime(1, 2, 3)
+                                                       , Qt::OffsetFromUTC, 3600));
+    QTest::newRow("invalid QDateTime") << QVariant::fromValue<QDateTime>(QDateTime());
+    QTest::newRow("QUrl") << QVariant::fromValue<QUrl>(QUrl(QStringLiteral("https://example.com/a?b=c")));
+    QTest::newRow("QUuid") << QVariant::fromValue<QUuid>(
+                                  QUuid(QStringLiteral("{67c8770b-44f1-410a-ab9a-f9b5446f13ee}")));
+    QTest::newRow("QObject*") << QVariant::fromValue<QObject*>(this);
+    QTest::newRow("void*") << QVariant::fromValue<void*>(this);
+    QTest::newRow("QBitArray (QDataStream)") << QVariant::fromValue<QBitArray>(bits);
+    QTest::newRow("invalid") << QVariant();
+}
+
+void QDebugUtilsTest::testQValueSerializer_Records() {
+    // Varints.
+    QByteArray varints;
+    const qint64 signedValues[] = {0, -1, 1, -64, 64, std::numeric_limits<qint64>::min()
+                                   , std::numeric_limits<qint64>::max()};
+    for(const qint64 value : signedValues) {
+        QValueSerializer::writeSignedVarint(value, varints);
+    }
+    QValueSerializer::writeVarint(127, varints);
+    QValueSerializer::writeVarint(128, varints);
+    QCOMPARE(varints.right(3), QByteArray("\x7f\x80\x01", 3));
+    const char* data = varints.constData();
+    const char* end = data + varints.size();
+    for(const qint64 value : signedValues) {
+        qint64 result = 0;
+        QVERIFY(QValueSerializer::readSignedVarint(data, end, result));
+        QCOMPARE(result, value);
+    }
+    quint64 result = 0;
+    QVERIFY(QValueSerializer::readVarint(data, end, result));
+    QCOMPARE(result, 127ULL);
+    QVERIFY(! QValueSerializer::readVarint(data, end - 1, result));
+    QVERIFY(QValueSerializer::readVarint(data, end, result));
+    QCOMPARE(result, 128ULL);
+    QVERIFY(data == end);
+
+    // Small integers take two bytes of framing and one of payload.
+    QByteArray buffer;
+    QValueSerializer::serialize(QVariant::fromValue<int>(-3), buffer);
+    QCOMPARE(buffer.size(), 3);
+
+    // A sequence of records, with a custom type, a type without serializer nor
+    // stream operators and a QVariant holding a QVariant.
+    const SerializerTestTypeA valueA = {-7, 123456};
+    const SerializerTestTypeB valueB = {5};
+    const QVariant nested = QVariant::fromValue<QVariant>(QVariant::fromValue<int>(42));
+    buffer.clear();
+    QValueSerializer::serialize(QVariant::fromValue(valueA), buffer);
+    QValueSerializer::serialize(QVariant::fromValue(valueB), buffer);
+    QValueSerializer::serialize(nested, buffer);
+    QValueSerializer::serialize(QVariant::fromValue<int>(9), buffer);
+
+    data = buffer.constData();
+    end = data + buffer.size();
+    QVariant value;
+    QVERIFY(QValueSerializer::deserialize(data, end, value));
+    QCOMPARE(value.userType(), qMetaTypeId<SerializerTestTypeA>());
+    QCOMPARE(value.value<SerializerTestTypeA>().value, valueA.value);
+    QCOMPARE(value.value<SerializerTestTypeA>().other, valueA.other);
+    QVERIFY(QValueSerializer::deserialize(data, end, value));
+    QVERIFY(! value.isValid());
+    QVERIFY(QValueSerializer::deserialize(data, end, value));
+    QCOMPARE(value, QVariant::fromValue<int>(42));
+    QVERIFY(QValueSerializer::deserialize(data, end, value));
+    QCOMPARE(value, QVariant::fromValue<int>(9));
+    QVERIFY(data == end);
+    QVERIFY(! QValueSerializer::deserialize(data, end, value));
+
+    // A disabled serializer is not used.
+    QValueSerializer serializerA(static_cast<QMetaType::Type>(qMetaTypeId<SerializerTestTypeA>())
+                                 , &SerializerTestTypeASerializerFunc
+                                 , &SerializerTestTypeADeserializerFunc, false);
+    QCOMPARE(serializerA.getTypeId(), static_cast<QMetaType::Type>(qMetaTypeId<SerializerTestTypeA>()));
+    SerializerTestTypeASerializerFuncsRegister.disable();
+    buffer.clear();
+    QValueSerializer::serialize(QVariant::fromValue(valueA), buffer);
+    QCOMPARE(buffer.size(), 2);
+    serializerA.enable();
+    buffer.clear();
+    QValueSerializer::serialize(QVariant::fromValue(valueA), buffer);
+    // User type ids need a two byte tag.
+    QCOMPARE(buffer.size(), 3 + static_cast<int>(sizeof(SerializerTestTypeA)));
+    serializerA.disable();
+    SerializerTestTypeASerializerFuncsRegister.enable();
+}
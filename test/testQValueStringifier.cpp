@@ -32,6 +32,8 @@
 #include <QRect>
 #include <QLine>
 
+#include <limits>
+
 #if QT_POINTER_SIZE == 4
 #define POINTER_MARK "0xffffffff"
 #elif QT_POINTER_SIZE == 8
@@ -74,6 +76,24 @@ struct TestTypeC {
 
 Q_DECLARE_METATYPE(TestTypeC)
 
+struct TestTypeD {
+    int value;
+};
+
+Q_DECLARE_METATYPE(TestTypeD)
+
+IMPLEMENT_TYPED_VALUE_STRINGIFIER(TestTypeD) {
+    buffer.append(QLatin1Literal("{value="));
+    QValueStringifier::stringify(qMetaTypeId<int>(), &value.value, buffer);
+    buffer.append(QLatin1Literal("}"));
+}
+
+static void stringifyTestTypeC(const TestTypeC& value, QString& buffer) {
+    buffer.append(QLatin1Literal("{value="));
+    QValueStringifier::stringify(qMetaTypeId<float>(), &value.value, buffer);
+    buffer.append(QLatin1Literal("}"));
+}
+
 void QDebugUtilsTest::testQValueStringifier() {
     QFETCH(QVariant, testValue);
     QFETCH(QString, expectedWithoutType);
@@ -90,6 +110,15 @@ void QDebugUtilsTest::testQValueStringifier() {
 
     QCOMPARE(QStringAddressWiper::copywipe(bufferWithType)
              , expectedWithType);
+
+    QByteArray utf8WithoutType;
+    QByteArray utf8WithType;
+
+    QValueStringifier::stringify(testValue, utf8WithoutType);
+    QValueStringifier::stringify(testValue, utf8WithType, true);
+
+    QCOMPARE(QString::fromUtf8(utf8WithoutType), bufferWithoutType);
+    QCOMPARE(QString::fromUtf8(utf8WithType), bufferWithType);
 }
 
 void QDebugUtilsTest::testQValueStringifier_data() {
@@ -152,6 +181,16 @@ void QDebugUtilsTest::testQValueStringifier_data() {
             << QStringLiteral("123456789")
             << QStringLiteral("qulonglong(123456789)");
 
+    QTest::newRow("longlong(min)")
+            << QVariant::fromValue(std::numeric_limits<qlonglong>::min())
+            << QStringLiteral("-9223372036854775808")
+            << QStringLiteral("qlonglong(-9223372036854775808)");
+
+    QTest::newRow("ulonglong(max)")
+            << QVariant::fromValue(std::numeric_limits<qulonglong>::max())
+            << QStringLiteral("18446744073709551615")
+            << QStringLiteral("qulonglong(18446744073709551615)");
+
     QTest::newRow("float")
             << QVariant::fromValue(float(-1.23))
             << QStringLiteral("-1.23")
@@ -162,6 +201,21 @@ void QDebugUtilsTest::testQValueStringifier_data() {
             << QStringLiteral("1.23456")
             << QStringLiteral("double(1.23456)");
 
+    QTest::newRow("float(16777216)")
+            << QVariant::fromValue(float(16777216))
+            << QStringLiteral("16777216")
+            << QStringLiteral("float(16777216)");
+
+    QTest::newRow("double(0.1+0.2)")
+            << QVariant::fromValue(double(0.1) + double(0.2))
+            << QStringLiteral("0.30000000000000004")
+            << QStringLiteral("double(0.30000000000000004)");
+
+    QTest::newRow("double(1e-05)")
+            << QVariant::fromValue(double(1e-05))
+            << QStringLiteral("1e-05")
+            << QStringLiteral("double(1e-05)");
+
     QTest::newRow("(void*)nullptr")
             << QVariant::fromValue(static_cast<void*>(nullptr))
             << QStringLiteral("nullptr")
@@ -207,6 +261,11 @@ void QDebugUtilsTest::testQValueStringifier_data() {
             << QStringLiteral("\"A \\a \\f \\\" \\' \\\\ \\n \\b \\t \\x01 \\v \\r çÇABC\"")
             << QStringLiteral("QString(\"A \\a \\f \\\" \\' \\\\ \\n \\b \\t \\x01 \\v \\r çÇABC\")");
 
+    QTest::newRow("QString:surrogates")
+            << QVariant::fromValue(QString::fromUtf8("\xf0\x9f\x98\x80\n"))
+            << QString::fromUtf8("\"\xf0\x9f\x98\x80\\n\"")
+            << QString::fromUtf8("QString(\"\xf0\x9f\x98\x80\\n\")");
+
     QTest::newRow("QString:2")
             << QVariant::fromValue(
                    QStringLiteral(
@@ -328,4 +387,120 @@ void QDebugUtilsTest::testQValueStringifier_data() {
             << QVariant::fromValue(TestTypeC{1.1})
             << QStringLiteral("{?}")
             << QStringLiteral("TestTypeC({?})");
+
+    QTest::newRow("TestTypeD")
+            << QVariant::fromValue(TestTypeD{-2})
+            << QStringLiteral("{value=-2}")
+            << QStringLiteral("TestTypeD({value=-2})");
+}
+
+void QDebugUtilsTest::testQValueStringifier_RegisterType() {
+    const TestTypeC value{1.5};
+    const QVariant var = QVariant::fromValue(value);
+    QString buffer;
+
+    QValueStringifier::registerType<TestTypeC>(&stringifyTestTypeC);
+    QValueStringifier::stringify(var, buffer, true);
+    QCOMPARE(buffer, QStringLiteral("TestTypeC({value=1.5})"));
+
+    buffer.clear();
+    QValueStringifier::stringify(qMetaTypeId<TestTypeC>(), &value, buffer);
+    QCOMPARE(buffer, QStringLiteral("{value=1.5}"));
+
+    // Stringifiers with a StringifierFunc also work with values in place.
+    const TestTypeA valueA{3};
+    buffer.clear();
+    QValueStringifier::stringify(qMetaTypeId<TestTypeA>(), &valueA, buffer, true);
+    QCOMPARE(buffer, QStringLiteral("TestTypeA({value=3})"));
+
+    QValueStringifier::unregisterType<TestTypeC>(&stringifyTestTypeC);
+    buffer.clear();
+    QValueStringifier::stringify(var, buffer);
+    QCOMPARE(buffer, QStringLiteral("{?}"));
+}
+
+static void stringifyAsFirst(const QVariant& var, QString& buffer) {
+    Q_UNUSED(var);
+    buffer.append(QLatin1String("first"));
+}
+
+static void stringifyAsSecond(const QVariant& var, QString& buffer) {
+    Q_UNUSED(var);
+    buffer.append(QLatin1String("second"));
+}
+
+static void stringifyAsNever(const QVariant& var, QString& buffer) {
+    Q_UNUSED(var);
+    buffer.append(QLatin1String("never"));
+}
+
+static void destructChunkType(void* value) {
+    Q_UNUSED(value);
+}
+
+static void* constructChunkType(void* where, const void* copy) {
+    *static_cast<int*>(where) = copy ? *static_cast<const int*>(copy) : 0;
+    return where;
+}
+
+void QDebugUtilsTest::testQValueStringifier_EnableDisable() {
+    // Registers types until one is past the first chunk of user types in the
+    // stringifiers table, so its chunk is created by enable().
+    QVector<int> typeIds;
+    int typeId = QMetaType::UnknownType;
+    for(int I = 0; typeId < QMetaType::User + 256; ++I) {
+        const QByteArray typeName = "QValueStringifierChunkType" + QByteArray::number(I);
+        typeId = QMetaType::registerType(typeName.constData(), &destructChunkType
+                                         , &constructChunkType, sizeof(int)
+                                         , QMetaType::TypeFlags(), nullptr);
+        QVERIFY(typeId >= QMetaType::User);
+        if(typeIds.isEmpty()) {
+            typeIds.append(typeId);
+        }
+    }
+    typeIds.append(typeId);
+
+    for(const int id : typeIds) {
+        const QMetaType::Type type = static_cast<QMetaType::Type>(id);
+        const int value = 0;
+        auto stringified = [&] () {
+            QString buffer;
+            QValueStringifier::stringify(id, &value, buffer);
+            QByteArray utf8;
+            QValueStringifier::stringify(id, &value, utf8);
+            return QString::fromUtf8(utf8) == buffer
+                    ? buffer : QStringLiteral("UTF-8 mismatch");
+        };
+
+        const QString initial = stringified();
+        QValueStringifier first(type, &stringifyAsFirst, false);
+        QValueStringifier second(type, &stringifyAsSecond, false);
+        QValueStringifier never(type, &stringifyAsNever, false);
+
+        // Disabling a stringifier that was never enabled changes nothing.
+        never.disable();
+        QCOMPARE(stringified(), initial);
+
+        // The most recently enabled stringifier is used.
+        first.enable();
+        QCOMPARE(stringified(), QStringLiteral("first"));
+        second.enable();
+        QCOMPARE(stringified(), QStringLiteral("second"));
+        never.disable();
+        QCOMPARE(stringified(), QStringLiteral("second"));
+        second.disable();
+        QCOMPARE(stringified(), QStringLiteral("first"));
+
+        // Re-enabled.
+        second.enable();
+        QCOMPARE(stringified(), QStringLiteral("second"));
+        first.disable();
+        QCOMPARE(stringified(), QStringLiteral("second"));
+        second.disable();
+        QCOMPARE(stringified(), initial);
+        first.enable();
+        QCOMPARE(stringified(), QStringLiteral("first"));
+        first.disable();
+        QCOMPARE(stringified(), initial);
+    }
 }